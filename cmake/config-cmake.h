@@ -51,6 +51,21 @@
 /* Define to 1 if you have the 'memalign' function. */
 #cmakedefine HAVE_MEMALIGN 1
 
+/* Define to 1 if you have the 'mmap' function. */
+#cmakedefine HAVE_MMAP 1
+
+/* Define to 1 if you have the 'madvise' function. */
+#cmakedefine HAVE_MADVISE 1
+
+/* Define to 1 if you have the 'sendmmsg' function. */
+#cmakedefine HAVE_SENDMMSG 1
+
+/* Define to 1 if you have the 'recvmmsg' function. */
+#cmakedefine HAVE_RECVMMSG 1
+
+/* Define to 1 if you have the 'posix_openpt' function. */
+#cmakedefine HAVE_POSIX_OPENPT 1
+
 /* Define to 1 if you have the 'gettimeofday' function. */
 #cmakedefine HAVE_GETTIMEOFDAY 1
 
@@ -7,6 +7,7 @@
 #include "dma.h"
 #include "snd.h"
 #include "host.h"
+#include "avi_record.h"
 
 #include <SDL.h>
 
@@ -21,86 +22,167 @@ static bool          bSoundOutAlertShown = false;
 static bool          bSoundInAlertShown  = false;
 static bool          bPlayingBuffer      = false; /* Is playing buffer? */
 static bool          bRecordingBuffer    = false; /* Is recording buffer? */
-#define              REC_BUFFER_SZ       16  /* Recording buffer size in power of two */
-static const  Uint32 REC_BUFFER_MASK     = (1<<REC_BUFFER_SZ) - 1;
-static Uint8         recBuffer[1<<REC_BUFFER_SZ];
-static Uint32        recBufferWr         = 0;
-static Uint32        recBufferRd         = 0;
-static lock_t        recBufferLock;
 
+/* Sound input ring buffer: mu-law samples written by SDL callback, read by DMA */
+#define              IN_RING_SZ          16  /* Input ring size in power of two */
+static const  Uint32 IN_RING_MASK        = (1<<IN_RING_SZ) - 1;
+static Uint8         inRing[1<<IN_RING_SZ];
+static SDL_atomic_t  inRingWr;
+static SDL_atomic_t  inRingRd;
+static Uint8         ulawTable[1<<16];       /* 16-bit linear to mu-law */
+
+/* Sound output ring buffer: written by emulation thread, read by SDL callback */
+#define              OUT_RING_SZ         16  /* Output ring size in power of two */
+static const  Uint32 OUT_RING_MASK       = (1<<OUT_RING_SZ) - 1;
+static Uint8         outRing[1<<OUT_RING_SZ];
+static SDL_atomic_t  outRingWr;
+static SDL_atomic_t  outRingRd;
+static Uint32        outUnderruns        = 0;
+static Uint32        outOverruns         = 0;
+static Uint32        outMinDepth         = 0;
+
+static void Audio_Output_InitBuf(void) {
+    SDL_AtomicSet(&outRingWr, 0);
+    SDL_AtomicSet(&outRingRd, 0);
+    outMinDepth = 1<<OUT_RING_SZ;
+}
+
+/* Copy samples to output ring. Samples that do not fit are dropped. */
 void Audio_Output_Queue(Uint8* data, int len) {
-    int chunkSize = AUDIO_BUFFER_SAMPLES;
+    Uint32 wr, rd, room, pos, chunk;
+    
+    if (bRecordingAvi) {
+        Avi_CaptureAudio(data, len);
+    }
     if (bSoundOutputWorking) {
-        while (len > 0) {
-            if (len < chunkSize) chunkSize = len;
-            SDL_QueueAudio(Audio_Output_Device, data, chunkSize);
-            data += chunkSize;
-            len  -= chunkSize;
+        wr   = SDL_AtomicGet(&outRingWr);
+        rd   = SDL_AtomicGet(&outRingRd);
+        room = (1<<OUT_RING_SZ) - (wr - rd);
+        if ((Uint32)len > room) {
+            outOverruns++;
+            len = room & ~3;
         }
+        pos   = wr & OUT_RING_MASK;
+        chunk = (1<<OUT_RING_SZ) - pos;
+        if (chunk > (Uint32)len) chunk = len;
+        memcpy(&outRing[pos], data, chunk);
+        memcpy(outRing, data + chunk, len - chunk);
+        SDL_AtomicSet(&outRingWr, wr + len);
     }
 }
 
 Uint32 Audio_Output_Queue_Size() {
     if (bSoundOutputWorking) {
-        return SDL_GetQueuedAudioSize(Audio_Output_Device) / 4;
+        return ((Uint32)SDL_AtomicGet(&outRingWr) - (Uint32)SDL_AtomicGet(&outRingRd)) / 4;
     } else {
         return 0;
     }
 }
 
+/* Report output ring depth and underruns since last call */
+const char* Audio_Output_Report(double realTime, double hostTime) {
+    static char report[128];
+    
+    if (bSoundOutputWorking) {
+        sprintf(report, "depth:%.1fms min:%.1fms underruns:%d overruns:%d",
+                Audio_Output_Queue_Size() * 1000.0 / AUDIO_OUT_FREQUENCY,
+                (outMinDepth / 4) * 1000.0 / AUDIO_OUT_FREQUENCY,
+                outUnderruns, outOverruns);
+    } else {
+        report[0] = 0;
+    }
+    outUnderruns = 0;
+    outOverruns  = 0;
+    outMinDepth  = 1<<OUT_RING_SZ;
+    return report;
+}
+
 /*-----------------------------------------------------------------------*/
 /**
  * SDL audio callback functions - move sound between emulation and audio system.
  * Note: These functions will run in a separate thread.
  */
 
-static void Audio_Input_CallBack(void *userdata, Uint8 *stream, int len) {
-    Log_Printf(LOG_WARN, "Audio_Input_CallBack %d", len);
-    if(len == 0) return;
-    Audio_Input_Lock();
-    while(len--)
-        recBuffer[recBufferWr++&REC_BUFFER_MASK] = *stream++;
-	recBufferWr &= REC_BUFFER_MASK;
-	recBufferWr &= ~1; /* Just to be sure */
-    Audio_Input_Unlock();
+static void Audio_Output_CallBack(void *userdata, Uint8 *stream, int len) {
+    Uint32 wr, rd, avail, pos, chunk;
+    
+    wr    = SDL_AtomicGet(&outRingWr);
+    rd    = SDL_AtomicGet(&outRingRd);
+    avail = wr - rd;
+    if (avail < outMinDepth) outMinDepth = avail;
+    if ((Uint32)len > avail) {
+        outUnderruns++;
+        memset(stream + avail, 0, len - avail); /* silence */
+        len = avail;
+    }
+    pos   = rd & OUT_RING_MASK;
+    chunk = (1<<OUT_RING_SZ) - pos;
+    if (chunk > (Uint32)len) chunk = len;
+    memcpy(stream, &outRing[pos], chunk);
+    memcpy(stream + chunk, outRing, len - chunk);
+    SDL_AtomicSet(&outRingRd, rd + len);
+}
+
+/* Convert 16-bit big endian samples to mu-law */
+static void Audio_Input_Encode(Uint8* dst, const Uint8* src, Uint32 len) {
+    while (len--) {
+        *dst++ = ulawTable[(src[0]<<8)|src[1]];
+        src += 2;
+    }
 }
 
-void Audio_Input_Lock() {
-    host_lock(&recBufferLock);
+/* Encode samples into input ring. Samples that do not fit are dropped. */
+static void Audio_Input_CallBack(void *userdata, Uint8 *stream, int len) {
+    Uint32 wr, rd, room, pos, chunk;
+    
+    len  /= 2; /* 16-bit samples */
+    wr    = SDL_AtomicGet(&inRingWr);
+    rd    = SDL_AtomicGet(&inRingRd);
+    room  = (1<<IN_RING_SZ) - (wr - rd);
+    if ((Uint32)len > room) len = room;
+    pos   = wr & IN_RING_MASK;
+    chunk = (1<<IN_RING_SZ) - pos;
+    if (chunk > (Uint32)len) chunk = len;
+    Audio_Input_Encode(&inRing[pos], stream, chunk);
+    Audio_Input_Encode(inRing, stream + 2 * chunk, len - chunk);
+    SDL_AtomicSet(&inRingWr, wr + len);
 }
 
 /* 
  * Initialize recording buffer with silence to compensate for time gap
  * between Audio_Input_Enable and first call of Audio_Input_CallBack.
  */
-#define AUDIO_RECBUF_INIT	0 /* 16000 byte = 1 second */
+#define AUDIO_RECBUF_INIT	0 /* 8000 samples = 1 second */
 
-void Audio_Input_InitBuf() {
-	recBufferRd = 0;
-	for (recBufferWr = 0; recBufferWr < AUDIO_RECBUF_INIT; recBufferWr++) {
-		recBuffer[recBufferWr] = 0;
-	}
-}
-
-int Audio_Input_Read() {
-	Sint16 sample = 0;
-	
-    if (bSoundInputWorking) {
-		if ((recBufferRd&REC_BUFFER_MASK)==(recBufferWr&REC_BUFFER_MASK)) {
-			return -1;
-		} else {
-			sample = ((recBuffer[recBufferRd&REC_BUFFER_MASK]<<8)|recBuffer[(recBufferRd&REC_BUFFER_MASK)+1]);
-			recBufferRd += 2;
-			recBufferRd &= REC_BUFFER_MASK;
-			return snd_make_ulaw(sample);
-		}
-	} else {
-        return snd_make_ulaw(0); // silence
-	}
+static void Audio_Input_InitBuf(void) {
+    int i;
+    
+    for (i = 0; i < AUDIO_RECBUF_INIT; i++) {
+        inRing[i] = ulawTable[0];
+    }
+    SDL_AtomicSet(&inRingRd, 0);
+    SDL_AtomicSet(&inRingWr, AUDIO_RECBUF_INIT);
 }
 
-void Audio_Input_Unlock() {
-    host_unlock(&recBufferLock);
+/* Copy up to len mu-law samples from input ring, returns number of samples */
+int Audio_Input_Read(Uint8* data, int len) {
+    Uint32 wr, rd, avail, pos, chunk;
+    
+    if (!bSoundInputWorking) {
+        memset(data, snd_make_ulaw(0), len); /* silence */
+        return len;
+    }
+    wr    = SDL_AtomicGet(&inRingWr);
+    rd    = SDL_AtomicGet(&inRingRd);
+    avail = wr - rd;
+    if ((Uint32)len > avail) len = avail;
+    pos   = rd & IN_RING_MASK;
+    chunk = (1<<IN_RING_SZ) - pos;
+    if (chunk > (Uint32)len) chunk = len;
+    memcpy(data, &inRing[pos], chunk);
+    memcpy(data + chunk, inRing, len - chunk);
+    SDL_AtomicSet(&inRingRd, rd + len);
+    return len;
 }
 
 static bool check_audio(int requested, int granted, const char* attribute) {
@@ -132,10 +214,11 @@ void Audio_Output_Init(void)
     request.freq     = AUDIO_OUT_FREQUENCY; /* 44,1 kHz */
     request.format   = AUDIO_S16MSB;        /* 16-Bit signed, big endian */
     request.channels = 2;                   /* stereo */
-    request.callback = NULL;
+    request.callback = Audio_Output_CallBack;
     request.userdata = NULL;
     request.samples  = AUDIO_BUFFER_SAMPLES; /* buffer size in samples */
 
+    Audio_Output_InitBuf();
     Audio_Output_Device = SDL_OpenAudioDevice(NULL, 0, &request, &granted, 0);
     if (Audio_Output_Device==0)	/* Open audio device */ {
         Log_Printf(LOG_WARN, "[Audio] Can't use audio: %s\n", SDL_GetError());
@@ -160,6 +243,11 @@ void Audio_Output_Init(void)
 void Audio_Input_Init(void) {    
     SDL_AudioSpec request;    /* We fill in the desired SDL audio options here */
     SDL_AudioSpec granted;
+    int i;
+    
+    for (i = 0; i < (1<<16); i++) {
+        ulawTable[i] = snd_make_ulaw((Sint16)i);
+    }
     
     /* Init the SDL's audio subsystem: */
     if (SDL_WasInit(SDL_INIT_AUDIO) == 0) {
@@ -6,30 +6,35 @@
 
   AVI File recording
 
-  This allows Hatari to record a video file, with both video and audio
-  streams, at full frame rate.
-  
-  Video frames are saved using the current video frequency of the emulated
-  machine (50 Hz, 60 Hz, 70 Hz, ...). Frames can be stored using different
-  codecs. So far, supported codecs are :
+  This allows Previous to record a video file, with both video and audio
+  streams, at a fixed frame rate.
+
+  Recording is done as a pipeline so that neither the emulation nor the
+  screen repaint thread waits for compression or disk i/o:
+   - The repaint thread hands each blitted frame to Avi_CaptureFrame. Rows
+     are compared against the previously captured frame; unchanged frames
+     are queued as repeats without copying any pixels. Changed frames are
+     copied into one of AVI_FRAME_QUEUE preallocated buffers. If all buffers
+     are in use the frame is dropped.
+   - Sound output samples are tapped from Audio_Output_Queue into a
+     lock-free ring.
+   - A separate encoder thread converts and compresses the frames, writes
+     the audio and video chunks and keeps the chunk index in memory.
+
+  Video frames can be stored using different codecs :
    - BMP : uncompressed RGB images. Very fast to save, very few cpu needed
      but requires a lot of disk bandwidth and a lot of space.
-   - PNG : compressed RBG images. Depending on the compression level, this
-     can require more cpu and could slow down Hatari. As compressed images
-     are much smaller than BMP images, this will require less space on disk
-     and much less disk bandwidth. Compression levels 3 or 4 give good
-     tradeoff between cpu usage and file size and should not slow down Hatari
-     with recent computers.
+   - PNG : compressed RBG images. Compression levels 3 or 4 give good
+     tradeoff between cpu usage and file size.
 
-  PNG compression will often give a x20 ratio when compared to BMP and should
-  be used if you have a powerful enough cpu.
+  Frames are placed on the AVI timeline according to the host time they
+  were captured at. Repeated frames are written as empty video chunks.
 
-  Sound is saved as 16 bits pcm stereo, using the current Hatari sound output
-  frequency. For best accuracy, sound frequency should be a multiple of the
-  video frequency ; this means 44.1 kHz is the best choice for 50/60 Hz video.
+  Sound is saved as 16 bits pcm stereo, using the sound output frequency.
 
-  The AVI file is divided into multiple chunks. Hatari will save one video stream
-  and one audio stream, so the overall structure of the file is the following :
+  The AVI file is divided into multiple chunks. Previous will save one video
+  stream and one audio stream, so the overall structure of the file is the
+  following :
 
   RIFF avi
       LIST
@@ -47,13 +52,13 @@
 	INFO
       LIST
 	movi
-	  00db
+	  00dc
 	  01wb
 	  ...
       idx1
 */
 
-const char AVIRecord_fileid[] = "Hatari avi_record.c : " __DATE__ " " __TIME__;
+const char AVIRecord_fileid[] = "Previous avi_record.c : " __DATE__ " " __TIME__;
 
 #include <SDL.h>
 #include <SDL_endian.h>
@@ -63,9 +68,7 @@ const char AVIRecord_fileid[] = "Hatari avi_record.c : " __DATE__ " " __TIME__;
 #include "configuration.h"
 #include "log.h"
 #include "screen.h"
-#include "screenSnapShot.h"
-#include "sound.h"
-#include "statusbar.h"
+#include "snd.h"
 #include "avi_record.h"
 
 /* after above that brings in config.h */
@@ -73,8 +76,6 @@ const char AVIRecord_fileid[] = "Hatari avi_record.c : " __DATE__ " " __TIME__;
 #include <png.h>
 #endif
 
-#include "pixel_convert.h"				/* inline functions */
-
 
 
 typedef struct
@@ -266,15 +267,8 @@ typedef struct {
   int		VideoCodec;
   int		VideoCodecCompressionLevel;					/* 0-9 for png compression */
 
-  SDL_Surface	*Surface;
-
-  int		CropLeft;
-  int		CropRight;
-  int		CropTop;
-  int		CropBottom;
-
-  int		Fps;					/* Fps << 24 */
-  int		Fps_scale;				/* 1 << 24 */
+  int		Fps;					/* Fps << 16 */
+  int		Fps_scale;				/* 1 << 16 */
 
   int		AudioCodec;
   int		AudioFreq;
@@ -287,37 +281,59 @@ typedef struct {
   int		TotalVideoFrames;			/* number of recorded video frames */
   int		TotalAudioSamples;			/* number of recorded audio samples */
   long		MoviChunkPosStart;			/* as returned by ftell() */
-  long		MoviChunkPosEnd;			/* as returned by ftell() */
-} RECORD_AVI_PARAMS;
+  Uint8		*LineBuf;				/* 24-bit row for the encoder */
+  Uint32	*Pending;				/* frame skipped by the encoder */
+  bool		bPending;
 
+  AVI_CHUNK_INDEX *Index;				/* index of all chunks in 'movi' */
+  int		IndexCount;
+  int		IndexSize;
+} RECORD_AVI_PARAMS;
 
 
-bool		bRecordingAvi = false;
+/* Frames passed from the repaint thread to the encoder thread */
+#define	AVI_FRAME_QUEUE				8
 
-static RECORD_AVI_PARAMS	AviParams;
-static AVI_FILE_HEADER		AviFileHeader;
+typedef struct {
+  Uint32	*Pixels;				/* frame buffer, unused for repeated frames */
+  Uint32	Format;				/* SDL pixel format of Pixels */
+  bool		Repeat;					/* same content as previous frame */
+  double	Time;					/* host time of capture */
+} AVI_FRAME;
 
+/* Sound samples passed from the emulation thread to the encoder thread */
+#define	AVI_AUDIO_RING_SZ			18		/* in power of two */
+#define	AVI_AUDIO_RING_MASK			((1<<AVI_AUDIO_RING_SZ)-1)
 
-static void	Avi_StoreU16 ( Uint8 *p , Uint16 val );
-static void	Avi_StoreU32 ( Uint8 *p , Uint32 val );
-static void	Avi_Store4cc ( Uint8 *p , const char *text );
-static Uint32	Avi_ReadU32 ( Uint8 *p );
 
-static int	Avi_GetBmpSize ( int Width , int Height , int BitCount );
+bool		bRecordingAvi = false;
 
-static bool	Avi_RecordVideoStream_BMP ( RECORD_AVI_PARAMS *pAviParams );
-#if HAVE_LIBPNG
-static bool	Avi_RecordVideoStream_PNG ( RECORD_AVI_PARAMS *pAviParams );
-#endif
-static bool	Avi_RecordAudioStream_PCM ( RECORD_AVI_PARAMS *pAviParams , Sint16 pSamples[][2], int SampleIndex, int SampleLength );
+static RECORD_AVI_PARAMS	AviParams;
+static AVI_FILE_HEADER		AviFileHeader;
 
-static void	Avi_BuildFileHeader ( RECORD_AVI_PARAMS *pAviParams , AVI_FILE_HEADER *pAviFileHeader );
-static bool	Avi_BuildIndex ( RECORD_AVI_PARAMS *pAviParams );
+static AVI_FRAME		FrameQueue[AVI_FRAME_QUEUE];
+static SDL_atomic_t		FrameQueueWr;
+static SDL_atomic_t		FrameQueueRd;
+static Uint32			*LastFrame;			/* last captured frame (repaint thread) */
+static double			StartTime;
 
-static bool	Avi_StartRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams , char *AviFileName );
-static bool	Avi_StopRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams );
+static Uint8			AudioRing[1<<AVI_AUDIO_RING_SZ];
+static SDL_atomic_t		AudioRingWr;
+static SDL_atomic_t		AudioRingRd;
 
+static SDL_Thread		*EncoderThread;
+static SDL_sem			*EncoderSem;
+static SDL_mutex		*CaptureMutex;		/* held while a frame is captured */
+static volatile bool		bEncoderRunning;
+static bool			bEncoderError;
 
+/* Statistics */
+static SDL_atomic_t		FramesCaptured;
+static SDL_atomic_t		FramesRepeated;
+static SDL_atomic_t		FramesDropped;
+static SDL_atomic_t		AudioDropped;
+static int			FramesEncoded;
+static int			MaxQueueDepth;
 
 
 static void	Avi_StoreU16 ( Uint8 *p , Uint16 val )
@@ -346,228 +362,403 @@ static void	Avi_Store4cc ( Uint8 *p , const char *text )
 }
 
 
-static Uint32	Avi_ReadU32 ( Uint8 *p )
+static int	Avi_GetBmpSize ( int Width , int Height , int BitCount )
 {
-	return (p[3]<<24) + (p[2]<<16) + (p[1]<<8) +p[0];
+	return ( Width * Height * BitCount / 8 );						/* bytes in one video frame */
 }
 
 
-static int	Avi_GetBmpSize ( int Width , int Height , int BitCount )
+/*-----------------------------------------------------------------------*/
+/**
+ * Encoder thread functions. These are the only functions writing to the file.
+ */
+
+/* Add a chunk starting at file position Pos to the in-memory index */
+static bool	Avi_AddIndex ( RECORD_AVI_PARAMS *pAviParams , const char *Name , long Pos , Uint32 Size )
 {
-	return ( Width * Height * BitCount / 8 );						/* bytes in one video frame */
+	AVI_CHUNK_INDEX	*pIndex;
+
+	if ( pAviParams->IndexCount == pAviParams->IndexSize )
+	{
+		pAviParams->IndexSize = pAviParams->IndexSize ? pAviParams->IndexSize * 2 : 4096;
+		pIndex = realloc ( pAviParams->Index , pAviParams->IndexSize * sizeof ( AVI_CHUNK_INDEX ) );
+		if ( !pIndex )
+			return false;
+		pAviParams->Index = pIndex;
+	}
+	pIndex = &pAviParams->Index[ pAviParams->IndexCount++ ];
+	Avi_Store4cc ( pIndex->identifier , Name );
+	Avi_StoreU32 ( pIndex->flags , Size ? AVIIF_KEYFRAME : 0 );
+	Avi_StoreU32 ( pIndex->offset , Pos - pAviParams->MoviChunkPosStart - 8 );	/* pos relative to 'movi' */
+	Avi_StoreU32 ( pIndex->length , Size );
+	return true;
 }
 
 
+/* Convert one row of the captured frame to 24-bit RGB or BGR */
+static void	Avi_ConvertRow ( Uint8 *pOut , const Uint32 *pIn , int Width , SDL_PixelFormat *pFormat , bool Bgr )
+{
+	Uint8	r, g, b;
+	int	x;
 
-static bool	Avi_RecordVideoStream_BMP ( RECORD_AVI_PARAMS *pAviParams )
+	for ( x = 0 ; x < Width ; x++ )
+	{
+		if ( pFormat->format == SDL_PIXELFORMAT_ARGB8888 || pFormat->format == SDL_PIXELFORMAT_RGB888 )
+		{
+			r = pIn[x] >> 16;
+			g = pIn[x] >> 8;
+			b = pIn[x];
+		}
+		else
+		{
+			SDL_GetRGB ( pIn[x] , pFormat , &r , &g , &b );
+		}
+		*pOut++ = Bgr ? b : r;
+		*pOut++ = g;
+		*pOut++ = Bgr ? r : b;
+	}
+}
+
+
+static bool	Avi_WriteVideoFrame_BMP ( RECORD_AVI_PARAMS *pAviParams , const Uint32 *pPixels , SDL_PixelFormat *pFormat )
 {
 	AVI_CHUNK	Chunk;
 	int		SizeImage;
-	Uint8		LineBuf[ 3 * pAviParams->Width ];			/* temp buffer to convert to 24-bit BGR format */
-	Uint8		*pBitmapIn , *pBitmapOut;
 	int		y;
-	int		NeedLock;
-	
+
 	SizeImage = Avi_GetBmpSize ( pAviParams->Width , pAviParams->Height , pAviParams->BitCount );
 
 	/* Write the video frame header */
 	Avi_Store4cc ( Chunk.ChunkName , "00db" );				/* stream 0, uncompressed DIB bytes */
-	Avi_StoreU32 ( Chunk.ChunkSize , SizeImage );					/* max size of RGB image */
+	Avi_StoreU32 ( Chunk.ChunkSize , SizeImage );
+	if ( !Avi_AddIndex ( pAviParams , "00db" , ftell ( pAviParams->FileOut ) , SizeImage ) )
+		return false;
 	if ( fwrite ( &Chunk , sizeof ( Chunk ) , 1 , pAviParams->FileOut ) != 1 )
-	{
-		perror ( "Avi_RecordVideoStream_BMP" );
-		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to write bmp frame header" );
 		return false;
-	}
-
-
-	/* Write the video frame data */
-	NeedLock = SDL_MUSTLOCK( pAviParams->Surface );
 
-	/* Points to the top left pixel after cropping borders */
 	/* For BMP format, frame is stored from bottom to top (origin is in bottom left corner) */
 	/* and bytes are in BGR order (not RGB) */
-	pBitmapIn = (Uint8 *)pAviParams->Surface->pixels
-			+ pAviParams->Surface->pitch * ( pAviParams->CropTop + pAviParams->Height )
-			+ pAviParams->CropLeft * pAviParams->Surface->format->BytesPerPixel;
-
-	for ( y=0 ; y<pAviParams->Height ; y++ )
-	{
-		if ( NeedLock )
-			SDL_LockSurface ( pAviParams->Surface );
-
-		pBitmapOut = LineBuf;
-		switch ( pAviParams->Surface->format->BytesPerPixel ) {
-			case 1 :	PixelConvert_8to24Bits_BGR(LineBuf, pBitmapIn, pAviParams->Width, pAviParams->Surface->format->palette->colors);
-					break;
-			case 2 :	PixelConvert_16to24Bits_BGR(LineBuf, (Uint16 *)pBitmapIn, pAviParams->Width, pAviParams->Surface->format);
-					break;
-			case 3 :	PixelConvert_24to24Bits_BGR(LineBuf, pBitmapIn, pAviParams->Width);
-					break;
-			case 4 :	PixelConvert_32to24Bits_BGR(LineBuf, (Uint32 *)pBitmapIn, pAviParams->Width, pAviParams->Surface->format);
-					break;
-		}
-
-		if ( NeedLock )
-			SDL_UnlockSurface ( pAviParams->Surface );
-
-		if ( (int)fwrite ( pBitmapOut , 1 , pAviParams->Width*3 , pAviParams->FileOut ) != pAviParams->Width*3 )
-		{
-			perror ( "Avi_RecordVideoStream_BMP" );
-			Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to write bmp video frame" );
+	for ( y = pAviParams->Height - 1 ; y >= 0 ; y-- )
+	{
+		Avi_ConvertRow ( pAviParams->LineBuf , pPixels + y * pAviParams->Width , pAviParams->Width , pFormat , true );
+		if ( (int)fwrite ( pAviParams->LineBuf , 1 , pAviParams->Width*3 , pAviParams->FileOut ) != pAviParams->Width*3 )
 			return false;
-		}
-
-		pBitmapIn -= pAviParams->Surface->pitch;			/* go from bottom to top */
 	}
-
 	return true;
 }
 
 
-
 #if HAVE_LIBPNG
-static bool	Avi_RecordVideoStream_PNG ( RECORD_AVI_PARAMS *pAviParams )
+static bool	Avi_WriteVideoFrame_PNG ( RECORD_AVI_PARAMS *pAviParams , const Uint32 *pPixels , SDL_PixelFormat *pFormat )
 {
 	AVI_CHUNK	Chunk;
-	int		SizeImage;
-	long		ChunkPos;
-	Uint8	TempSize[4];
-	
+	long		ChunkPos , EndPos;
+	Uint32		SizeImage;
+	Uint8		TempSize[4];
+	png_structp	png_ptr;
+	png_infop	info_ptr;
+	int		y;
 
 	/* Write the video frame header */
 	ChunkPos = ftell ( pAviParams->FileOut );
 	Avi_Store4cc ( Chunk.ChunkName , "00dc" );				/* stream 0, compressed DIB bytes */
 	Avi_StoreU32 ( Chunk.ChunkSize , 0 );					/* size of PNG image (-> completed later) */
 	if ( fwrite ( &Chunk , sizeof ( Chunk ) , 1 , pAviParams->FileOut ) != 1 )
-        goto png_error;
-    
-  	/* Write the video frame data */
-  	SizeImage = ScreenSnapShot_SavePNG_ToFile ( pAviParams->Surface , pAviParams->FileOut ,
-                                               pAviParams->VideoCodecCompressionLevel , PNG_FILTER_NONE ,
-                                               pAviParams->CropLeft , pAviParams->CropRight , pAviParams->CropTop , pAviParams->CropBottom );
-  	if ( SizeImage <= 0 )
-        goto png_error;
+		return false;
+
+	/* Write the video frame data */
+	png_ptr = png_create_write_struct ( PNG_LIBPNG_VER_STRING , NULL , NULL , NULL );
+	if ( !png_ptr )
+		return false;
+	info_ptr = png_create_info_struct ( png_ptr );
+	if ( !info_ptr || setjmp ( png_jmpbuf ( png_ptr ) ) )
+	{
+		png_destroy_write_struct ( &png_ptr , &info_ptr );
+		return false;
+	}
+	png_init_io ( png_ptr , pAviParams->FileOut );
+	png_set_compression_level ( png_ptr , pAviParams->VideoCodecCompressionLevel );
+	png_set_filter ( png_ptr , 0 , PNG_FILTER_NONE );
+	png_set_IHDR ( png_ptr , info_ptr , pAviParams->Width , pAviParams->Height , 8 , PNG_COLOR_TYPE_RGB ,
+		       PNG_INTERLACE_NONE , PNG_COMPRESSION_TYPE_DEFAULT , PNG_FILTER_TYPE_DEFAULT );
+	png_write_info ( png_ptr , info_ptr );
+	for ( y = 0 ; y < pAviParams->Height ; y++ )
+	{
+		Avi_ConvertRow ( pAviParams->LineBuf , pPixels + y * pAviParams->Width , pAviParams->Width , pFormat , false );
+		png_write_row ( png_ptr , pAviParams->LineBuf );
+	}
+	png_write_end ( png_ptr , NULL );
+	png_destroy_write_struct ( &png_ptr , &info_ptr );
+
+	EndPos = ftell ( pAviParams->FileOut );
+	SizeImage = EndPos - ChunkPos - sizeof ( Chunk );
 	if ( SizeImage & 1 )
 	{
-		SizeImage++;							/* add an extra '\0' byte to get an even size */
 		fputc ( '\0' , pAviParams->FileOut );				/* next chunk must be aligned on 16 bits boundary */
+		EndPos++;
 	}
 
 	/* Update the size of the video chunk */
 	Avi_StoreU32 ( TempSize , SizeImage );
 	if ( fseek ( pAviParams->FileOut , ChunkPos+4 , SEEK_SET ) != 0 )
-        goto png_error;
-  	if ( fwrite ( TempSize , sizeof ( TempSize ) , 1 , pAviParams->FileOut ) != 1 )
-        goto png_error;
-    
-  	/* Go to the end of the video frame data */
-  	if ( fseek ( pAviParams->FileOut , 0 , SEEK_END ) != 0 )
-        goto png_error;
-	return true;
+		return false;
+	if ( fwrite ( TempSize , sizeof ( TempSize ) , 1 , pAviParams->FileOut ) != 1 )
+		return false;
+	if ( fseek ( pAviParams->FileOut , EndPos , SEEK_SET ) != 0 )
+		return false;
 
-png_error:
-    perror ( "Avi_RecordVideoStream_PNG" );
-    Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to write png frame" );
-    return false;
+	return Avi_AddIndex ( pAviParams , "00dc" , ChunkPos , SizeImage );
 }
 #endif  /* HAVE_LIBPNG */
 
 
+/* Write an empty video chunk: players show the previous frame again */
+static bool	Avi_WriteVideoRepeat ( RECORD_AVI_PARAMS *pAviParams )
+{
+	AVI_CHUNK	Chunk;
+	const char	*Name = pAviParams->VideoCodec == AVI_RECORD_VIDEO_CODEC_BMP ? "00db" : "00dc";
+
+	Avi_Store4cc ( Chunk.ChunkName , Name );
+	Avi_StoreU32 ( Chunk.ChunkSize , 0 );
+	if ( !Avi_AddIndex ( pAviParams , Name , ftell ( pAviParams->FileOut ) , 0 ) )
+		return false;
+	return fwrite ( &Chunk , sizeof ( Chunk ) , 1 , pAviParams->FileOut ) == 1;
+}
+
 
-bool	Avi_RecordVideoStream ( void )
+/* Write all sound samples collected so far as one chunk */
+static bool	Avi_WriteAudio_PCM ( RECORD_AVI_PARAMS *pAviParams )
 {
-	if ( AviParams.VideoCodec == AVI_RECORD_VIDEO_CODEC_BMP )
+	AVI_CHUNK	Chunk;
+	Uint8		Buf[4096];
+	Uint32		rd , len , n , i;
+
+	rd  = SDL_AtomicGet ( &AudioRingRd );
+	len = ( (Uint32)SDL_AtomicGet ( &AudioRingWr ) - rd ) & ~3;
+	if ( len == 0 )
+		return true;
+
+	/* Write the audio frame header */
+	Avi_Store4cc ( Chunk.ChunkName , "01wb" );				/* stream 1, wave bytes */
+	Avi_StoreU32 ( Chunk.ChunkSize , len );
+	if ( !Avi_AddIndex ( pAviParams , "01wb" , ftell ( pAviParams->FileOut ) , len ) )
+		return false;
+	if ( fwrite ( &Chunk , sizeof ( Chunk ) , 1 , pAviParams->FileOut ) != 1 )
+		return false;
+
+	/* Write the audio frame data, converting big endian samples to little endian */
+	pAviParams->TotalAudioSamples += len / 4;
+	while ( len > 0 )
 	{
-		if ( Avi_RecordVideoStream_BMP ( &AviParams ) == false )
+		n = len < sizeof ( Buf ) ? len : sizeof ( Buf );
+		for ( i = 0 ; i < n ; i += 2 , rd += 2 )
 		{
-			return false;
+			Buf[i]   = AudioRing[ (rd+1) & AVI_AUDIO_RING_MASK ];
+			Buf[i+1] = AudioRing[ rd & AVI_AUDIO_RING_MASK ];
 		}
+		SDL_AtomicSet ( &AudioRingRd , rd );
+		if ( fwrite ( Buf , 1 , n , pAviParams->FileOut ) != n )
+			return false;
+		len -= n;
 	}
+	return true;
+}
+
+
+/* Write one video frame, or an empty chunk if pPixels is NULL */
+static bool	Avi_WriteVideoFrame ( RECORD_AVI_PARAMS *pAviParams , const Uint32 *pPixels , SDL_PixelFormat *pFormat )
+{
+	pAviParams->TotalVideoFrames++;
+	if ( !pPixels )
+		return Avi_WriteVideoRepeat ( pAviParams );
 #if HAVE_LIBPNG
-	else if ( AviParams.VideoCodec == AVI_RECORD_VIDEO_CODEC_PNG )
+	if ( pAviParams->VideoCodec == AVI_RECORD_VIDEO_CODEC_PNG )
+		return Avi_WriteVideoFrame_PNG ( pAviParams , pPixels , pFormat );
+#endif
+	return Avi_WriteVideoFrame_BMP ( pAviParams , pPixels , pFormat );
+}
+
+
+/* Write one frame from the queue, placed on the timeline by its capture time */
+static bool	Avi_WriteFrame ( RECORD_AVI_PARAMS *pAviParams , AVI_FRAME *pFrame , SDL_PixelFormat *pFormat )
+{
+	const Uint32	*pPixels;
+	int		Target , FrameSize;
+
+	/* Number of frames the timeline should contain after this one */
+	Target = (int)( ( pFrame->Time - StartTime ) * pAviParams->Fps / pAviParams->Fps_scale ) + 1;
+	FrameSize = pAviParams->Width * pAviParams->Height * sizeof ( Uint32 );
+
+	if ( Target <= pAviParams->TotalVideoFrames )
 	{
-		if ( Avi_RecordVideoStream_PNG ( &AviParams ) == false )
+		/* Faster than the frame rate, keep the content for the next slot */
+		if ( !pFrame->Repeat )
 		{
-			return false;
+			memcpy ( pAviParams->Pending , pFrame->Pixels , FrameSize );
+			pAviParams->bPending = true;
 		}
+		return true;
 	}
-#endif
-	else
-	{
+
+	if ( !Avi_WriteAudio_PCM ( pAviParams ) )
 		return false;
+
+	pPixels = pFrame->Repeat ? NULL : pFrame->Pixels;
+
+	/* Fill gaps in the timeline, starting with a skipped frame if there is one */
+	if ( pAviParams->bPending )
+	{
+		if ( pAviParams->TotalVideoFrames < Target - 1 )
+		{
+			if ( !Avi_WriteVideoFrame ( pAviParams , pAviParams->Pending , pFormat ) )
+				return false;
+		}
+		else if ( !pPixels )
+			pPixels = pAviParams->Pending;
+		pAviParams->bPending = false;
 	}
+	while ( pAviParams->TotalVideoFrames < Target - 1 )
+		if ( !Avi_WriteVideoFrame ( pAviParams , NULL , pFormat ) )
+			return false;
 
-    if (++AviParams.TotalVideoFrames % ( AviParams.Fps / AviParams.Fps_scale ) == 0)
-    {
-        int secs = AviParams.TotalVideoFrames / ( AviParams.Fps / AviParams.Fps_scale );
-        char str[6] = "00:00";
-        str[0] = '0' + (secs / 60) / 10;
-        str[1] = '0' + (secs / 60) % 10;
-        str[3] = '0' + (secs % 60) / 10;
-        str[4] = '0' + (secs % 60) % 10;
-        Main_SetTitle(str);
-    }
-	return true;
+	FramesEncoded++;
+	return Avi_WriteVideoFrame ( pAviParams , pPixels , pFormat );
 }
 
 
-
-static bool	Avi_RecordAudioStream_PCM ( RECORD_AVI_PARAMS *pAviParams , Sint16 pSamples[][2] , int SampleIndex , int SampleLength )
+static int	Avi_Encoder ( void *unused )
 {
-	AVI_CHUNK	Chunk;
-	Sint16		sample[2];
-	int		i;
+	SDL_PixelFormat	*pFormat = NULL;
+	AVI_FRAME	*pFrame;
+	Uint32		rd , depth;
 
-	/* Write the audio frame header */
-	Avi_Store4cc ( Chunk.ChunkName , "01wb" );				/* stream 1, wave bytes */
-	Avi_StoreU32 ( Chunk.ChunkSize , SampleLength * 4 );			/* 16 bits, stereo -> 4 bytes */
-	if ( fwrite ( &Chunk , sizeof ( Chunk ) , 1 , pAviParams->FileOut ) != 1 )
+	while ( true )
 	{
-		perror ( "Avi_RecordAudioStream_PCM" );
-		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to write pcm frame header" );
-		return false;
-	}
+		SDL_SemWait ( EncoderSem );
 
-	/* Write the audio frame data */
-	for ( i = 0 ; i < SampleLength; i++ )
-	{
-		/* Convert sample to little endian */
-		sample[0] = SDL_SwapLE16 ( pSamples[ (SampleIndex+i) % MIXBUFFER_SIZE ][0]);
-		sample[1] = SDL_SwapLE16 ( pSamples[ (SampleIndex+i) % MIXBUFFER_SIZE ][1]);
-		/* And store */
-		if ( fwrite ( &sample , sizeof ( sample ) , 1 , pAviParams->FileOut ) != 1 )
+		rd = SDL_AtomicGet ( &FrameQueueRd );
+		depth = (Uint32)SDL_AtomicGet ( &FrameQueueWr ) - rd;
+		if ( depth == 0 )
 		{
-			perror ( "Avi_RecordAudioStream_PCM" );
-			Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to write pcm frame" );
-			return false;
+			if ( !bEncoderRunning )
+				break;
+			continue;
 		}
+		if ( (int)depth > MaxQueueDepth )
+			MaxQueueDepth = depth;
+
+		pFrame = &FrameQueue[ rd % AVI_FRAME_QUEUE ];
+		if ( !pFormat || pFormat->format != pFrame->Format )
+		{
+			if ( pFormat )
+				SDL_FreeFormat ( pFormat );
+			pFormat = SDL_AllocFormat ( pFrame->Format );
+		}
+		if ( !bEncoderError && !Avi_WriteFrame ( &AviParams , pFrame , pFormat ) )
+		{
+			perror ( "Avi_Encoder" );
+			bEncoderError = true;
+		}
+		SDL_AtomicSet ( &FrameQueueRd , rd + 1 );
 	}
+	/* Flush remaining sound samples */
+	if ( !bEncoderError && !Avi_WriteAudio_PCM ( &AviParams ) )
+		bEncoderError = true;
 
-	return true;
+	if ( pFormat )
+		SDL_FreeFormat ( pFormat );
+	return 0;
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Capture functions, called from the repaint and emulation threads.
+ */
 
-bool	Avi_RecordAudioStream ( Sint16 pSamples[][2] , int SampleIndex , int SampleLength )
+/* Hand a frame (Width x Height 32 bit pixels at Pitch bytes per row) to the encoder */
+void	Avi_CaptureFrame ( const void *pPixels , int Width , int Height , int Pitch , Uint32 Format )
 {
-	if ( AviParams.AudioCodec == AVI_RECORD_AUDIO_CODEC_PCM )
+	const Uint8	*pIn = pPixels;
+	AVI_FRAME	*pFrame;
+	Uint32		wr;
+	Uint64		Now;
+	bool		Changed = false;
+	int		y , RowSize;
+
+	if ( !bRecordingAvi )
+		return;
+
+	/* Recording may have been stopped and the buffers freed meanwhile */
+	SDL_LockMutex ( CaptureMutex );
+	if ( !bRecordingAvi )
 	{
-		if ( Avi_RecordAudioStream_PCM ( &AviParams , pSamples , SampleIndex , SampleLength ) == false )
-		{
-			return false;
-		}
+		SDL_UnlockMutex ( CaptureMutex );
+		return;
 	}
-	else
+
+	wr = SDL_AtomicGet ( &FrameQueueWr );
+	if ( wr - (Uint32)SDL_AtomicGet ( &FrameQueueRd ) >= AVI_FRAME_QUEUE
+	  || Width != AviParams.Width || Height != AviParams.Height )
 	{
-		return false;
+		SDL_AtomicAdd ( &FramesDropped , 1 );			/* encoder lags behind or size changed */
+		SDL_UnlockMutex ( CaptureMutex );
+		return;
 	}
+	pFrame = &FrameQueue[ wr % AVI_FRAME_QUEUE ];
 
-	AviParams.TotalAudioSamples += SampleLength;
-	return true;
+	/* Update only the rows that changed since the last captured frame */
+	RowSize = AviParams.Width * 4;
+	for ( y = 0 ; y < AviParams.Height ; y++ , pIn += Pitch )
+	{
+		if ( memcmp ( LastFrame + y * AviParams.Width , pIn , RowSize ) )
+		{
+			memcpy ( LastFrame + y * AviParams.Width , pIn , RowSize );
+			Changed = true;
+		}
+	}
+	if ( SDL_AtomicGet ( &FramesCaptured ) == 0 )
+		Changed = true;
+
+	pFrame->Format = Format;
+	pFrame->Repeat = !Changed;
+	if ( Changed )
+		memcpy ( pFrame->Pixels , LastFrame , RowSize * AviParams.Height );
+	else
+		SDL_AtomicAdd ( &FramesRepeated , 1 );
+	Now = SDL_GetPerformanceCounter();
+	pFrame->Time = (double)Now / SDL_GetPerformanceFrequency();
+
+	SDL_AtomicAdd ( &FramesCaptured , 1 );
+	SDL_AtomicSet ( &FrameQueueWr , wr + 1 );
+	SDL_SemPost ( EncoderSem );
+	SDL_UnlockMutex ( CaptureMutex );
 }
 
 
+/* Tap big endian 16 bit stereo samples from the sound output */
+void	Avi_CaptureAudio ( const Uint8 *pSamples , int Len )
+{
+	Uint32	wr , room , pos , chunk;
+
+	if ( !bRecordingAvi )
+		return;
+
+	wr   = SDL_AtomicGet ( &AudioRingWr );
+	room = (1<<AVI_AUDIO_RING_SZ) - ( wr - (Uint32)SDL_AtomicGet ( &AudioRingRd ) );
+	if ( (Uint32)Len > room )
+	{
+		SDL_AtomicAdd ( &AudioDropped , Len - room );
+		Len = room & ~3;
+	}
+	pos   = wr & AVI_AUDIO_RING_MASK;
+	chunk = (1<<AVI_AUDIO_RING_SZ) - pos;
+	if ( chunk > (Uint32)Len )
+		chunk = Len;
+	memcpy ( &AudioRing[pos] , pSamples , chunk );
+	memcpy ( AudioRing , pSamples + chunk , Len - chunk );
+	SDL_AtomicSet ( &AudioRingWr , wr + Len );
+}
 
 
 static void	Avi_BuildFileHeader ( RECORD_AVI_PARAMS *pAviParams , AVI_FILE_HEADER *pAviFileHeader )
@@ -719,95 +910,50 @@ static void	Avi_BuildFileHeader ( RECORD_AVI_PARAMS *pAviParams , AVI_FILE_HEADE
 }
 
 
-static bool	Avi_BuildIndex ( RECORD_AVI_PARAMS *pAviParams )
-{
-	AVI_CHUNK	Chunk;
-	long		IndexChunkPosStart;
-	long		Pos , PosWrite;
-	Uint8		TempSize[4];
-	AVI_CHUNK_INDEX	ChunkIndex;
-	Uint32		Size;
-
-	fseek ( pAviParams->FileOut , 0 , SEEK_END );				/* go to the end of the file */
-
-	/* Write the 'idx1' chunk header */
-	IndexChunkPosStart = ftell ( pAviParams->FileOut );
-	Avi_Store4cc ( Chunk.ChunkName , "idx1" );				/* stream 0, uncompressed DIB bytes */
-	Avi_StoreU32 ( Chunk.ChunkSize , 0 );					/* index size (-> completed later) */
-	if ( fwrite ( &Chunk , sizeof ( Chunk ) , 1 , pAviParams->FileOut ) != 1 )
-        goto index_error;
-	PosWrite = ftell ( pAviParams->FileOut );				/* position to start writing indexes */
-
-	/* Go to the first data chunk in the 'movi' chunk */
-	fseek ( pAviParams->FileOut , pAviParams->MoviChunkPosStart + sizeof ( AVI_STREAM_LIST_MOVI ) , SEEK_SET );
-	Pos = ftell ( pAviParams->FileOut );
-
-	/* Build the index : we seek/read one data chunk and seek/write the */
-	/* corresponding infos at the end of the index, until we reach the */
-	/* end of the 'movi' chunk. */
-	while ( Pos < pAviParams->MoviChunkPosEnd )
-	{
-		/* Read the header for this data chunk: ChunkName and ChunkSize */
-		if (fread(&Chunk, sizeof(Chunk), 1, pAviParams->FileOut) != 1)
-            goto index_error;
-		Size = Avi_ReadU32 ( Chunk.ChunkSize );
-
-		/* Write the index infos for this chunk */
-		fseek ( pAviParams->FileOut , PosWrite , SEEK_SET );
-		Avi_Store4cc ( ChunkIndex.identifier , (char *)Chunk.ChunkName );	/* 00dc, 00db, 01wb, ... */
-		Avi_StoreU32 ( ChunkIndex.flags , AVIIF_KEYFRAME );		/* AVIIF_KEYFRAME */
-		Avi_StoreU32 ( ChunkIndex.offset , Pos - pAviParams->MoviChunkPosStart - 8  );	/* pos relative to 'movi' */
-		Avi_StoreU32 ( ChunkIndex.length , Size );
-		if (fwrite ( &ChunkIndex , sizeof ( ChunkIndex ) , 1 , pAviParams->FileOut ) != 1)
-            goto index_error;
-		PosWrite = ftell ( pAviParams->FileOut );			/* position for the next index */
-
-		/* Go to the next data chunk in the 'movi' chunk */
-		Pos = Pos + sizeof ( Chunk ) + Size;				/* position of the next data chunk */
-		fseek ( pAviParams->FileOut , Pos , SEEK_SET );
-	}
-
-	/* Update the size of the 'idx1' chunk */
-	Avi_StoreU32 ( TempSize , PosWrite - IndexChunkPosStart - 8 );
-	if ( fseek ( pAviParams->FileOut , IndexChunkPosStart+4 , SEEK_SET ) != 0 )
-        goto index_error;
-  	if ( fwrite ( TempSize , sizeof ( TempSize ) , 1 , pAviParams->FileOut ) != 1 )
-        goto index_error;
-	return true;
-
-index_error:
-    perror ( "Avi_BuildIndex" );
-    Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to create index header" );
-    return false;
-
-}
-
 
-static bool	Avi_StartRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams , char *AviFileName )
+static bool	Avi_StartRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams , const char *AviFileName )
 {
 	AVI_STREAM_LIST_INFO	ListInfo;
 	char			InfoString[ 100 ];
 	int			Len , Len_rounded;
 	AVI_STREAM_LIST_MOVI	ListMovi;
+	Uint64			Now;
+	int			i;
 
 
 	if ( bRecordingAvi == true )						/* already recording ? */
 		return false;
 
-	/* Compute some video parameters */
-	pAviParams->Width = pAviParams->Surface->w - pAviParams->CropLeft - pAviParams->CropRight;
-	pAviParams->Height = pAviParams->Surface->h - pAviParams->CropTop - pAviParams->CropBottom;
+	/* Kept for the whole session, the repaint thread may still be waiting for it */
+	if ( !CaptureMutex && !( CaptureMutex = SDL_CreateMutex () ) )
+	{
+		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to create capture mutex" );
+		return false;
+	}
+
 	pAviParams->BitCount = 24;
-	
+
 #if !HAVE_LIBPNG
 	if ( pAviParams->VideoCodec == AVI_RECORD_VIDEO_CODEC_PNG )
 	{
-		perror ( "AviStartRecording" );
-		Log_AlertDlg ( LOG_ERROR, "AVI recording : Hatari was not built with libpng support" );
-		return false;
+		Log_Printf ( LOG_WARN , "AVI recording : Previous was not built with libpng support, using bmp" );
+		pAviParams->VideoCodec = AVI_RECORD_VIDEO_CODEC_BMP;
 	}
 #endif
 
+	/* Allocate frame buffers */
+	LastFrame = calloc ( pAviParams->Width * pAviParams->Height , sizeof ( Uint32 ) );
+	pAviParams->LineBuf = malloc ( pAviParams->Width * 3 );
+	pAviParams->Pending = malloc ( pAviParams->Width * pAviParams->Height * sizeof ( Uint32 ) );
+	for ( i = 0 ; i < AVI_FRAME_QUEUE ; i++ )
+		if ( !( FrameQueue[i].Pixels = malloc ( pAviParams->Width * pAviParams->Height * sizeof ( Uint32 ) ) ) )
+			break;
+	if ( !LastFrame || !pAviParams->LineBuf || !pAviParams->Pending || i < AVI_FRAME_QUEUE )
+	{
+		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to allocate frame buffers" );
+		return false;
+	}
+
 	/* Open the file */
 	pAviParams->FileOut = fopen ( AviFileName , "wb+" );
 	if ( !pAviParams->FileOut )
@@ -830,7 +976,7 @@ static bool	Avi_StartRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams , char
 
 	/* Write the INFO header */
 	memset ( InfoString , 0 , sizeof ( InfoString ) );
-	Len = snprintf ( InfoString , sizeof ( InfoString ) , "%s - the Atari ST, STE, TT and Falcon emulator" , PROG_NAME ) + 1;
+	Len = snprintf ( InfoString , sizeof ( InfoString ) , "%s - the NeXT computer emulator" , PROG_NAME ) + 1;
 	Len_rounded = Len + ( Len % 2 == 0 ? 0 : 1 );				/* round Len to the next multiple of 2 */
 	Avi_Store4cc ( ListInfo.ChunkName , "LIST" );
 	Avi_StoreU32 ( ListInfo.ChunkSize , sizeof ( AVI_STREAM_LIST_INFO ) - 8 + Len_rounded );
@@ -863,6 +1009,37 @@ static bool	Avi_StartRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams , char
 		return false;
 	}
 
+	/* Start the encoder */
+	SDL_AtomicSet ( &FrameQueueWr , 0 );
+	SDL_AtomicSet ( &FrameQueueRd , 0 );
+	SDL_AtomicSet ( &AudioRingWr , 0 );
+	SDL_AtomicSet ( &AudioRingRd , 0 );
+	SDL_AtomicSet ( &FramesCaptured , 0 );
+	SDL_AtomicSet ( &FramesRepeated , 0 );
+	SDL_AtomicSet ( &FramesDropped , 0 );
+	SDL_AtomicSet ( &AudioDropped , 0 );
+	FramesEncoded = 0;
+	MaxQueueDepth = 0;
+	Now = SDL_GetPerformanceCounter();
+	StartTime = (double)Now / SDL_GetPerformanceFrequency();
+	bEncoderError = false;
+	bEncoderRunning = true;
+	EncoderSem = SDL_CreateSemaphore ( 0 );
+	if ( !EncoderSem )
+	{
+		bEncoderRunning = false;
+		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to create encoder semaphore" );
+		return false;
+	}
+	EncoderThread = SDL_CreateThread ( Avi_Encoder , "[Previous] AVI encoder" , NULL );
+	if ( !EncoderThread )
+	{
+		bEncoderRunning = false;
+		SDL_DestroySemaphore ( EncoderSem );
+		EncoderSem = NULL;
+		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to start encoder thread" );
+		return false;
+	}
 
 	/* We're ok to record */
 	Log_AlertDlg ( LOG_INFO, "AVI recording has been started");
@@ -873,43 +1050,87 @@ static bool	Avi_StartRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams , char
 
 
 
+static void	Avi_FreeBuffers ( RECORD_AVI_PARAMS *pAviParams )
+{
+	int	i;
+
+	for ( i = 0 ; i < AVI_FRAME_QUEUE ; i++ )
+	{
+		free ( FrameQueue[i].Pixels );
+		FrameQueue[i].Pixels = NULL;
+	}
+	free ( LastFrame );
+	LastFrame = NULL;
+	free ( pAviParams->LineBuf );
+	pAviParams->LineBuf = NULL;
+	free ( pAviParams->Pending );
+	pAviParams->Pending = NULL;
+	free ( pAviParams->Index );
+	pAviParams->Index = NULL;
+	pAviParams->IndexCount = pAviParams->IndexSize = 0;
+}
+
+
+
 static bool	Avi_StopRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams )
 {
-	long	FileSize;
-	Uint8	TempSize[4];
+	AVI_CHUNK	Chunk;
+	long		FileSize , MoviChunkPosEnd;
+	Uint8		TempSize[4];
 
 
 	if ( bRecordingAvi == false )						/* no recording ? */
 		return true;
 
-	/* Update the size of the 'movi' chunk */
-	fseek ( pAviParams->FileOut , 0 , SEEK_END );				/* go to the end of the 'movi' chunk */
-	pAviParams->MoviChunkPosEnd = ftell ( pAviParams->FileOut );
-	Avi_StoreU32 ( TempSize , pAviParams->MoviChunkPosEnd - pAviParams->MoviChunkPosStart - 8 );
-
-	if ( fseek ( pAviParams->FileOut , pAviParams->MoviChunkPosStart+4 , SEEK_SET ) != 0 )
+	/* Stop capturing, wait for a frame capture in progress to finish,
+	 * and let the encoder finish the queued frames */
+	SDL_LockMutex ( CaptureMutex );
+	bRecordingAvi = false;
+	SDL_UnlockMutex ( CaptureMutex );
+	bEncoderRunning = false;
+	SDL_SemPost ( EncoderSem );
+	SDL_WaitThread ( EncoderThread , NULL );
+	SDL_DestroySemaphore ( EncoderSem );
+	EncoderThread = NULL;
+
+	if ( bEncoderError )
 	{
-		perror ( "AviStopRecording" );
-		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to update movi header" );
+		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to write frame" );
+		fclose ( pAviParams->FileOut );
+		Avi_FreeBuffers ( pAviParams );
 		return false;
 	}
-	if ( fwrite ( TempSize , sizeof ( TempSize ) , 1 , pAviParams->FileOut ) != 1 )
+
+	/* Update the size of the 'movi' chunk */
+	fseek ( pAviParams->FileOut , 0 , SEEK_END );				/* go to the end of the 'movi' chunk */
+	MoviChunkPosEnd = ftell ( pAviParams->FileOut );
+	Avi_StoreU32 ( TempSize , MoviChunkPosEnd - pAviParams->MoviChunkPosStart - 8 );
+
+	if ( fseek ( pAviParams->FileOut , pAviParams->MoviChunkPosStart+4 , SEEK_SET ) != 0
+	  || fwrite ( TempSize , sizeof ( TempSize ) , 1 , pAviParams->FileOut ) != 1 )
 	{
 		perror ( "AviStopRecording" );
 		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to update movi header" );
+		fclose ( pAviParams->FileOut );
+		Avi_FreeBuffers ( pAviParams );
 		return false;
 	}
 
-	/* Build the index chunk */
-	if ( ! Avi_BuildIndex ( pAviParams ) )
+	/* Write the index chunk collected by the encoder */
+	fseek ( pAviParams->FileOut , 0 , SEEK_END );
+	Avi_Store4cc ( Chunk.ChunkName , "idx1" );
+	Avi_StoreU32 ( Chunk.ChunkSize , pAviParams->IndexCount * sizeof ( AVI_CHUNK_INDEX ) );
+	if ( fwrite ( &Chunk , sizeof ( Chunk ) , 1 , pAviParams->FileOut ) != 1
+	  || (int)fwrite ( pAviParams->Index , sizeof ( AVI_CHUNK_INDEX ) , pAviParams->IndexCount , pAviParams->FileOut ) != pAviParams->IndexCount )
 	{
 		perror ( "AviStopRecording" );
 		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to build index" );
+		fclose ( pAviParams->FileOut );
+		Avi_FreeBuffers ( pAviParams );
 		return false;
 	}
 	
 	/* Update the avi header (file size, number of output frames, ...) */
-	fseek ( pAviParams->FileOut , 0 , SEEK_END );				/* go to the end of the file */
 	FileSize = ftell ( pAviParams->FileOut );
 
 	Avi_StoreU32 ( AviFileHeader.RiffHeader.filesize , FileSize - 8 );	/* 32 bits, limited to 4GB */
@@ -917,25 +1138,25 @@ static bool	Avi_StopRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams )
 	Avi_StoreU32 ( AviFileHeader.VideoStream.Header.data_length , pAviParams->TotalVideoFrames );	/* number of video frames */
 	Avi_StoreU32 ( AviFileHeader.AudioStream.Header.data_length , pAviParams->TotalAudioSamples );	/* number of audio samples */
 
-	if ( fseek ( pAviParams->FileOut , 0 , SEEK_SET ) != 0 )
-	{
-		perror ( "AviStopRecording" );
-		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to update avi header" );
-		return false;
-	}
-	if ( fwrite ( &AviFileHeader , sizeof ( AviFileHeader ) , 1 , pAviParams->FileOut ) != 1 )
+	if ( fseek ( pAviParams->FileOut , 0 , SEEK_SET ) != 0
+	  || fwrite ( &AviFileHeader , sizeof ( AviFileHeader ) , 1 , pAviParams->FileOut ) != 1 )
 	{
 		perror ( "AviStopRecording" );
 		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to update avi header" );
+		fclose ( pAviParams->FileOut );
+		Avi_FreeBuffers ( pAviParams );
 		return false;
 	}
 
 
 	/* Close the file */
 	fclose ( pAviParams->FileOut );
+	Avi_FreeBuffers ( pAviParams );
 
+	Log_Printf ( LOG_WARN , "[AVI] %d frames written, %d captured, %d repeated, %d dropped, %d audio bytes dropped",
+		     pAviParams->TotalVideoFrames , SDL_AtomicGet ( &FramesCaptured ) , SDL_AtomicGet ( &FramesRepeated ) ,
+		     SDL_AtomicGet ( &FramesDropped ) , SDL_AtomicGet ( &AudioDropped ) );
 	Log_AlertDlg ( LOG_INFO, "AVI recording has been stopped");
-	bRecordingAvi = false;
 
 	return true;
 }
@@ -949,58 +1170,86 @@ static bool	Avi_StopRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams )
  */
 bool	Avi_AreWeRecording ( void )
 {
-        return bRecordingAvi;
+	return bRecordingAvi;
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Report capture statistics. Lag is the deepest frame queue seen by the
+ * encoder since the last report.
+ */
+const char*	Avi_Report ( double realTime , double hostTime )
+{
+	static char	report[128];
 
-bool	Avi_StartRecording ( char *FileName , bool CropGui , Uint32 Fps , Uint32 Fps_scale , int VideoCodec )
+	report[0] = 0;
+	if ( bRecordingAvi )
+	{
+		sprintf ( report , "captured:%d encoded:%d repeated:%d dropped:%d lag:%d audiodrop:%d" ,
+			  SDL_AtomicGet ( &FramesCaptured ) , FramesEncoded , SDL_AtomicGet ( &FramesRepeated ) ,
+			  SDL_AtomicGet ( &FramesDropped ) , MaxQueueDepth , SDL_AtomicGet ( &AudioDropped ) );
+		MaxQueueDepth = 0;
+	}
+	return report;
+}
+
+
+
+bool	Avi_StartRecording ( const char *FileName , int Width , int Height , int Fps , int VideoCodec )
 {
 	memset ( &AviParams , 0 , sizeof ( AviParams ) );
 
 	AviParams.VideoCodec = VideoCodec;
-	AviParams.VideoCodecCompressionLevel = 9;	/* png compression level */
+	AviParams.VideoCodecCompressionLevel = 4;	/* png compression level */
 	AviParams.AudioCodec = AVI_RECORD_AUDIO_CODEC_PCM;
-	AviParams.AudioFreq = ConfigureParams.Sound.nPlaybackFreq;
-	AviParams.Surface = sdlscrn;
+	AviParams.AudioFreq = AUDIO_OUT_FREQUENCY;
+	AviParams.Width = Width;
+	AviParams.Height = Height;
 
-    /* Some video players (quicktime, ...) don't support a value of Fps_scale */
-    /* above 100000. So we decrease the precision from << 24 to << 16 for Fps and Fps_scale */
-    AviParams.Fps = Fps >> 8;			/* refresh rate << 16 */
-    AviParams.Fps_scale = Fps_scale >> 8;		/* 1 << 16 */
+	AviParams.Fps = Fps << 16;			/* refresh rate << 16 */
+	AviParams.Fps_scale = 1 << 16;			/* 1 << 16 */
 
-	if ( !CropGui )					/* Keep gui's status bar */
+	if ( !Avi_StartRecording_WithParams ( &AviParams , FileName ) )
 	{
-		AviParams.CropLeft = 0;
-		AviParams.CropRight = 0;
-		AviParams.CropTop = 0;
-		AviParams.CropBottom = 0;
-	}
-	else						/* Record only the content of the Atari's screen */
-	{
-		AviParams.CropLeft = 0;
-		AviParams.CropRight = 0;
-		AviParams.CropTop = 0;
-		AviParams.CropBottom = Statusbar_GetHeight();
+		if ( AviParams.FileOut )
+			fclose ( AviParams.FileOut );
+		Avi_FreeBuffers ( &AviParams );
+		return false;
 	}
-	
-	if (Avi_StartRecording_WithParams ( &AviParams , FileName ))
-    {
-        Main_SetTitle("00:00");
-        return true;
-    }
-    return false;
+	return true;
 }
 
 
 bool	Avi_StopRecording ( void )
 {
-    if (Avi_StopRecording_WithParams ( &AviParams ))
-    {
-        Main_SetTitle(NULL);
-        return true;
-    }
-    return false;
+	return Avi_StopRecording_WithParams ( &AviParams );
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Start or stop recording the NeXT screen according to the configuration.
+ */
+void	Avi_Init ( void )
+{
+	int	Width , Height;
+
+	if ( ConfigureParams.Screen.bAviRecord && !bRecordingAvi )
+	{
+#if HAVE_LIBPNG
+		int	Codec = AVI_RECORD_VIDEO_CODEC_PNG;
+#else
+		int	Codec = AVI_RECORD_VIDEO_CODEC_BMP;
+#endif
+		Screen_GetFrameSize ( &Width , &Height );
+		if ( !Avi_StartRecording ( ConfigureParams.Screen.szAviRecordFile , Width , Height , AVI_RECORD_FPS , Codec ) )
+			ConfigureParams.Screen.bAviRecord = false;
+	}
+}
+
+
+void	Avi_UnInit ( void )
+{
+	Avi_StopRecording ();
+}
@@ -0,0 +1,294 @@
+/*
+  Previous - bench.c
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+
+  Whole system benchmark. The machine runs in cycle-time mode without
+  being throttled to real time until a guest visible marker is reached:
+  a framebuffer checksum or any debugger breakpoint condition. Then wall
+  time, emulated cycles, instructions per CPU and CycInt event counts are
+  written as JSON and the emulator quits. See the bench target in
+  CMakeLists.txt for running it headless.
+
+  Testing builds also have benchmarks of single subsystems that are run
+  on demand with the debugger "bench" command.
+*/
+
+#include "main.h"
+#include "configuration.h"
+#include "cycInt.h"
+#include "log.h"
+#include "m68000.h"
+#include "dimension.h"
+#include "dsp_cpu.h"
+#include "breakcond.h"
+#include "ioMem.h"
+#include "enet_slirp.h"
+#include "bench.h"
+
+#define BENCH_FB_INTERVAL   16      /* check framebuffer every n VBLs */
+#define BENCH_SCRN_WIDTH    1120
+#define BENCH_SCRN_HEIGHT   832
+
+static bool    bench_active;
+static char    bench_output[FILENAME_MAX];
+static bool    bench_fb_stop;
+static Uint32  bench_fb_checksum;
+static double  bench_timeout = 600; /* emulated seconds */
+static int     bench_vbls;
+
+/* Counters at reset */
+static Uint64  bench_perf_start;
+static Uint64  bench_m68k_start;
+static Uint64  bench_dsp_start;
+static Uint64  bench_i860_start;
+
+
+bool Bench_Active(void)
+{
+	return bench_active;
+}
+
+/* Benchmarks are only comparable in cycle-time mode without prompts */
+static void Bench_ForceSettings(void)
+{
+	ConfigureParams.System.bRealtime = false;
+	ConfigureParams.Log.bConfirmQuit = false;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Enable benchmark mode, the report is written to path ("-" for stdout).
+ * Returns an error string or NULL.
+ */
+const char *Bench_SetOutput(const char *path)
+{
+	if (strlen(path) >= sizeof(bench_output))
+		return "Path is too long";
+
+	strcpy(bench_output, path);
+	bench_active = true;
+	Bench_ForceSettings();
+	return NULL;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Set the marker that ends the benchmark: "fb=<checksum>" for a framebuffer
+ * checksum (as printed in a previous report) or a CPU breakpoint condition.
+ */
+const char *Bench_SetStop(const char *marker)
+{
+	char *end;
+
+	if (!strncmp(marker, "fb=", 3)) {
+		bench_fb_checksum = strtoul(marker + 3, &end, 16);
+		if (end == marker + 3 || *end)
+			return "Invalid framebuffer checksum";
+		bench_fb_stop = true;
+		return NULL;
+	}
+	if (!BreakCond_Command(marker, false))
+		return "Invalid breakpoint condition";
+	return NULL;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Set the emulated time after which the benchmark is stopped anyway.
+ */
+const char *Bench_SetTimeout(const char *seconds)
+{
+	char *end;
+
+	bench_timeout = strtod(seconds, &end);
+	if (end == seconds || *end || bench_timeout <= 0)
+		return "Invalid timeout";
+	return NULL;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Start measuring. Called on reset, so a benchmark covers the last boot.
+ */
+void Bench_Reset(void)
+{
+	if (!bench_active)
+		return;
+
+	Bench_ForceSettings();
+	bench_vbls       = 0;
+	bench_perf_start = SDL_GetPerformanceCounter();
+	bench_m68k_start = m68k_insn_count;
+	bench_dsp_start  = dsp56k_insn_count;
+	bench_i860_start = ConfigureParams.Dimension.bEnabled ? nd_insn_count() : 0;
+}
+
+/* FNV-1a over the visible part of the main framebuffer, word by word */
+static Uint32 Bench_Checksum(void)
+{
+	const Uint8 *fb;
+	int pitch, width, x, y;
+	Uint32 hash = 2166136261u, w;
+
+	if (ConfigureParams.System.bColor) {
+		fb    = NEXTColorVideo;
+		width = BENCH_SCRN_WIDTH * 2;
+		pitch = (BENCH_SCRN_WIDTH + (ConfigureParams.System.bTurbo ? 0 : 32)) * 2;
+	} else {
+		fb    = NEXTVideo;
+		width = BENCH_SCRN_WIDTH / 4;
+		pitch = (BENCH_SCRN_WIDTH + (ConfigureParams.System.bTurbo ? 0 : 32)) / 4;
+	}
+	for (y = 0; y < BENCH_SCRN_HEIGHT; y++, fb += pitch) {
+		for (x = 0; x < width; x += 4) {
+			memcpy(&w, fb + x, 4);
+			hash = (hash ^ w) * 16777619u;
+		}
+	}
+	return hash;
+}
+
+static void Bench_PrintCpu(FILE *fp, const char *name, Uint64 insns, double wall, bool last)
+{
+	fprintf(fp, "    \"%s\": { \"instructions\": %llu, \"mips\": %.2f }%s\n",
+	        name, (unsigned long long)insns, wall > 0 ? insns / wall / 1e6 : 0, last ? "" : ",");
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Write the report and quit.
+ */
+void Bench_Finish(const char *reason)
+{
+	FILE   *fp;
+	double  wall, emulated;
+	Uint64  i860;
+	int     i;
+
+	if (!bench_active)
+		return;
+	bench_active = false;
+
+	wall     = (double)(SDL_GetPerformanceCounter() - bench_perf_start) / SDL_GetPerformanceFrequency();
+	emulated = (double)nCyclesMainCounter / (ConfigureParams.System.nCpuFreq * 1e6);
+	i860     = ConfigureParams.Dimension.bEnabled ? nd_insn_count() - bench_i860_start : 0;
+
+	fp = strcmp(bench_output, "-") ? fopen(bench_output, "w") : stdout;
+	if (!fp) {
+		Log_Printf(LOG_ERROR, "[Bench] Cannot write report to %s", bench_output);
+		fp = stdout;
+	}
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"reason\": \"%s\",\n", reason);
+	fprintf(fp, "  \"cpu_mhz\": %d,\n", ConfigureParams.System.nCpuFreq);
+	fprintf(fp, "  \"wall_seconds\": %.3f,\n", wall);
+	fprintf(fp, "  \"emulated_seconds\": %.3f,\n", emulated);
+	fprintf(fp, "  \"speed\": %.3f,\n", wall > 0 ? emulated / wall : 0);
+	fprintf(fp, "  \"cycles\": %lld,\n", (long long)nCyclesMainCounter);
+	fprintf(fp, "  \"framebuffer\": \"%08x\",\n", Bench_Checksum());
+	fprintf(fp, "  \"cpus\": {\n");
+	Bench_PrintCpu(fp, "m68k", m68k_insn_count - bench_m68k_start, wall, false);
+	Bench_PrintCpu(fp, "dsp", dsp56k_insn_count - bench_dsp_start, wall, false);
+	Bench_PrintCpu(fp, "i860", i860, wall, true);
+	fprintf(fp, "  },\n");
+	fprintf(fp, "  \"events\": {\n");
+	for (i = INTERRUPT_NULL + 1; i < MAX_INTERRUPTS; i++) {
+		fprintf(fp, "    \"%s\": %llu%s\n", CycInt_Name(i), (unsigned long long)CycInt_Count(i),
+		        i + 1 < MAX_INTERRUPTS ? "," : "");
+	}
+	fprintf(fp, "  }\n");
+	fprintf(fp, "}\n");
+
+	if (fp != stdout)
+		fclose(fp);
+
+	bQuitProgram = true;
+	M68000_SetSpecial(SPCFLAG_BRK);
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Called on every main display VBL to check the stop markers.
+ */
+void Bench_VBL(void)
+{
+	if (!bench_active)
+		return;
+
+	if (nCyclesMainCounter >= bench_timeout * ConfigureParams.System.nCpuFreq * 1e6) {
+		Bench_Finish("timeout");
+	} else if (bench_fb_stop && ++bench_vbls >= BENCH_FB_INTERVAL) {
+		bench_vbls = 0;
+		if (Bench_Checksum() == bench_fb_checksum)
+			Bench_Finish("framebuffer");
+	}
+}
+
+
+#if ENABLE_TESTING
+/* Subsystem benchmarks, each checks its fast path against the reference
+ * implementation and writes the results to the log */
+static const struct {
+	const char *name;
+	const char *info;
+	void (*run)(void);
+} bench_tests[] = {
+	{ "fpu",     "cached and host FPU transcendentals against softfloat", fpu_host_math_bench },
+	{ "i860fpu", "i860 host FPU fast path against softfloat",            nd_i860_fpu_bench },
+	{ "i860pix", "i860 pixel and Z-buffer handlers against the reference", nd_i860_pixel_bench },
+	{ "iomem",   "native long word I/O register handlers against byte ones", IoMem_Bench },
+	{ "slirp",   "SLiRP loopback throughput with fragmented pings",       enet_slirp_bench },
+};
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Run the named subsystem benchmark. Returns false if there's none.
+ */
+bool Bench_Test(const char *name)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAYSIZE(bench_tests); i++) {
+		if (!strcasecmp(name, bench_tests[i].name)) {
+			bench_tests[i].run();
+			return true;
+		}
+	}
+	return false;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * List the subsystem benchmarks.
+ */
+void Bench_ListTests(FILE *fp)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAYSIZE(bench_tests); i++)
+		fprintf(fp, "  %-8s %s\n", bench_tests[i].name, bench_tests[i].info);
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Readline match callback for the benchmark names.
+ */
+char *Bench_MatchTest(const char *text, int state)
+{
+	static unsigned int i, len;
+
+	if (!state) {
+		len = strlen(text);
+		i = 0;
+	}
+	while (i < ARRAYSIZE(bench_tests)) {
+		const char *name = bench_tests[i++].name;
+		if (!strncasecmp(name, text, len))
+			return strdup(name);
+	}
+	return NULL;
+}
+#endif /* ENABLE_TESTING */
@@ -0,0 +1,728 @@
+/*
+  Previous - cimage.c
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+
+  Chunked compressed disk images.
+
+  The image is split into fixed size chunks which are compressed one by one
+  with zlib, so that any sector can be read without decompressing the rest
+  of the image. Chunks containing only zeroes are not stored at all. The file
+  layout is (all values little endian):
+
+    header  : magic "PRVCIMG\0", version, chunk shift, image size, chunk count
+    index   : chunk count entries of { 64 bit offset, 32 bit length, flags }
+    chunks  : zlib streams or raw chunks (length == chunk size)
+
+  An offset of 0 marks a chunk of zeroes. Decompressed chunks are kept in a
+  small LRU cache per image. Written chunks stay in the cache until they are
+  evicted or the image is closed, then they are compressed again and stored
+  in place if they fit the space they had or moved to free space otherwise.
+  Space left by moved or zeroed chunks is kept in a list of free extents,
+  which is rebuilt from the gaps between the chunks when an image is opened.
+
+  Images are attached to the FILE pointer returned by File_Open, so that the
+  disk backends using File_Read and File_Write need no changes.
+*/
+const char CImage_fileid[] = "Previous cimage.c : " __DATE__ " " __TIME__;
+
+#include <errno.h>
+#include <zlib.h>
+
+#include "main.h"
+#include "cimage.h"
+
+#define CIMAGE_MAGIC       "PRVCIMG"
+#define CIMAGE_VERSION     1
+#define CIMAGE_HEADER_SIZE 32
+#define CIMAGE_ENTRY_SIZE  16
+#define CIMAGE_MAX_OPEN    16
+
+typedef struct {
+	Uint64 offset;
+	Uint32 length;
+	Uint32 capacity;             /* space reserved in file, >= length */
+} cimage_entry_t;
+
+typedef struct {
+	Uint64 offset;
+	Uint64 length;
+} cimage_extent_t;
+
+typedef struct {
+	Uint8  *data;
+	Uint32 chunk;
+	Uint32 stamp;
+	bool   valid;
+	bool   dirty;
+} cimage_slot_t;
+
+struct cimage_s {
+	FILE           *fp;
+	bool           writable;
+	Uint32         chunksize;
+	Uint32         nchunks;
+	Uint64         size;
+	Uint64         end;          /* end of chunk data in file */
+	cimage_entry_t *index;
+	cimage_extent_t *freelist;   /* unused space before end, by offset */
+	int            nfree;
+	int            maxfree;
+	Sint16         *lookup;      /* chunk -> cache slot or -1 */
+	cimage_slot_t  cache[CIMAGE_CACHE_CHUNKS];
+	Uint32         clock;
+	Uint8          *zbuf;        /* compressed chunk buffer */
+	uLong          zbufsize;
+};
+
+static cimage_t *images[CIMAGE_MAX_OPEN];
+
+
+static void put_le32(Uint8 *p, Uint32 v) {
+	p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static void put_le64(Uint8 *p, Uint64 v) {
+	put_le32(p, (Uint32)v);
+	put_le32(p + 4, (Uint32)(v >> 32));
+}
+
+static Uint32 get_le32(const Uint8 *p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((Uint32)p[3] << 24);
+}
+
+static Uint64 get_le64(const Uint8 *p) {
+	return get_le32(p) | ((Uint64)get_le32(p + 4) << 32);
+}
+
+static bool is_zero(const Uint8 *p, Uint32 size) {
+	Uint32 i;
+	for (i = 0; i < size; i++) {
+		if (p[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Check if the file is a compressed image and return its uncompressed size.
+ * The file position is left undefined.
+ */
+bool CImage_Probe(FILE *fp, Uint64 *size)
+{
+	Uint8 hdr[CIMAGE_HEADER_SIZE];
+
+	if (!fp || fseeko(fp, 0, SEEK_SET) || fread(hdr, sizeof(hdr), 1, fp) != 1)
+		return false;
+	if (memcmp(hdr, CIMAGE_MAGIC, 8) || get_le32(hdr + 8) != CIMAGE_VERSION)
+		return false;
+	if (size)
+		*size = get_le64(hdr + 16);
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Store one index entry in memory and in the file.
+ */
+static bool CImage_SetEntry(cimage_t *img, Uint32 chunk, Uint64 offset, Uint32 length)
+{
+	Uint8 e[CIMAGE_ENTRY_SIZE];
+
+	img->index[chunk].offset = offset;
+	img->index[chunk].length = length;
+
+	memset(e, 0, sizeof(e));
+	put_le64(e, offset);
+	put_le32(e + 8, length);
+	if (fseeko(img->fp, CIMAGE_HEADER_SIZE + (Uint64)chunk * CIMAGE_ENTRY_SIZE, SEEK_SET) ||
+	    fwrite(e, sizeof(e), 1, img->fp) != 1) {
+		fprintf(stderr, "Compressed image: index update failed:\n  %s\n", strerror(errno));
+		return false;
+	}
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return space of a chunk to the free list, merging it with its neighbours.
+ * Space at the end of the chunk data shortens it instead.
+ */
+static void CImage_Release(cimage_t *img, Uint64 offset, Uint64 length)
+{
+	cimage_extent_t *f = img->freelist;
+	int i, n;
+
+	if (!length)
+		return;
+
+	for (i = 0; i < img->nfree && f[i].offset < offset; i++)
+		;
+	if (i > 0 && f[i-1].offset + f[i-1].length == offset) {
+		/* extend the previous extent */
+		i--;
+		f[i].length += length;
+	} else {
+		if (img->nfree == img->maxfree) {
+			n = img->maxfree ? 2 * img->maxfree : 64;
+			f = realloc(img->freelist, sizeof(cimage_extent_t) * n);
+			if (!f)
+				return;  /* the space is lost until the image is opened again */
+			img->freelist = f;
+			img->maxfree  = n;
+		}
+		memmove(&f[i+1], &f[i], sizeof(cimage_extent_t) * (img->nfree - i));
+		f[i].offset = offset;
+		f[i].length = length;
+		img->nfree++;
+	}
+	if (i + 1 < img->nfree && f[i].offset + f[i].length == f[i+1].offset) {
+		/* merge with the next extent */
+		f[i].length += f[i+1].length;
+		img->nfree--;
+		memmove(&f[i+1], &f[i+2], sizeof(cimage_extent_t) * (img->nfree - i - 1));
+	}
+	if (i == img->nfree - 1 && f[i].offset + f[i].length == img->end) {
+		img->end = f[i].offset;
+		img->nfree--;
+	}
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Find space for a chunk of given length, the first free extent that is
+ * large enough or the end of the chunk data.
+ */
+static Uint64 CImage_Allocate(cimage_t *img, Uint32 length)
+{
+	cimage_extent_t *f = img->freelist;
+	Uint64 pos;
+	int i;
+
+	for (i = 0; i < img->nfree; i++) {
+		if (f[i].length >= length) {
+			pos = f[i].offset;
+			f[i].offset += length;
+			f[i].length -= length;
+			if (!f[i].length) {
+				img->nfree--;
+				memmove(&f[i], &f[i+1], sizeof(cimage_extent_t) * (img->nfree - i));
+			}
+			return pos;
+		}
+	}
+	pos = img->end;
+	img->end += length;
+	return pos;
+}
+
+static int CImage_CompareEntries(const void *a, const void *b)
+{
+	const cimage_entry_t *ea = *(cimage_entry_t * const *)a;
+	const cimage_entry_t *eb = *(cimage_entry_t * const *)b;
+
+	return ea->offset < eb->offset ? -1 : ea->offset > eb->offset;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Build the free list from the gaps between the stored chunks.
+ */
+static bool CImage_FindFreeSpace(cimage_t *img)
+{
+	cimage_entry_t **sorted;
+	Uint64 pos;
+	Uint32 i, n = 0;
+
+	sorted = malloc(sizeof(cimage_entry_t *) * (img->nchunks + 1));
+	if (!sorted)
+		return false;
+	for (i = 0; i < img->nchunks; i++) {
+		if (img->index[i].offset)
+			sorted[n++] = &img->index[i];
+	}
+	qsort(sorted, n, sizeof(cimage_entry_t *), CImage_CompareEntries);
+
+	pos = CIMAGE_HEADER_SIZE + (Uint64)img->nchunks * CIMAGE_ENTRY_SIZE;
+	for (i = 0; i < n; i++) {
+		if (sorted[i]->offset < pos) {
+			free(sorted);
+			return false;  /* overlapping chunks */
+		}
+		CImage_Release(img, pos, sorted[i]->offset - pos);
+		pos = sorted[i]->offset + sorted[i]->length;
+	}
+	free(sorted);
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Compress a cache slot and store it in the file.
+ */
+static bool CImage_WriteBack(cimage_t *img, cimage_slot_t *slot)
+{
+	cimage_entry_t *e = &img->index[slot->chunk];
+	uLong  zlen = img->zbufsize;
+	Uint8  *src;
+	Uint32 len;
+	Uint64 pos;
+
+	slot->dirty = false;
+
+	if (is_zero(slot->data, img->chunksize)) {
+		if (!e->offset)
+			return true;
+		CImage_Release(img, e->offset, e->capacity);
+		e->capacity = 0;
+		return CImage_SetEntry(img, slot->chunk, 0, 0);
+	}
+
+	if (compress2(img->zbuf, &zlen, slot->data, img->chunksize, Z_BEST_SPEED) == Z_OK &&
+	    zlen < img->chunksize) {
+		src = img->zbuf;
+		len = zlen;
+	} else {
+		src = slot->data;
+		len = img->chunksize;
+	}
+
+	/* Reuse the old location if the chunk still fits */
+	if (e->offset && len <= e->capacity) {
+		pos = e->offset;
+	} else {
+		pos = CImage_Allocate(img, len);
+	}
+	if (fseeko(img->fp, pos, SEEK_SET) || fwrite(src, len, 1, img->fp) != 1) {
+		fprintf(stderr, "Compressed image: chunk write failed:\n  %s\n", strerror(errno));
+		return false;
+	}
+	if (pos != e->offset) {
+		/* the old copy is only released once the new one is written */
+		CImage_Release(img, e->offset, e->capacity);
+		e->capacity = len;
+	}
+	return CImage_SetEntry(img, slot->chunk, pos, len);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return decompressed data of a chunk, loading it into the cache if needed.
+ */
+static Uint8 *CImage_GetChunk(cimage_t *img, Uint32 chunk)
+{
+	cimage_entry_t *e;
+	cimage_slot_t  *slot;
+	uLong  dlen;
+	int    i, victim;
+
+	i = img->lookup[chunk];
+	if (i >= 0) {
+		img->cache[i].stamp = ++img->clock;
+		return img->cache[i].data;
+	}
+
+	/* Pick a free or the least recently used slot */
+	victim = 0;
+	for (i = 0; i < CIMAGE_CACHE_CHUNKS; i++) {
+		if (!img->cache[i].valid) {
+			victim = i;
+			break;
+		}
+		if (img->cache[i].stamp < img->cache[victim].stamp)
+			victim = i;
+	}
+	slot = &img->cache[victim];
+	if (slot->valid) {
+		if (slot->dirty && !CImage_WriteBack(img, slot))
+			return NULL;
+		img->lookup[slot->chunk] = -1;
+		slot->valid = false;
+	}
+
+	e = &img->index[chunk];
+	if (e->offset == 0) {
+		memset(slot->data, 0, img->chunksize);
+	} else {
+		if (e->length > img->zbufsize ||
+		    fseeko(img->fp, e->offset, SEEK_SET) ||
+		    fread(img->zbuf, e->length, 1, img->fp) != 1) {
+			fprintf(stderr, "Compressed image: chunk %u read failed.\n", chunk);
+			return NULL;
+		}
+		if (e->length == img->chunksize) {
+			memcpy(slot->data, img->zbuf, img->chunksize);
+		} else {
+			dlen = img->chunksize;
+			if (uncompress(slot->data, &dlen, img->zbuf, e->length) != Z_OK ||
+			    dlen != img->chunksize) {
+				fprintf(stderr, "Compressed image: chunk %u is corrupt.\n", chunk);
+				return NULL;
+			}
+		}
+	}
+	slot->chunk = chunk;
+	slot->valid = true;
+	slot->dirty = false;
+	slot->stamp = ++img->clock;
+	img->lookup[chunk] = victim;
+	return slot->data;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Read data at given offset of the uncompressed image.
+ */
+bool CImage_Read(cimage_t *img, Uint8 *data, Uint32 size, Uint64 offset)
+{
+	Uint8  *chunk;
+	Uint32 pos, len;
+
+	if (offset + size > img->size) {
+		fprintf(stderr, "Error occured while reading file.\n");
+		return false;
+	}
+	while (size) {
+		pos = offset & (img->chunksize - 1);
+		len = img->chunksize - pos;
+		if (len > size)
+			len = size;
+		chunk = CImage_GetChunk(img, offset / img->chunksize);
+		if (!chunk)
+			return false;
+		memcpy(data, chunk + pos, len);
+		data   += len;
+		offset += len;
+		size   -= len;
+	}
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Write data at given offset of the uncompressed image.
+ */
+bool CImage_Write(cimage_t *img, Uint8 *data, Uint32 size, Uint64 offset)
+{
+	Uint8  *chunk;
+	Uint32 pos, len;
+
+	if (!img->writable || offset + size > img->size) {
+		fprintf(stderr, "Error occured while writing file.\n");
+		return false;
+	}
+	while (size) {
+		pos = offset & (img->chunksize - 1);
+		len = img->chunksize - pos;
+		if (len > size)
+			len = size;
+		chunk = CImage_GetChunk(img, offset / img->chunksize);
+		if (!chunk)
+			return false;
+		memcpy(chunk + pos, data, len);
+		img->cache[img->lookup[offset / img->chunksize]].dirty = true;
+		data   += len;
+		offset += len;
+		size   -= len;
+	}
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Write all modified chunks back to the file.
+ */
+bool CImage_Flush(cimage_t *img)
+{
+	bool ok = true;
+	int  i;
+
+	for (i = 0; i < CIMAGE_CACHE_CHUNKS; i++) {
+		if (img->cache[i].valid && img->cache[i].dirty)
+			ok &= CImage_WriteBack(img, &img->cache[i]);
+	}
+	fflush(img->fp);
+	return ok;
+}
+
+
+static void CImage_Free(cimage_t *img)
+{
+	int i;
+
+	for (i = 0; i < CIMAGE_CACHE_CHUNKS; i++)
+		free(img->cache[i].data);
+	free(img->index);
+	free(img->freelist);
+	free(img->lookup);
+	free(img->zbuf);
+	free(img);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Read the header and index of a compressed image opened as fp and register
+ * it for File_Read/File_Write. Return NULL if it is not a valid image.
+ */
+cimage_t *CImage_Attach(FILE *fp, bool writable)
+{
+	Uint8    hdr[CIMAGE_HEADER_SIZE];
+	Uint8    e[CIMAGE_ENTRY_SIZE];
+	cimage_t *img;
+	Uint32   shift, i;
+	int      n;
+
+	for (n = 0; n < CIMAGE_MAX_OPEN && images[n]; n++)
+		;
+	if (n == CIMAGE_MAX_OPEN) {
+		fprintf(stderr, "Compressed image: too many open images.\n");
+		return NULL;
+	}
+
+	if (fseeko(fp, 0, SEEK_SET) || fread(hdr, sizeof(hdr), 1, fp) != 1 ||
+	    memcmp(hdr, CIMAGE_MAGIC, 8) || get_le32(hdr + 8) != CIMAGE_VERSION)
+		return NULL;
+	shift = get_le32(hdr + 12);
+	if (shift < 9 || shift > 24) {
+		fprintf(stderr, "Compressed image: invalid chunk size.\n");
+		return NULL;
+	}
+
+	img = calloc(1, sizeof(cimage_t));
+	if (!img)
+		return NULL;
+	img->fp        = fp;
+	img->writable  = writable;
+	img->chunksize = 1 << shift;
+	img->size      = get_le64(hdr + 16);
+	img->nchunks   = get_le32(hdr + 24);
+	img->end       = CIMAGE_HEADER_SIZE + (Uint64)img->nchunks * CIMAGE_ENTRY_SIZE;
+	img->zbufsize  = compressBound(img->chunksize);
+
+	if (img->nchunks != (img->size + img->chunksize - 1) >> shift ||
+	    img->nchunks > 0x7FFFFFFF / CIMAGE_ENTRY_SIZE) {
+		fprintf(stderr, "Compressed image: invalid header.\n");
+		CImage_Free(img);
+		return NULL;
+	}
+
+	img->index  = malloc(sizeof(cimage_entry_t) * (img->nchunks + 1));
+	img->lookup = malloc(sizeof(Sint16) * (img->nchunks + 1));
+	img->zbuf   = malloc(img->zbufsize);
+	for (i = 0; i < CIMAGE_CACHE_CHUNKS; i++) {
+		img->cache[i].data = malloc(img->chunksize);
+		if (!img->cache[i].data)
+			break;
+	}
+	if (!img->index || !img->lookup || !img->zbuf || i < CIMAGE_CACHE_CHUNKS) {
+		fprintf(stderr, "Compressed image: out of memory.\n");
+		CImage_Free(img);
+		return NULL;
+	}
+
+	for (i = 0; i < img->nchunks; i++) {
+		if (fread(e, sizeof(e), 1, fp) != 1) {
+			fprintf(stderr, "Compressed image: index is truncated.\n");
+			CImage_Free(img);
+			return NULL;
+		}
+		img->index[i].offset   = get_le64(e);
+		img->index[i].length   = get_le32(e + 8);
+		img->index[i].capacity = img->index[i].length;
+		img->lookup[i]         = -1;
+		if (img->index[i].offset + img->index[i].length > img->end)
+			img->end = img->index[i].offset + img->index[i].length;
+	}
+	if (writable && !CImage_FindFreeSpace(img)) {
+		fprintf(stderr, "Compressed image: invalid index.\n");
+		CImage_Free(img);
+		return NULL;
+	}
+
+	images[n] = img;
+	return img;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return the compressed image attached to fp or NULL for plain files.
+ */
+cimage_t *CImage_Find(FILE *fp)
+{
+	int i;
+
+	for (i = 0; i < CIMAGE_MAX_OPEN; i++) {
+		if (images[i] && images[i]->fp == fp)
+			return images[i];
+	}
+	return NULL;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Write back and release the compressed image attached to fp, if any.
+ */
+void CImage_Detach(FILE *fp)
+{
+	int i;
+
+	for (i = 0; i < CIMAGE_MAX_OPEN; i++) {
+		if (images[i] && images[i]->fp == fp) {
+			if (images[i]->writable)
+				CImage_Flush(images[i]);
+			CImage_Free(images[i]);
+			images[i] = NULL;
+		}
+	}
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Convert a raw image to a compressed image with chunks of 1<<chunkshift
+ * bytes.
+ */
+bool CImage_Compress(const char *src, const char *dst, int chunkshift)
+{
+	FILE   *in, *out;
+	Uint8  hdr[CIMAGE_HEADER_SIZE];
+	Uint8  e[CIMAGE_ENTRY_SIZE];
+	Uint8  *buf, *zbuf;
+	Uint32 chunksize = 1 << chunkshift;
+	Uint32 nchunks, i, len;
+	uLong  zlen, zbufsize = compressBound(chunksize);
+	Uint64 size, pos;
+	bool   ok = false;
+
+	if (chunkshift < 9 || chunkshift > 24)
+		return false;
+
+	in = fopen(src, "rb");
+	if (!in) {
+		fprintf(stderr, "Can't open file '%s':\n  %s\n", src, strerror(errno));
+		return false;
+	}
+	out = fopen(dst, "wb");
+	if (!out) {
+		fprintf(stderr, "Can't open file '%s':\n  %s\n", dst, strerror(errno));
+		fclose(in);
+		return false;
+	}
+	fseeko(in, 0, SEEK_END);
+	size = ftello(in);
+	fseeko(in, 0, SEEK_SET);
+	nchunks = (size + chunksize - 1) >> chunkshift;
+
+	buf  = malloc(chunksize);
+	zbuf = malloc(zbufsize);
+	if (!buf || !zbuf)
+		goto done;
+
+	memset(hdr, 0, sizeof(hdr));
+	memcpy(hdr, CIMAGE_MAGIC, 8);
+	put_le32(hdr + 8, CIMAGE_VERSION);
+	put_le32(hdr + 12, chunkshift);
+	put_le64(hdr + 16, size);
+	put_le32(hdr + 24, nchunks);
+	if (fwrite(hdr, sizeof(hdr), 1, out) != 1)
+		goto done;
+
+	pos = CIMAGE_HEADER_SIZE + (Uint64)nchunks * CIMAGE_ENTRY_SIZE;
+	for (i = 0; i < nchunks; i++) {
+		memset(buf, 0, chunksize);
+		if (fread(buf, 1, chunksize, in) == 0 && ferror(in))
+			goto done;
+
+		memset(e, 0, sizeof(e));
+		if (!is_zero(buf, chunksize)) {
+			zlen = zbufsize;
+			if (compress2(zbuf, &zlen, buf, chunksize, Z_BEST_COMPRESSION) == Z_OK && zlen < chunksize) {
+				len = zlen;
+			} else {
+				memcpy(zbuf, buf, chunksize);
+				len = chunksize;
+			}
+			if (fseeko(out, pos, SEEK_SET) || fwrite(zbuf, len, 1, out) != 1)
+				goto done;
+			put_le64(e, pos);
+			put_le32(e + 8, len);
+			pos += len;
+		}
+		if (fseeko(out, CIMAGE_HEADER_SIZE + (Uint64)i * CIMAGE_ENTRY_SIZE, SEEK_SET) ||
+		    fwrite(e, sizeof(e), 1, out) != 1)
+			goto done;
+	}
+	ok = true;
+
+done:
+	if (!ok)
+		fprintf(stderr, "Error occured while compressing '%s'.\n", src);
+	free(buf);
+	free(zbuf);
+	fclose(in);
+	if (fclose(out))
+		ok = false;
+	return ok;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Convert a compressed image back to a raw image.
+ */
+bool CImage_Decompress(const char *src, const char *dst)
+{
+	FILE     *in, *out;
+	cimage_t *img;
+	Uint8    *buf;
+	Uint64   pos;
+	Uint32   len;
+	bool     ok = true;
+
+	in = fopen(src, "rb");
+	if (!in) {
+		fprintf(stderr, "Can't open file '%s':\n  %s\n", src, strerror(errno));
+		return false;
+	}
+	img = CImage_Attach(in, false);
+	if (!img) {
+		fprintf(stderr, "'%s' is not a compressed image.\n", src);
+		fclose(in);
+		return false;
+	}
+	out = fopen(dst, "wb");
+	if (!out) {
+		fprintf(stderr, "Can't open file '%s':\n  %s\n", dst, strerror(errno));
+		CImage_Detach(in);
+		fclose(in);
+		return false;
+	}
+
+	buf = malloc(img->chunksize);
+	if (!buf)
+		ok = false;
+	for (pos = 0; ok && pos < img->size; pos += len) {
+		len = img->size - pos < img->chunksize ? img->size - pos : img->chunksize;
+		ok = CImage_Read(img, buf, len, pos) && fwrite(buf, len, 1, out) == 1;
+	}
+	free(buf);
+	CImage_Detach(in);
+	fclose(in);
+	if (fclose(out))
+		ok = false;
+	return ok;
+}
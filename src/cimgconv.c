@@ -0,0 +1,112 @@
+/*
+  Previous - cimgconv.c
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+
+  Convert disk images to and from the chunked compressed image format and
+  compare read throughput of a compressed image with its raw original.
+
+  usage: cimgconv -c <raw> <compressed> [chunk shift]
+         cimgconv -d <compressed> <raw>
+         cimgconv -b <raw> <compressed>
+*/
+#define SDL_MAIN_HANDLED
+
+#include "main.h"
+#include "cimage.h"
+
+#define BENCH_BLOCKSIZE 1024    /* SCSI block size */
+#define BENCH_RANDOM    65536   /* number of random block reads */
+
+
+/* Elapsed wall time, the reads are mostly waiting for I/O */
+static double bench_time(void)
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	return (double)now / SDL_GetPerformanceFrequency();
+}
+
+static bool bench_read(FILE *fp, cimage_t *img, Uint8 *buf, Uint64 off)
+{
+	if (img)
+		return CImage_Read(img, buf, BENCH_BLOCKSIZE, off);
+	return !fseeko(fp, off, SEEK_SET) && fread(buf, BENCH_BLOCKSIZE, 1, fp) == 1;
+}
+
+/* Read the image sequentially and at random block offsets */
+static bool bench_image(const char *name, double *seq, double *rnd, Uint64 *filesize)
+{
+	Uint8    buf[BENCH_BLOCKSIZE];
+	FILE     *fp;
+	cimage_t *img = NULL;
+	Uint64   size, off;
+	double   t;
+	int      i;
+
+	fp = fopen(name, "rb");
+	if (!fp)
+		return false;
+	fseeko(fp, 0, SEEK_END);
+	*filesize = size = ftello(fp);
+	if (CImage_Probe(fp, &size))
+		img = CImage_Attach(fp, false);
+	if (size < BENCH_BLOCKSIZE) {
+		fprintf(stderr, "%s: image is smaller than one block\n", name);
+		CImage_Detach(fp);
+		fclose(fp);
+		return false;
+	}
+
+	t = bench_time();
+	for (off = 0; off + BENCH_BLOCKSIZE <= size; off += BENCH_BLOCKSIZE) {
+		if (!bench_read(fp, img, buf, off))
+			break;
+	}
+	*seq = (size / 1048576.0) / (bench_time() - t);
+
+	srand(1);
+	t = bench_time();
+	for (i = 0; i < BENCH_RANDOM; i++) {
+		off = ((Uint64)rand() * RAND_MAX + rand()) % (size / BENCH_BLOCKSIZE);
+		if (!bench_read(fp, img, buf, off * BENCH_BLOCKSIZE))
+			break;
+	}
+	*rnd = (BENCH_RANDOM * (double)BENCH_BLOCKSIZE / 1048576.0) / (bench_time() - t);
+
+	CImage_Detach(fp);
+	fclose(fp);
+	return true;
+}
+
+static int bench(const char *raw, const char *cmp)
+{
+	double seq, rnd;
+	Uint64 rawsize, cmpsize;
+
+	printf("image       sequential MB/s   random MB/s\n");
+	if (!bench_image(raw, &seq, &rnd, &rawsize))
+		return 1;
+	printf("raw         %15.1f %13.1f\n", seq, rnd);
+	if (!bench_image(cmp, &seq, &rnd, &cmpsize))
+		return 1;
+	printf("compressed  %15.1f %13.1f\n", seq, rnd);
+	printf("file size   %.1f MB -> %.1f MB\n", rawsize / 1048576.0, cmpsize / 1048576.0);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc >= 4 && !strcmp(argv[1], "-c"))
+		return !CImage_Compress(argv[2], argv[3], argc > 4 ? atoi(argv[4]) : CIMAGE_CHUNK_SHIFT);
+	if (argc == 4 && !strcmp(argv[1], "-d"))
+		return !CImage_Decompress(argv[2], argv[3]);
+	if (argc == 4 && !strcmp(argv[1], "-b"))
+		return bench(argv[2], argv[3]);
+
+	fprintf(stderr, "usage: %s -c <raw> <compressed> [chunk shift]\n"
+	                "       %s -d <compressed> <raw>\n"
+	                "       %s -b <raw> <compressed>\n", argv[0], argv[0], argv[0]);
+	return 1;
+}
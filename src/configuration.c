@@ -61,6 +61,8 @@ static const struct Config_Tag configs_Screen[] =
 	{ "bFullScreen", Bool_Tag, &ConfigureParams.Screen.bFullScreen },
 	{ "bShowStatusbar", Bool_Tag, &ConfigureParams.Screen.bShowStatusbar },
 	{ "bShowDriveLed", Bool_Tag, &ConfigureParams.Screen.bShowDriveLed },
+	{ "bAviRecord", Bool_Tag, &ConfigureParams.Screen.bAviRecord },
+	{ "szAviRecordFile", String_Tag, ConfigureParams.Screen.szAviRecordFile },
 	{ NULL , Error_Tag, NULL }
 };
 
@@ -137,6 +139,8 @@ static const struct Config_Tag configs_Memory[] =
 	{ "nMemoryBankSize2", Int_Tag, &ConfigureParams.Memory.nMemoryBankSize[2] },
 	{ "nMemoryBankSize3", Int_Tag, &ConfigureParams.Memory.nMemoryBankSize[3] },
     { "nMemorySpeed", Int_Tag, &ConfigureParams.Memory.nMemorySpeed },
+    { "bHugePages", Bool_Tag, &ConfigureParams.Memory.bHugePages },
+    { "bMergePages", Bool_Tag, &ConfigureParams.Memory.bMergePages },
 	{ NULL , Error_Tag, NULL }
 };
 
@@ -234,6 +238,19 @@ static const struct Config_Tag configs_Ethernet[] =
 {
     { "bEthernetConnected", Bool_Tag, &ConfigureParams.Ethernet.bEthernetConnected },
     { "bTwistedPair", Bool_Tag, &ConfigureParams.Ethernet.bTwistedPair },
+    { "nHostInterface", Int_Tag, &ConfigureParams.Ethernet.nHostInterface },
+    { "szSwitchPath", String_Tag, ConfigureParams.Ethernet.szSwitchPath },
+
+    { NULL , Error_Tag, NULL }
+};
+
+/* Used to load/save serial port options */
+static const struct Config_Tag configs_Serial[] =
+{
+    { "nChannelABackend", Int_Tag, &ConfigureParams.Serial.port[0].nBackend },
+    { "szChannelAPath", String_Tag, ConfigureParams.Serial.port[0].szPath },
+    { "nChannelBBackend", Int_Tag, &ConfigureParams.Serial.port[1].nBackend },
+    { "szChannelBPath", String_Tag, ConfigureParams.Serial.port[1].szPath },
 
     { NULL , Error_Tag, NULL }
 };
@@ -251,6 +268,7 @@ static const struct Config_Tag configs_Rom[] =
 static const struct Config_Tag configs_Printer[] =
 {
 	{ "bPrinterConnected", Bool_Tag, &ConfigureParams.Printer.bPrinterConnected },
+	{ "bFastPrint", Bool_Tag, &ConfigureParams.Printer.bFastPrint },
 	{ "nPaperSize", Int_Tag, &ConfigureParams.Printer.nPaperSize },
 	{ "szPrintToFileName", String_Tag, ConfigureParams.Printer.szPrintToFileName },
 	{ NULL , Error_Tag, NULL }
@@ -275,6 +293,7 @@ static const struct Config_Tag configs_System[] =
 	{ "bRealTimeClock", Bool_Tag, &ConfigureParams.System.bRealTimeClock },
     { "n_FPUType", Int_Tag, &ConfigureParams.System.n_FPUType },
     { "bCompatibleFPU", Bool_Tag, &ConfigureParams.System.bCompatibleFPU },
+    { "bFPUHostMath", Bool_Tag, &ConfigureParams.System.bFPUHostMath },
     { "bMMU", Bool_Tag, &ConfigureParams.System.bMMU },
     { NULL , Error_Tag, NULL }
 };
@@ -283,7 +302,9 @@ static const struct Config_Tag configs_System[] =
 static const struct Config_Tag configs_Dimension[] =
 {
     { "bEnabled",         Bool_Tag, &ConfigureParams.Dimension.bEnabled },
+    { "nNumBoards",       Int_Tag,  &ConfigureParams.Dimension.nNumBoards },
     { "bI860Thread",      Bool_Tag, &ConfigureParams.Dimension.bI860Thread },
+    { "bI860HostFPU",     Bool_Tag, &ConfigureParams.Dimension.bI860HostFPU },
 	{ "bMainDisplay",     Bool_Tag, &ConfigureParams.Dimension.bMainDisplay },
     { "nMemoryBankSize0", Int_Tag,  &ConfigureParams.Dimension.nMemoryBankSize[0] },
     { "nMemoryBankSize1", Int_Tag,  &ConfigureParams.Dimension.nMemoryBankSize[1] },
@@ -363,6 +384,16 @@ void Configuration_SetDefault(void)
     /* Set defaults for Ethernet */
     ConfigureParams.Ethernet.bEthernetConnected = false;
     ConfigureParams.Ethernet.bTwistedPair = false;
+    ConfigureParams.Ethernet.nHostInterface = ENET_SLIRP;
+    sprintf(ConfigureParams.Ethernet.szSwitchPath, "%s%cenet_hub",
+            psHomeDir, PATHSEP);
+    
+    /* Set defaults for Serial */
+    for (i = 0; i < 2; i++) {
+        ConfigureParams.Serial.port[i].nBackend = SERIAL_NONE;
+        sprintf(ConfigureParams.Serial.port[i].szPath, "%s%cserial_%c",
+                psHomeDir, PATHSEP, 'a'+i);
+    }
     
 	/* Set defaults for Keyboard */
     ConfigureParams.Keyboard.bSwapCmdAlt = false;
@@ -398,9 +429,12 @@ void Configuration_SetDefault(void)
 	memset(ConfigureParams.Memory.nMemoryBankSize, 16, 
            sizeof(ConfigureParams.Memory.nMemoryBankSize)); /* 64 MiB */
     ConfigureParams.Memory.nMemorySpeed = MEMORY_100NS;
+    ConfigureParams.Memory.bHugePages = false;
+    ConfigureParams.Memory.bMergePages = false;
 
 	/* Set defaults for Printer */
 	ConfigureParams.Printer.bPrinterConnected = false;
+	ConfigureParams.Printer.bFastPrint = false;
 	ConfigureParams.Printer.nPaperSize = PAPER_A4;
 	sprintf(ConfigureParams.Printer.szPrintToFileName, "%s%c",
 	        psHomeDir, PATHSEP);
@@ -410,6 +444,9 @@ void Configuration_SetDefault(void)
 	ConfigureParams.Screen.nMonitorType = MONITOR_TYPE_CPU;
 	ConfigureParams.Screen.bShowStatusbar = true;
 	ConfigureParams.Screen.bShowDriveLed = true;
+	ConfigureParams.Screen.bAviRecord = false;
+	sprintf(ConfigureParams.Screen.szAviRecordFile, "%s%cprevious.avi",
+	        psHomeDir, PATHSEP);
 
 	/* Set defaults for Sound */
     ConfigureParams.Sound.bEnableMicrophone = true;
@@ -441,11 +478,14 @@ void Configuration_SetDefault(void)
 	ConfigureParams.System.bRealTimeClock = true;
     ConfigureParams.System.n_FPUType = FPU_68882;
     ConfigureParams.System.bCompatibleFPU = true;
+    ConfigureParams.System.bFPUHostMath = false;
     ConfigureParams.System.bMMU = true;
     
     /* Set defaults for Dimension */
     ConfigureParams.Dimension.bI860Thread        = host_num_cpus() > 4;
+    ConfigureParams.Dimension.bI860HostFPU       = true;
     ConfigureParams.Dimension.bEnabled           = false;
+    ConfigureParams.Dimension.nNumBoards         = 1;
 	ConfigureParams.Dimension.bMainDisplay       = false;
     ConfigureParams.Dimension.nMemoryBankSize[0] = 4;
     ConfigureParams.Dimension.nMemoryBankSize[1] = 4;
@@ -508,6 +548,9 @@ void Configuration_Apply(bool bReset) {
     
     /* Make sure twisted pair ethernet is disabled on 68030 Cube */
     Configuration_CheckEthernetSettings();
+    
+    /* Make sure serial backends are valid */
+    Configuration_CheckSerialSettings();
 	
 	/* Clean file and directory names */    
     File_MakeAbsoluteName(ConfigureParams.Rom.szRom030FileName);
@@ -520,6 +563,9 @@ void Configuration_Apply(bool bReset) {
     for (i = 0; i < ESP_MAX_DEVS; i++) {
         File_MakeAbsoluteName(ConfigureParams.SCSI.target[i].szImageName);
     }
+    for (i = 0; i < 2; i++) {
+        File_MakeAbsoluteName(ConfigureParams.Serial.port[i].szPath);
+    }
     
     for (i = 0; i < MO_MAX_DRIVES; i++) {
         File_MakeAbsoluteName(ConfigureParams.MO.drive[i].szImageName);
@@ -707,6 +753,11 @@ void Configuration_CheckDimensionSettings(void) {
 		ConfigureParams.Dimension.bEnabled = false;
 		ConfigureParams.Screen.nMonitorType = MONITOR_TYPE_CPU;
 	}
+	if (ConfigureParams.Dimension.nNumBoards < 1) {
+		ConfigureParams.Dimension.nNumBoards = 1;
+	} else if (ConfigureParams.Dimension.nNumBoards > 3) {
+		ConfigureParams.Dimension.nNumBoards = 3;
+	}
 }
 
 void Configuration_CheckEthernetSettings(void) {
@@ -715,6 +766,16 @@ void Configuration_CheckEthernetSettings(void) {
     }
 }
 
+void Configuration_CheckSerialSettings(void) {
+    int i;
+    for (i = 0; i < 2; i++) {
+        if (ConfigureParams.Serial.port[i].nBackend < SERIAL_NONE ||
+            ConfigureParams.Serial.port[i].nBackend > SERIAL_SOCKET) {
+            ConfigureParams.Serial.port[i].nBackend = SERIAL_NONE;
+        }
+    }
+}
+
 
 /*-----------------------------------------------------------------------*/
 /**
@@ -765,6 +826,7 @@ void Configuration_Load(const char *psFileName)
     Configuration_LoadSection(psFileName, configs_MO, "[MagnetoOptical]");
     Configuration_LoadSection(psFileName, configs_Floppy, "[Floppy]");
     Configuration_LoadSection(psFileName, configs_Ethernet, "[Ethernet]");
+    Configuration_LoadSection(psFileName, configs_Serial, "[Serial]");
 	Configuration_LoadSection(psFileName, configs_Rom, "[ROM]");
 	Configuration_LoadSection(psFileName, configs_Printer, "[Printer]");
 	Configuration_LoadSection(psFileName, configs_System, "[System]");
@@ -814,6 +876,7 @@ void Configuration_Save(void)
     Configuration_SaveSection(sConfigFileName, configs_MO, "[MagnetoOptical]");
     Configuration_SaveSection(sConfigFileName, configs_Floppy, "[Floppy]");
     Configuration_SaveSection(sConfigFileName, configs_Ethernet, "[Ethernet]");
+    Configuration_SaveSection(sConfigFileName, configs_Serial, "[Serial]");
 	Configuration_SaveSection(sConfigFileName, configs_Rom, "[ROM]");
 	Configuration_SaveSection(sConfigFileName, configs_Printer, "[Printer]");
 	Configuration_SaveSection(sConfigFileName, configs_System, "[System]");
@@ -5,6 +5,16 @@
   your option any later version. Read the file gpl.txt for details.
 
   This code processes commands from the Hatari control socket
+
+  After "hatari-batch" the socket is in batch mode: commands may span
+  reads, every command is answered with an "OK" or "ERR <reason>" line
+  and the answers to everything read at once are sent in one write.
+  Batch mode also accepts binary transfers of physical RAM:
+    hatari-mem-read <address> <length>
+      answered with "OK <length>" and the raw bytes
+    hatari-mem-write <address> <length>
+      followed by the raw bytes, answered with "OK"
+  Transfers are limited to CONTROL_MAX_XFER bytes per command.
 */
 const char Control_fileid[] = "Hatari control.c : " __DATE__ " " __TIME__;
 
@@ -19,14 +29,17 @@ const char Control_fileid[] = "Hatari control.c : " __DATE__ " " __TIME__;
 #include <sys/time.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <stdarg.h>
 
 #include "main.h"
+#include "avi_record.h"
 #include "change.h"
 #include "configuration.h"
 #include "control.h"
 #include "debugui.h"
 #include "file.h"
 #include "log.h"
+#include "nextMemory.h"
 #include "screen.h"
 #include "shortcut.h"
 #include "str.h"
@@ -41,6 +54,8 @@ typedef enum {
 static bool bSendEmbedInfo;
 /* Pausing triggered remotely (battery save pause) */
 static bool bRemotePaused;
+/* Whether commands are answered and may be binary, see above */
+static bool bBatchMode;
 
 
 /*-----------------------------------------------------------------------*/
@@ -146,6 +161,7 @@ static bool Control_DeviceAction(const char *name, action_t action)
 //		{ "printer", &ConfigureParams.Printer.bEnablePrinting, Printer_Init, Printer_UnInit },
 //		{ "rs232",   &ConfigureParams.RS232.bEnableRS232, RS232_Init, RS232_UnInit },
 //		{ "midi",    &ConfigureParams.Midi.bEnableMidi, Midi_Init, Midi_UnInit },
+		{ "avirecord", &ConfigureParams.Screen.bAviRecord, Avi_Init, Avi_UnInit },
 		{ NULL, NULL, NULL, NULL }
 	};
 	int i;
@@ -196,6 +212,7 @@ static bool Control_SetPath(char *name)
 		const char *name;
 		char *path;
 	} item[] = {
+		{ "avirecord", ConfigureParams.Screen.szAviRecordFile },
 		{ NULL, NULL }
 	};
 	int i;
@@ -245,9 +262,13 @@ static bool Control_Usage(const char *cmd)
 		"- hatari-path <config name> <new path>\n"
 		"- hatari-shortcut <shortcut name>\n"
 		"- hatari-embed-info\n"
+		"- hatari-batch\n"
 		"- hatari-stop\n"
 		"- hatari-cont\n"
 		"The last two can be used to stop and continue the Hatari emulation.\n"
+		"In batch mode also:\n"
+		"- hatari-mem-read <address> <length>\n"
+		"- hatari-mem-write <address> <length>, followed by the data\n"
 		"All commands need to be separated by newlines.\n"
 		);
 	return false;
@@ -255,14 +276,73 @@ static bool Control_Usage(const char *cmd)
 
 /*-----------------------------------------------------------------------*/
 /**
- * Parse Hatari debug/event/option/toggle/path/shortcut command buffer.
- * Given buffer is modified in-place.
+ * Parse and execute a single Hatari debug/event/option/toggle/path/shortcut
+ * command.  Given command is modified in-place.
+ * Return false if parsing or the command failed, true otherwise
  */
-void Control_ProcessBuffer(char *buffer)
+static bool Control_ProcessCommand(char *cmd)
 {
-	char *cmd, *cmdend, *arg;
-	int ok = true;
-	
+	char *arg;
+	bool ok = true;
+
+	/* arguments? */
+	arg = strchr(cmd, ' ');
+	if (arg) {
+		*arg = '\0';
+		arg = Str_Trim(arg+1);
+	}
+	if (arg) {
+		if (strcmp(cmd, "hatari-option") == 0) {
+			ok = Change_ApplyCommandline(arg);
+		} else if (strcmp(cmd, "hatari-debug") == 0) {
+			ok = DebugUI_RemoteParse(arg);
+		} else if (strcmp(cmd, "hatari-shortcut") == 0) {
+			ok = Shortcut_Invoke(arg);
+		} else if (strcmp(cmd, "hatari-event") == 0) {
+			ok = Control_InsertEvent(arg);
+		} else if (strcmp(cmd, "hatari-path") == 0) {
+			ok = Control_SetPath(arg);
+		} else if (strcmp(cmd, "hatari-enable") == 0) {
+			ok = Control_DeviceAction(arg, DO_ENABLE);
+		} else if (strcmp(cmd, "hatari-disable") == 0) {
+			ok = Control_DeviceAction(arg, DO_DISABLE);
+		} else if (strcmp(cmd, "hatari-toggle") == 0) {
+			ok = Control_DeviceAction(arg, DO_TOGGLE);
+		} else {
+			ok = Control_Usage(cmd);
+		}
+	} else {
+		if (strcmp(cmd, "hatari-embed-info") == 0) {
+			fprintf(stderr, "Embedded window ID change messages = ON\n");
+			bSendEmbedInfo = true;
+		} else if (strcmp(cmd, "hatari-batch") == 0) {
+			fprintf(stderr, "Control socket batch mode = ON\n");
+			bBatchMode = true;
+		} else if (strcmp(cmd, "hatari-stop") == 0) {
+			Main_PauseEmulation(true);
+			bRemotePaused = true;
+		} else if (strcmp(cmd, "hatari-cont") == 0) {
+			Main_UnPauseEmulation();
+			bRemotePaused = false;
+		} else {
+			ok = Control_Usage(cmd);
+		}
+	}
+	return ok;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Process newline separated commands in buffer until one fails or
+ * a command switches to batch mode.  Given buffer is modified in-place.
+ * Return the unprocessed rest of the buffer after a switch to batch
+ * mode, NULL otherwise
+ */
+static char *Control_ProcessLines(char *buffer)
+{
+	char *cmd, *cmdend;
+	bool ok;
+
 	cmd = buffer;
 	do {
 		/* command terminator? */
@@ -270,50 +350,25 @@ void Control_ProcessBuffer(char *buffer)
 		if (cmdend) {
 			*cmdend = '\0';
 		}
-		/* arguments? */
-		arg = strchr(cmd, ' ');
-		if (arg) {
-			*arg = '\0';
-			arg = Str_Trim(arg+1);
-		}
-		if (arg) {
-			if (strcmp(cmd, "hatari-option") == 0) {
-				ok = Change_ApplyCommandline(arg);
-			} else if (strcmp(cmd, "hatari-debug") == 0) {
-				ok = DebugUI_RemoteParse(arg);
-			} else if (strcmp(cmd, "hatari-shortcut") == 0) {
-				ok = Shortcut_Invoke(arg);
-			} else if (strcmp(cmd, "hatari-event") == 0) {
-				ok = Control_InsertEvent(arg);
-			} else if (strcmp(cmd, "hatari-path") == 0) {
-				ok = Control_SetPath(arg);
-			} else if (strcmp(cmd, "hatari-enable") == 0) {
-				ok = Control_DeviceAction(arg, DO_ENABLE);
-			} else if (strcmp(cmd, "hatari-disable") == 0) {
-				ok = Control_DeviceAction(arg, DO_DISABLE);
-			} else if (strcmp(cmd, "hatari-toggle") == 0) {
-				ok = Control_DeviceAction(arg, DO_TOGGLE);
-			} else {
-				ok = Control_Usage(cmd);
-			}
-		} else {
-			if (strcmp(cmd, "hatari-embed-info") == 0) {
-				fprintf(stderr, "Embedded window ID change messages = ON\n");
-				bSendEmbedInfo = true;
-			} else if (strcmp(cmd, "hatari-stop") == 0) {
-				Main_PauseEmulation(true);
-				bRemotePaused = true;
-			} else if (strcmp(cmd, "hatari-cont") == 0) {
-				Main_UnPauseEmulation();
-				bRemotePaused = false;
-			} else {
-				ok = Control_Usage(cmd);
-			}
-		}
+		ok = Control_ProcessCommand(cmd);
 		if (cmdend) {
 			cmd = cmdend + 1;
 		}
+		if (bBatchMode) {
+			return cmdend ? cmd : NULL;
+		}
 	} while (ok && cmdend && *cmd);
+	return NULL;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Parse Hatari debug/event/option/toggle/path/shortcut command buffer.
+ * Given buffer is modified in-place.
+ */
+void Control_ProcessBuffer(char *buffer)
+{
+	Control_ProcessLines(buffer);
 }
 
 
@@ -325,22 +380,253 @@ static int ControlSocket;
 /* pre-declared local functions */
 static int Control_GetUISocket(void);
 
+/* batch mode buffers, input keeps incomplete commands between reads */
+#define CONTROL_LINE_MAX	400
+#define CONTROL_MAX_XFER	0x10000
+static char ControlIn[CONTROL_LINE_MAX + CONTROL_MAX_XFER + 1];
+static int ControlInLen;
+static Uint8 ControlOut[2 * CONTROL_MAX_XFER];
+static int ControlOutLen;
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Send the collected batch mode answers
+ */
+static void Control_Flush(void)
+{
+	ssize_t bytes;
+	int done = 0;
+
+	while (done < ControlOutLen) {
+		bytes = write(ControlSocket, ControlOut + done, ControlOutLen - done);
+		if (bytes < 0) {
+			perror("Control socket write");
+			break;
+		}
+		done += bytes;
+	}
+	ControlOutLen = 0;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Add an answer line to the batch mode reply
+ */
+static void Control_Reply(const char *format, ...)
+{
+	va_list args;
+	int len;
+
+	if (ControlOutLen + CONTROL_LINE_MAX > (int)sizeof(ControlOut)) {
+		Control_Flush();
+	}
+	va_start(args, format);
+	len = vsnprintf((char *)ControlOut + ControlOutLen, CONTROL_LINE_MAX, format, args);
+	va_end(args);
+	if (len >= CONTROL_LINE_MAX) {
+		/* truncated, keep the line terminated */
+		len = CONTROL_LINE_MAX - 1;
+		ControlOut[ControlOutLen + len - 1] = '\n';
+	}
+	ControlOutLen += len;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Parse "<address> <length>" arguments of a memory transfer command.
+ * Return false if they are invalid, true otherwise
+ */
+static bool Control_ParseRange(const char *arg, Uint32 *addr, Uint32 *len)
+{
+	char *endptr;
+
+	*addr = strtoul(arg, &endptr, 0);
+	if (endptr == arg || *endptr != ' ') {
+		return false;
+	}
+	arg = endptr;
+	*len = strtoul(arg, &endptr, 0);
+	if (endptr == arg || *Str_Trim(endptr)) {
+		return false;
+	}
+	return true;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Check that len bytes of physical RAM starting at addr can be accessed
+ */
+static bool Control_CheckRam(Uint32 addr, Uint32 len)
+{
+	Uint32 page;
+
+	if (len > CONTROL_MAX_XFER || addr + len < addr) {
+		return false;
+	}
+	for (page = addr & ~0xfff; page < addr + len; page += 0x1000) {
+		if (!memory_ram_page(page, false)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Answer a batch mode memory read with the data
+ */
+static void Control_MemRead(const char *arg)
+{
+	Uint32 addr, len, n;
+
+	if (!Control_ParseRange(arg, &addr, &len)) {
+		Control_Reply("ERR invalid arguments\n");
+		return;
+	}
+	if (!Control_CheckRam(addr, len)) {
+		Control_Reply("ERR not RAM\n");
+		return;
+	}
+	Control_Reply("OK %u\n", len);
+	if (ControlOutLen + len > sizeof(ControlOut)) {
+		Control_Flush();
+	}
+	for (; len > 0; addr += n, len -= n) {
+		n = 0x1000 - (addr & 0xfff);
+		if (n > len) {
+			n = len;
+		}
+		memcpy(ControlOut + ControlOutLen, memory_ram_page(addr, false) + (addr & 0xfff), n);
+		ControlOutLen += n;
+	}
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Write batch mode memory write data to RAM.  Pages with predecoded
+ * instructions are written through the memory banks so that the
+ * predecode cache notices the change.
+ */
+static bool Control_MemWrite(Uint32 addr, const Uint8 *data, Uint32 len)
+{
+	Uint8 *page;
+	Uint32 i, n;
+
+	if (!Control_CheckRam(addr, len)) {
+		return false;
+	}
+	for (; len > 0; addr += n, data += n, len -= n) {
+		n = 0x1000 - (addr & 0xfff);
+		if (n > len) {
+			n = len;
+		}
+		page = memory_ram_page(addr, true);
+		if (page) {
+			memcpy(page + (addr & 0xfff), data, n);
+		} else {
+			for (i = 0; i < n; i++) {
+				NEXTMemory_WriteByte(addr + i, data[i]);
+			}
+		}
+	}
+	return true;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Execute the complete batch mode commands in the input buffer and keep
+ * the rest for the next read.  Unlike outside of batch mode, a failing
+ * command does not stop the processing of the following ones.
+ */
+static void Control_ProcessBatch(void)
+{
+	char *cmd, *cmdend, *arg;
+	Uint32 addr, len;
+	int pos = 0;
+
+	while (pos < ControlInLen) {
+		cmd = ControlIn + pos;
+		cmdend = memchr(cmd, '\n', ControlInLen - pos);
+		if (!cmdend) {
+			if (ControlInLen - pos < CONTROL_LINE_MAX) {
+				break;
+			}
+			Control_Reply("ERR line too long\n");
+			pos = ControlInLen;
+			break;
+		}
+		*cmdend = '\0';
+
+		if (strncmp(cmd, "hatari-mem-write ", 17) == 0) {
+			arg = cmd + 17;
+			if (cmdend - cmd >= CONTROL_LINE_MAX) {
+				/* the data would not fit after it, drop everything */
+				Control_Reply("ERR line too long\n");
+				pos = ControlInLen;
+				break;
+			}
+			if (!Control_ParseRange(arg, &addr, &len) || len > CONTROL_MAX_XFER) {
+				/* length of the data is unknown, drop everything */
+				Control_Reply("ERR invalid arguments\n");
+				pos = ControlInLen;
+				break;
+			}
+			if (len > (Uint32)(ControlIn + ControlInLen - (cmdend + 1))) {
+				/* wait for the rest of the data */
+				*cmdend = '\n';
+				break;
+			}
+			if (Control_MemWrite(addr, (Uint8 *)cmdend + 1, len)) {
+				Control_Reply("OK\n");
+			} else {
+				Control_Reply("ERR not RAM\n");
+			}
+			pos = cmdend + 1 + len - ControlIn;
+			continue;
+		}
+
+		if (strncmp(cmd, "hatari-mem-read ", 16) == 0) {
+			Control_MemRead(cmd + 16);
+		} else if (Control_ProcessCommand(cmd)) {
+			Control_Reply("OK\n");
+		} else {
+			Control_Reply("ERR %s\n", cmd);
+		}
+		pos = cmdend + 1 - ControlIn;
+	}
+	ControlInLen -= pos;
+	memmove(ControlIn, ControlIn + pos, ControlInLen);
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Forget the batch mode state of a closed control socket
+ */
+static void Control_ResetBatch(void)
+{
+	bBatchMode = false;
+	ControlInLen = ControlOutLen = 0;
+}
+
 
 /*-----------------------------------------------------------------------*/
 /**
  * Check ControlSocket for new commands and execute them.
- * Commands should be separated by newlines.
+ * Commands should be separated by newlines.  In batch mode everything
+ * available is read before the answers are sent.
  * 
  * Return true if remote pause ON (and connected), false otherwise
  */
 bool Control_CheckUpdates(void)
 {
 	/* just using all trace options with +/- are about 300 chars */
-	char buffer[400];
+	char *buffer = ControlIn;
 	struct timeval tv;
 	fd_set readfds;
 	ssize_t bytes;
 	int status, sock;
+	char *rest;
 
 	/* socket of file? */
 	if (ControlSocket) {
@@ -354,7 +640,7 @@ bool Control_CheckUpdates(void)
 	do {
 		FD_ZERO(&readfds);
 		FD_SET(sock, &readfds);
-		if (bRemotePaused) {
+		if (bRemotePaused && !ControlOutLen) {
 			/* return only when there're UI events
 			 * (redraws etc) to save battery:
 			 *   http://bugzilla.libsdl.org/show_bug.cgi?id=323
@@ -375,15 +661,21 @@ bool Control_CheckUpdates(void)
 			return false;
 		}
 		/* nothing to process here */
-		if (status == 0) {
-			return bRemotePaused;
-		}
-		if (!FD_ISSET(sock, &readfds)) {
+		if (status == 0 || !FD_ISSET(sock, &readfds)) {
+			if (ControlOutLen) {
+				/* all read, answer before waiting for more */
+				Control_Flush();
+				continue;
+			}
 			return bRemotePaused;
 		}
 		
-		/* assume whole command can be read in one go */
-		bytes = read(sock, buffer, sizeof(buffer)-1);
+		if (bBatchMode) {
+			bytes = read(sock, ControlIn + ControlInLen, sizeof(ControlIn)-1 - ControlInLen);
+		} else {
+			/* assume whole command can be read in one go */
+			bytes = read(sock, buffer, CONTROL_LINE_MAX-1);
+		}
 		if (bytes < 0)
 		{
 			perror("Control socket read");
@@ -393,12 +685,24 @@ bool Control_CheckUpdates(void)
 			/* closed */
 			close(ControlSocket);
 			ControlSocket = 0;
+			Control_ResetBatch();
 			return false;
 		}
+		if (bBatchMode) {
+			ControlInLen += bytes;
+			Control_ProcessBatch();
+			continue;
+		}
 		buffer[bytes] = '\0';
-		Control_ProcessBuffer(buffer);
+		rest = Control_ProcessLines(buffer);
+		if (rest) {
+			/* switched to batch mode, the rest are batch commands */
+			ControlInLen = buffer + bytes - rest;
+			memmove(ControlIn, rest, ControlInLen);
+			Control_ProcessBatch();
+		}
 
-	} while (bRemotePaused);
+	} while (bRemotePaused || bBatchMode);
 	
 	return false;
 }
@@ -436,6 +740,7 @@ const char *Control_SetSocket(const char *socketpath)
 		close(ControlSocket);
 	}
 	ControlSocket = newsock;
+	Control_ResetBatch();
 	Log_Printf(LOG_INFO, "new control socket is '%s'\n", socketpath);
 	return NULL;
 }
@@ -58,6 +58,8 @@ bool mmu_restart;
 static bool locked_rmw_cycle;
 static bool ismoves;
 bool mmu_ttr_enabled;
+struct mmu_tlb_line mmu_tlb_read[MMU_TLB_SIZE];
+struct mmu_tlb_line mmu_tlb_write[MMU_TLB_SIZE];
 int mmu_atc_ways[2];
 int way_random;
 
@@ -110,6 +112,36 @@ void mmu_make_transparent_region(uaecptr baseaddr, uae_u32 size, int datamode)
 void mmu_tt_modified (void)
 {
     mmu_ttr_enabled = ((regs.dtt0 | regs.dtt1 | regs.itt0 | regs.itt1) & MMU_TTR_BIT_ENABLED) != 0;
+    predecode040_flush();
+    mmu_tlb_flush();
+}
+
+/* Software TLB, see cpummu.h. An all ones tag never matches. */
+void mmu_tlb_flush (void)
+{
+    memset(mmu_tlb_read, 0xff, sizeof(mmu_tlb_read));
+    memset(mmu_tlb_write, 0xff, sizeof(mmu_tlb_write));
+}
+
+static void mmu_tlb_flush_page (uaecptr addr)
+{
+    uaecptr a;
+
+    addr &= mmu_pagemaski;
+    for (a = addr; a - addr <= mmu_pagemask; a += 0x1000) {
+        mmu_tlb_read[mmu_tlb_index(a)].tag = 0xffffffff;
+        mmu_tlb_write[mmu_tlb_index(a)].tag = 0xffffffff;
+    }
+}
+
+void mmu_tlb_fill (struct mmu_tlb_line *t, uaecptr addr, uaecptr phys, bool write)
+{
+    uae_u8 *page = memory_ram_page(phys, write);
+
+    if (page) {
+        t->tag = mmu_tlb_tag(addr);
+        t->host = (uintptr_t)page - (addr & 0xfffff000);
+    }
 }
 
 #if 0
@@ -1084,6 +1116,8 @@ void REGPARAM2 mmu_flush_atc(uaecptr addr, bool super, bool global)
         index=(addr & 0x0001E000)>>13;
     else
         index=(addr & 0x0000F000)>>12;
+    predecode040_flush();
+    mmu_tlb_flush_page(addr);
     for (type=0;type<ATC_TYPE;type++) {
         for (way=0;way<ATC_WAYS;way++) {
             if (!global && mmu_atc_array[type][way][index].status&MMU_MMUSR_G)
@@ -1099,6 +1133,8 @@ void REGPARAM2 mmu_flush_atc(uaecptr addr, bool super, bool global)
 void REGPARAM2 mmu_flush_atc_all(bool global)
 {
     unsigned int way,slot,type;
+    predecode040_flush();
+    mmu_tlb_flush();
     for (type=0;type<ATC_TYPE;type++) {
         for (way=0;way<ATC_WAYS;way++) {
             for (slot=0;slot<ATC_SLOTS;slot++) {
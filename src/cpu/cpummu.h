@@ -290,6 +290,14 @@ static ALWAYS_INLINE uae_u32 mmu_get_ilong(uaecptr addr, int size)
     return phys_get_long(addr);
 }
 
+static ALWAYS_INLINE uaecptr mmu_get_iaddr(uaecptr addr)
+{
+    if (mmu_match_ttr(addr,regs.s!=0,false) == TTR_NO_MATCH && regs.mmu_enabled) {
+        addr = mmu_translate(addr, 0, regs.s!=0, false, false, sz_word);
+    }
+    return addr;
+}
+
 static ALWAYS_INLINE uae_u16 mmu_get_iword(uaecptr addr, int size)
 {
     if (mmu_match_ttr(addr,regs.s!=0,false) == TTR_NO_MATCH && regs.mmu_enabled) {
@@ -306,52 +314,117 @@ static ALWAYS_INLINE uae_u8 mmu_get_ibyte(uaecptr addr, int size)
     return phys_get_byte(addr);
 }
 
+/* Direct-mapped software TLB in front of the ATC for data accesses. It maps
+ * logical 4 kB pages of RAM to host memory, with separate tables for reads
+ * and writes. Write entries are only filled after a write translation, so
+ * write protection and the modified bit have been handled by the ATC. The
+ * tag holds the page address and the supervisor bit, so S/U switches need
+ * no flush. Flushed on PFLUSH, TC, TTR, URP and SRP writes. */
+#define MMU_TLB_SIZE 256
+
+struct mmu_tlb_line {
+    uae_u32 tag;
+    uintptr_t host;     /* host address of the page minus its logical address */
+};
+
+extern struct mmu_tlb_line mmu_tlb_read[MMU_TLB_SIZE];
+extern struct mmu_tlb_line mmu_tlb_write[MMU_TLB_SIZE];
+extern void mmu_tlb_fill(struct mmu_tlb_line *t, uaecptr addr, uaecptr phys, bool write);
+
+/* Accesses are looked up by their first byte and tagged by their last one,
+ * so that an access crossing into the next 4 kB page misses. */
+#define mmu_tlb_index(addr) (((addr) >> 12) & (MMU_TLB_SIZE - 1))
+#define mmu_tlb_tag(addr)   (((addr) & 0xfffff000) | regs.s)
+#define mmu_tlb_host(t, addr) ((uae_u8 *)((t)->host + (addr)))
+
 static ALWAYS_INLINE uae_u32 mmu_get_long(uaecptr addr, int size)
 {
+    struct mmu_tlb_line *t = &mmu_tlb_read[mmu_tlb_index(addr)];
+    uaecptr phys = addr;
+
+    if (likely(t->tag == mmu_tlb_tag(addr + 3)))
+        return do_get_mem_long(mmu_tlb_host(t, addr));
     if (mmu_match_ttr(addr,regs.s!=0,true) == TTR_NO_MATCH && regs.mmu_enabled) {
-        addr = mmu_translate(addr, 0, regs.s!=0, true, false, size);
+        phys = mmu_translate(addr, 0, regs.s!=0, true, false, size);
     }
-    return phys_get_long(addr);
+    mmu_tlb_fill(t, addr, phys, false);
+    return phys_get_long(phys);
 }
 
 static ALWAYS_INLINE uae_u16 mmu_get_word(uaecptr addr, int size)
 {
+    struct mmu_tlb_line *t = &mmu_tlb_read[mmu_tlb_index(addr)];
+    uaecptr phys = addr;
+
+    if (likely(t->tag == mmu_tlb_tag(addr + 1)))
+        return do_get_mem_word(mmu_tlb_host(t, addr));
     if (mmu_match_ttr(addr,regs.s!=0,true) == TTR_NO_MATCH && regs.mmu_enabled) {
-        addr = mmu_translate(addr, 0, regs.s!=0, true, false, size);
+        phys = mmu_translate(addr, 0, regs.s!=0, true, false, size);
     }
-    return phys_get_word(addr);
+    mmu_tlb_fill(t, addr, phys, false);
+    return phys_get_word(phys);
 }
 
 static ALWAYS_INLINE uae_u8 mmu_get_byte(uaecptr addr, int size)
 {
+    struct mmu_tlb_line *t = &mmu_tlb_read[mmu_tlb_index(addr)];
+    uaecptr phys = addr;
+
+    if (likely(t->tag == mmu_tlb_tag(addr)))
+        return *mmu_tlb_host(t, addr);
     if (mmu_match_ttr(addr,regs.s!=0,true) == TTR_NO_MATCH && regs.mmu_enabled) {
-        addr = mmu_translate(addr, 0, regs.s!=0, true, false, size);
+        phys = mmu_translate(addr, 0, regs.s!=0, true, false, size);
     }
-    return phys_get_byte(addr);
+    mmu_tlb_fill(t, addr, phys, false);
+    return phys_get_byte(phys);
 }
 
 static ALWAYS_INLINE void mmu_put_long(uaecptr addr, uae_u32 val, int size)
 {
+    struct mmu_tlb_line *t = &mmu_tlb_write[mmu_tlb_index(addr)];
+    uaecptr phys = addr;
+
+    if (likely(t->tag == mmu_tlb_tag(addr + 3))) {
+        do_put_mem_long(mmu_tlb_host(t, addr), val);
+        return;
+    }
     if (mmu_match_ttr_write(addr,regs.s!=0,true,val,size,true) == TTR_NO_MATCH && regs.mmu_enabled) {
-        addr = mmu_translate(addr, val, regs.s!=0, true, true, size);
+        phys = mmu_translate(addr, val, regs.s!=0, true, true, size);
     }
-    phys_put_long(addr, val);
+    mmu_tlb_fill(t, addr, phys, true);
+    phys_put_long(phys, val);
 }
 
 static ALWAYS_INLINE void mmu_put_word(uaecptr addr, uae_u16 val, int size)
 {
+    struct mmu_tlb_line *t = &mmu_tlb_write[mmu_tlb_index(addr)];
+    uaecptr phys = addr;
+
+    if (likely(t->tag == mmu_tlb_tag(addr + 1))) {
+        do_put_mem_word(mmu_tlb_host(t, addr), val);
+        return;
+    }
     if (mmu_match_ttr_write(addr,regs.s!=0,true,val,size,true) == TTR_NO_MATCH && regs.mmu_enabled) {
-        addr = mmu_translate(addr, val, regs.s!=0, true, true, size);
+        phys = mmu_translate(addr, val, regs.s!=0, true, true, size);
     }
-    phys_put_word(addr, val);
+    mmu_tlb_fill(t, addr, phys, true);
+    phys_put_word(phys, val);
 }
 
 static ALWAYS_INLINE void mmu_put_byte(uaecptr addr, uae_u8 val, int size)
 {
+    struct mmu_tlb_line *t = &mmu_tlb_write[mmu_tlb_index(addr)];
+    uaecptr phys = addr;
+
+    if (likely(t->tag == mmu_tlb_tag(addr))) {
+        *mmu_tlb_host(t, addr) = val;
+        return;
+    }
     if (mmu_match_ttr_write(addr,regs.s!=0,true,val,size,true) == TTR_NO_MATCH && regs.mmu_enabled) {
-        addr = mmu_translate(addr, val, regs.s!=0, true, true, size);
+        phys = mmu_translate(addr, val, regs.s!=0, true, true, size);
     }
-    phys_put_byte(addr, val);
+    mmu_tlb_fill(t, addr, phys, true);
+    phys_put_byte(phys, val);
 }
 
 static ALWAYS_INLINE uae_u32 mmu_get_user_long(uaecptr addr, bool super, bool write, int size)
@@ -576,32 +649,89 @@ STATIC_INLINE uae_u32 get_lrmw_long_mmu040 (uaecptr addr)
     return uae_mmu_get_lrmw (addr, sz_long, 0);
 }
 
+/* Predecoded instructions for m68k_run_mmu040. A record holds the handler
+ * and the instruction stream words of one instruction, tagged with its
+ * logical PC and supervisor state. Instruction fetches of the current
+ * instruction are served from the record without going through the MMU
+ * and fill it on a miss. Records are valid while their generation matches
+ * predecode040_gen, see predecode040_flush(), and the generation of the
+ * physical page they were read from is unchanged, see memory_code_watch(). */
+#define PREDECODES040       4096
+#define PREDECODE040_WORDS  8
+
+struct predecode040 {
+    uaecptr pc;
+    uae_u32 gen;
+    const uae_u32 *page_gen;
+    uae_u32 page_gen_val;
+    cpuop_func *handler;
+    uae_u16 opcode;
+    uae_u16 len;    /* bytes of instruction stream in words[] */
+    uae_u16 max;    /* fill limit, never crosses a 4 kB page */
+    uae_u8 s;
+    uae_u16 words[PREDECODE040_WORDS];
+};
+
+extern struct predecode040 *predecode040_cur;
+
+STATIC_INLINE uae_u32 predecode040_iword (uaecptr pc)
+{
+    struct predecode040 *p = predecode040_cur;
+    uae_u32 off = pc - p->pc;
+    uae_u32 v;
+
+    if (off < p->len && !(off & 1))
+        return p->words[off >> 1];
+    v = uae_mmu040_get_iword (pc);
+    if (off == p->len && off < p->max) {
+        p->words[off >> 1] = v;
+        p->len += 2;
+    }
+    return v;
+}
+STATIC_INLINE uae_u32 predecode040_ilong (uaecptr pc)
+{
+    struct predecode040 *p = predecode040_cur;
+    uae_u32 off = pc - p->pc;
+    uae_u32 v;
+
+    if (off < p->len && off + 4 <= p->len && !(off & 1))
+        return ((uae_u32)p->words[off >> 1] << 16) | p->words[(off >> 1) + 1];
+    v = uae_mmu040_get_ilong (pc);
+    if (off == p->len && off + 4 <= p->max) {
+        p->words[off >> 1] = v >> 16;
+        p->words[(off >> 1) + 1] = v;
+        p->len += 4;
+    }
+    return v;
+}
+
 STATIC_INLINE uae_u32 get_ibyte_mmu040 (int o)
 {
     uae_u32 pc = m68k_getpci () + o;
-    return uae_mmu040_get_iword (pc);
+    return predecode040_iword (pc);
 }
 STATIC_INLINE uae_u32 get_iword_mmu040 (int o)
 {
     uae_u32 pc = m68k_getpci () + o;
-    return uae_mmu040_get_iword (pc);
+    return predecode040_iword (pc);
 }
 STATIC_INLINE uae_u32 get_ilong_mmu040 (int o)
 {
     uae_u32 pc = m68k_getpci () + o;
-    return uae_mmu040_get_ilong (pc);
+    return predecode040_ilong (pc);
 }
 STATIC_INLINE uae_u32 next_iword_mmu040 (void)
 {
     uae_u32 pc = m68k_getpci ();
     m68k_incpci (2);
-    return uae_mmu040_get_iword (pc);
+    return predecode040_iword (pc);
 }
 STATIC_INLINE uae_u32 next_ilong_mmu040 (void)
 {
     uae_u32 pc = m68k_getpci ();
     m68k_incpci (4);
-    return uae_mmu040_get_ilong (pc);
+    return predecode040_ilong (pc);
 }
 
 extern void flush_mmu040 (uaecptr, int);
@@ -504,75 +504,75 @@ STATIC_INLINE void fp_tst(fptype *a, fptype *b)
 
 STATIC_INLINE void fp_sinh(fptype *a, fptype *b)
 {
-    *a = floatx80_sinh(*b);
+    *a = floatx80_cached(floatx80_func_sinh, *b);
 }
 STATIC_INLINE void fp_lognp1(fptype *a, fptype *b)
 {
-    *a = floatx80_lognp1(*b);
+    *a = floatx80_cached(floatx80_func_lognp1, *b);
 }
 STATIC_INLINE void fp_etoxm1(fptype *a, fptype *b)
 {
-    *a = floatx80_etoxm1(*b);
+    *a = floatx80_cached(floatx80_func_etoxm1, *b);
 }
 STATIC_INLINE void fp_tanh(fptype *a, fptype *b)
 {
-    *a = floatx80_tanh(*b);
+    *a = floatx80_cached(floatx80_func_tanh, *b);
 }
 STATIC_INLINE void fp_atan(fptype *a, fptype *b)
 {
-    *a = floatx80_atan(*b);
+    *a = floatx80_cached(floatx80_func_atan, *b);
 }
 STATIC_INLINE void fp_asin(fptype *a, fptype *b)
 {
-    *a = floatx80_asin(*b);
+    *a = floatx80_cached(floatx80_func_asin, *b);
 }
 STATIC_INLINE void fp_atanh(fptype *a, fptype *b)
 {
-    *a = floatx80_atanh(*b);
+    *a = floatx80_cached(floatx80_func_atanh, *b);
 }
 STATIC_INLINE void fp_sin(fptype *a, fptype *b)
 {
-    *a = floatx80_sin(*b);
+    *a = floatx80_cached(floatx80_func_sin, *b);
 }
 STATIC_INLINE void fp_tan(fptype *a, fptype *b)
 {
-    *a = floatx80_tan(*b);
+    *a = floatx80_cached(floatx80_func_tan, *b);
 }
 STATIC_INLINE void fp_etox(fptype *a, fptype *b)
 {
-    *a = floatx80_etox(*b);
+    *a = floatx80_cached(floatx80_func_etox, *b);
 }
 STATIC_INLINE void fp_twotox(fptype *a, fptype *b)
 {
-    *a = floatx80_twotox(*b);
+    *a = floatx80_cached(floatx80_func_twotox, *b);
 }
 STATIC_INLINE void fp_tentox(fptype *a, fptype *b)
 {
-    *a = floatx80_tentox(*b);
+    *a = floatx80_cached(floatx80_func_tentox, *b);
 }
 STATIC_INLINE void fp_logn(fptype *a, fptype *b)
 {
-    *a = floatx80_logn(*b);
+    *a = floatx80_cached(floatx80_func_logn, *b);
 }
 STATIC_INLINE void fp_log10(fptype *a, fptype *b)
 {
-    *a = floatx80_log10(*b);
+    *a = floatx80_cached(floatx80_func_log10, *b);
 }
 STATIC_INLINE void fp_log2(fptype *a, fptype *b)
 {
-    *a = floatx80_log2(*b);
+    *a = floatx80_cached(floatx80_func_log2, *b);
 }
 STATIC_INLINE void fp_cosh(fptype *a, fptype *b)
 {
-    *a = floatx80_cosh(*b);
+    *a = floatx80_cached(floatx80_func_cosh, *b);
 }
 STATIC_INLINE void fp_acos(fptype *a, fptype *b)
 {
-    *a = floatx80_acos(*b);
+    *a = floatx80_cached(floatx80_func_acos, *b);
 }
 STATIC_INLINE void fp_cos(fptype *a, fptype *b)
 {
-    *a = floatx80_cos(*b);
+    *a = floatx80_cached(floatx80_func_cos, *b);
 }
 
 /* Functions with fixed precision */
@@ -9,7 +9,11 @@
  */
 
 #include "main.h"
+#include "configuration.h"
 #include "hatari-glue.h"
+#if ENABLE_TESTING
+#include "host.h"
+#endif
 
 
 #include "sysconfig.h"
@@ -2879,10 +2883,106 @@ void fpuop_restore (uae_u32 opcode)
     fp_exception_pending(false);
 }
 
+#ifdef WITH_SOFTFLOAT
+/* Host long double transcendentals (see softfloat_host.c). Every function
+ * is checked against the FPSP algorithms once and is only used if they
+ * agree within FPP_HOST_MAX_ULP on the test corpus. */
+#define FPP_HOST_CHECK_COUNT 20000
+#define FPP_HOST_MAX_ULP     2
+
+static const TCHAR *fpp_host_func_name[floatx80_func_count] = {
+    _T("facos"), _T("fasin"), _T("fatan"), _T("fatanh"), _T("fcos"), _T("fcosh"),
+    _T("fetox"), _T("fetoxm1"), _T("flog10"), _T("flog2"), _T("flogn"), _T("flognp1"),
+    _T("fsin"), _T("fsinh"), _T("ftan"), _T("ftanh"), _T("ftentox"), _T("ftwotox")
+};
+
+static bool fpp_host_valid[floatx80_func_count];
+
+/* Compare every host function against the FPSP algorithms, once */
+static void fpp_host_math_check(void)
+{
+    static bool checked;
+    bits64 dist;
+    int f;
+
+    if (checked || !floatx80_host_available())
+        return;
+    checked = true;
+    for (f = 0; f < floatx80_func_count; f++) {
+        if (!floatx80_host_func_supported(f))
+            continue;
+        dist = floatx80_host_check(f, FPP_HOST_CHECK_COUNT);
+        fpp_host_valid[f] = dist <= FPP_HOST_MAX_ULP;
+        if (fpp_host_valid[f])
+            write_log(_T("FPU: host %s within %d ulp of FPSP\n"), fpp_host_func_name[f], (int)dist);
+        else
+            write_log(_T("FPU: host %s differs from FPSP, using softfloat\n"), fpp_host_func_name[f]);
+    }
+}
+
+static void fpp_host_math(bool enable)
+{
+    int f;
+
+    if (enable)
+        fpp_host_math_check();
+    for (f = 0; f < floatx80_func_count; f++)
+        floatx80_host_enable(f, enable && fpp_host_valid[f]);
+}
+
+#if ENABLE_TESTING
+/* Time a loop of FSIN, FCOS, FETOX and FLOGN as used for table setup in
+ * scientific programs: plain softfloat, softfloat through the cache and
+ * host math through the cache. Arguments repeat every 256 iterations.
+ * Run with the debugger "bench fpu" command. */
+void fpu_host_math_bench(void)
+{
+    static const TCHAR *mode[3] = { _T("softfloat"), _T("cached"), _T("host+cached") };
+    const int N = 200000;
+    fptype x, sum;
+    Uint64 t;
+    int i, m, f;
+
+    fpp_host_math_check();
+    set_fp_mode(0);
+    for (m = 0; m < 3; m++) {
+        for (f = 0; f < floatx80_func_count; f++)
+            floatx80_host_enable(f, m == 2 && fpp_host_valid[f]);
+        sum = int32_to_floatx80(0);
+        t = host_time_us();
+        for (i = 0; i < N; i++) {
+            x = floatx80_div(int32_to_floatx80((i & 255) + 1), int32_to_floatx80(37));
+            if (m == 0) {
+                sum = floatx80_add(sum, floatx80_sin(x));
+                sum = floatx80_add(sum, floatx80_cos(x));
+                sum = floatx80_add(sum, floatx80_etox(floatx80_neg(x)));
+                sum = floatx80_add(sum, floatx80_logn(x));
+            } else {
+                sum = floatx80_add(sum, floatx80_cached(floatx80_func_sin, x));
+                sum = floatx80_add(sum, floatx80_cached(floatx80_func_cos, x));
+                sum = floatx80_add(sum, floatx80_cached(floatx80_func_etox, floatx80_neg(x)));
+                sum = floatx80_add(sum, floatx80_cached(floatx80_func_logn, x));
+            }
+        }
+        t = host_time_us() - t;
+        write_log(_T("FPU: %s transcendentals %.2f Mops/s (sum %s)\n"), mode[m],
+                  t ? 4.0 * N / t : 0.0, fp_print(&sum));
+    }
+    /* Back to the guest settings */
+    clear_fp_status();
+    fpp_host_math(ConfigureParams.System.bFPUHostMath);
+    fpp_set_fpcr(regs.fpcr);
+}
+#endif
+#endif
+
 void fpu_reset (void)
 {
     regs.fpiar = 0;
     regs.fpu_exp_state = 0;
+#ifdef WITH_SOFTFLOAT
+    fpp_host_math(ConfigureParams.System.bFPUHostMath);
+#endif
     fpp_set_fpcr (0);
     fpp_set_fpsr (0);
 }
@@ -28,6 +28,7 @@ const char Memory_fileid[] = "Previous memory.c : " __DATE__ " " __TIME__;
 #include "nextMemory.h"
 #include "m68000.h"
 #include "configuration.h"
+#include "host.h"
 
 #include "newcpu.h"
 
@@ -102,6 +103,22 @@ uae_u32 NEXT_ram_bank1_mask;
 uae_u32 NEXT_ram_bank2_mask;
 uae_u32 NEXT_ram_bank3_mask;
 
+/* RAM pages (4 kB) that hold predecoded 68040 instructions. Writing to
+ * one of them advances its generation, which invalidates the records
+ * predecoded from that page only, see memory_code_watch(). */
+static uae_u8 NEXT_code_pages[(NEXT_RAM_BANK_MAX_T * N_BANKS) >> 12];
+static uae_u32 NEXT_code_gen[(NEXT_RAM_BANK_MAX_T * N_BANKS) >> 12];
+static uae_u32 NEXT_rom_code_gen;
+
+static void memory_code_written(int page)
+{
+	NEXT_code_pages[page] = 0;
+	if (++NEXT_code_gen[page] == 0)
+		predecode040_flush();
+}
+
+#define check_code_write(addr) do { if (NEXT_code_pages[(addr) >> 12]) memory_code_written((addr) >> 12); } while (0)
+
 /* Main memory with memory write functions */
 #define NEXT_RAM_MWF0_START		0x10000000
 #define NEXT_RAM_MWF1_START		0x14000000
@@ -371,18 +388,21 @@ static uae_u32 mem_ram_bank0_bget(uaecptr addr)
 static void mem_ram_bank0_lput(uaecptr addr, uae_u32 l)
 {
 	addr &= NEXT_ram_bank0_mask;
+	check_code_write(addr);
 	do_put_mem_long(NEXTRam + addr, l);
 }
 
 static void mem_ram_bank0_wput(uaecptr addr, uae_u32 w)
 {
 	addr &= NEXT_ram_bank0_mask;
+	check_code_write(addr);
 	do_put_mem_word(NEXTRam + addr, w);
 }
 
 static void mem_ram_bank0_bput(uaecptr addr, uae_u32 b)
 {
 	addr &= NEXT_ram_bank0_mask;
+	check_code_write(addr);
 	NEXTRam[addr] = b;
 }
 
@@ -408,18 +428,21 @@ static uae_u32 mem_ram_bank1_bget(uaecptr addr)
 static void mem_ram_bank1_lput(uaecptr addr, uae_u32 l)
 {
 	addr &= NEXT_ram_bank1_mask;
+	check_code_write(addr);
 	do_put_mem_long(NEXTRam + addr, l);
 }
 
 static void mem_ram_bank1_wput(uaecptr addr, uae_u32 w)
 {
 	addr &= NEXT_ram_bank1_mask;
+	check_code_write(addr);
 	do_put_mem_word(NEXTRam + addr, w);
 }
 
 static void mem_ram_bank1_bput(uaecptr addr, uae_u32 b)
 {
 	addr &= NEXT_ram_bank1_mask;
+	check_code_write(addr);
 	NEXTRam[addr] = b;
 }
 
@@ -445,18 +468,21 @@ static uae_u32 mem_ram_bank2_bget(uaecptr addr)
 static void mem_ram_bank2_lput(uaecptr addr, uae_u32 l)
 {
 	addr &= NEXT_ram_bank2_mask;
+	check_code_write(addr);
 	do_put_mem_long(NEXTRam + addr, l);
 }
 
 static void mem_ram_bank2_wput(uaecptr addr, uae_u32 w)
 {
 	addr &= NEXT_ram_bank2_mask;
+	check_code_write(addr);
 	do_put_mem_word(NEXTRam + addr, w);
 }
 
 static void mem_ram_bank2_bput(uaecptr addr, uae_u32 b)
 {
 	addr &= NEXT_ram_bank2_mask;
+	check_code_write(addr);
 	NEXTRam[addr] = b;
 }
 
@@ -482,21 +508,74 @@ static uae_u32 mem_ram_bank3_bget(uaecptr addr)
 static void mem_ram_bank3_lput(uaecptr addr, uae_u32 l)
 {
 	addr &= NEXT_ram_bank3_mask;
+	check_code_write(addr);
 	do_put_mem_long(NEXTRam + addr, l);
 }
 
 static void mem_ram_bank3_wput(uaecptr addr, uae_u32 w)
 {
 	addr &= NEXT_ram_bank3_mask;
+	check_code_write(addr);
 	do_put_mem_word(NEXTRam + addr, w);
 }
 
 static void mem_ram_bank3_bput(uaecptr addr, uae_u32 b)
 {
 	addr &= NEXT_ram_bank3_mask;
+	check_code_write(addr);
 	NEXTRam[addr] = b;
 }
 
+/* Offset of physical address addr in NEXTRam, or -1 if addr is not RAM */
+static int memory_ram_offset(uaecptr addr)
+{
+	mem_get_func wget = get_mem_bank(addr).wget;
+
+	if (wget == mem_ram_bank0_wget)
+		return addr & NEXT_ram_bank0_mask;
+	if (wget == mem_ram_bank1_wget)
+		return addr & NEXT_ram_bank1_mask;
+	if (wget == mem_ram_bank2_wget)
+		return addr & NEXT_ram_bank2_mask;
+	if (wget == mem_ram_bank3_wget)
+		return addr & NEXT_ram_bank3_mask;
+	return -1;
+}
+
+/* Mark the physical page at addr as holding predecoded instructions.
+ * Returns the generation counter of the page, a record stays valid while
+ * it is unchanged. Returns NULL if addr is neither RAM nor ROM, so writes
+ * to it can't be tracked and the instruction must not be cached. */
+const uae_u32 *memory_code_watch(uaecptr addr)
+{
+	int offset;
+
+	if (get_mem_bank(addr).wget == mem_rom_wget)
+		return &NEXT_rom_code_gen;
+	offset = memory_ram_offset(addr);
+	if (offset < 0)
+		return NULL;
+	if (!NEXT_code_pages[offset >> 12]) {
+		NEXT_code_pages[offset >> 12] = 1;
+		/* stores to this page must go through check_code_write() */
+		mmu_tlb_flush();
+	}
+	return &NEXT_code_gen[offset >> 12];
+}
+
+/* Host address of the 4 kB RAM page holding physical address addr, or NULL
+ * if addr is not RAM. Pages with predecoded code are not returned for
+ * writes, so that stores to them keep going through the bank handlers. */
+uae_u8 *memory_ram_page(uaecptr addr, bool write)
+{
+	int offset = memory_ram_offset(addr);
+
+	if (offset < 0 || (write && NEXT_code_pages[offset >> 12]))
+		return NULL;
+	return NEXTRam + (offset & ~0xfff);
+}
+
+
 /* **** NEXT RAM empty areas **** */
 
 static uae_u32 mem_ram_empty_lget(uaecptr addr)
@@ -1052,6 +1131,25 @@ const char* memory_init(int *nNewNEXTMemSize)
 	
 	write_log("Memory init: Memory size: %iMB\n", Configuration_CheckMemory(nNewNEXTMemSize));
 	
+	/* Allocate main memory for all banks of this machine type */
+	if (NEXTRam && NEXTRamSize != NEXT_ram_bank_size * N_BANKS) {
+		host_mem_free(NEXTRam, NEXTRamSize);
+		NEXTRam = NULL;
+	}
+	if (NEXTRam) {
+		host_mem_clear(NEXTRam, NEXTRamSize);
+	} else {
+		NEXTRamSize = NEXT_ram_bank_size * N_BANKS;
+		NEXTRam = host_mem_alloc(NEXTRamSize);
+		if (NEXTRam == NULL) {
+			NEXTRamSize = 0;
+			return "Cannot allocate main memory";
+		}
+	}
+	memset(NEXT_code_pages, 0, sizeof(NEXT_code_pages));
+	predecode040_flush();
+	mmu_tlb_flush();
+	
 	/* Convert values from MB to byte */
 	for (i=0; i<N_BANKS; i++) {
 		bankstart[i] = NEXT_RAM_START + (NEXT_ram_bank_size * i);
@@ -1219,7 +1317,6 @@ const char* memory_init(int *nNewNEXTMemSize)
 	{
 		int i;
 		for (i=0;i<sizeof(NEXTVideo);i++) NEXTVideo[i]=0;
-		for (i=0;i<sizeof(NEXTRam);i++) NEXTRam[i]=0;
 		for (i=0;i<sizeof(NEXTIo);i++) NEXTIo[i]=0;
 	}
 	
@@ -1234,6 +1331,9 @@ const char* memory_init(int *nNewNEXTMemSize)
  */
 void memory_uninit (void)
 {
+	host_mem_free(NEXTRam, NEXTRamSize);
+	NEXTRam = NULL;
+	NEXTRamSize = 0;
 }
 
 
@@ -80,6 +80,8 @@ extern addrbank mem_banks[65536];
 
 const char* memory_init(int *membanks);
 void memory_uninit (void);
+const uae_u32 *memory_code_watch(uaecptr addr);
+uae_u8 *memory_ram_page(uaecptr addr, bool write);
 void map_banks(addrbank *bank, int first, int count);
 
 #ifndef NO_INLINE_MEMORY_ACCESS
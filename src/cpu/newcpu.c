@@ -62,6 +62,9 @@ int movem_next[256];
 
 cpuop_func *cpufunctbl[65536];
 
+/* Instructions executed since start, for benchmark reports */
+uae_u64 m68k_insn_count;
+
 int OpcodeFamily;
 struct mmufixup mmufixup[2];
 
@@ -70,6 +73,11 @@ uae_u32 fpp_get_fpsr (void);
 static struct cache030 icaches030[CACHELINES030];
 static struct cache030 dcaches030[CACHELINES030];
 
+static struct predecode040 predecodes040[PREDECODES040];
+static struct predecode040 predecode040_none;
+struct predecode040 *predecode040_cur = &predecode040_none;
+static uae_u32 predecode040_gen = 1;
+
 void m68k_disasm_2 (TCHAR *buf, int bufsize, uaecptr addr, uaecptr *nextpc, int cnt, uae_u32 *seaddr, uae_u32 *deaddr, int safemode);
 
 uae_u32 (*x_prefetch)(int);
@@ -149,11 +157,47 @@ static void set_x_funcs (void)
     }
 }
 
+/* Invalidate all predecoded instructions. Called when the MMU state
+ * changes (ATC flushes, TC, TTR, URP and SRP writes) and on CINV/CPUSH of
+ * the instruction cache. Writes to RAM holding predecoded code only
+ * invalidate the records of that page, see memory_code_watch(). */
+void predecode040_flush(void)
+{
+    if (++predecode040_gen == 0) {
+        memset(predecodes040, 0, sizeof(predecodes040));
+        predecode040_gen = 1;
+    }
+}
+
+/* Start a new record for the instruction at pc. Returns false if the
+ * instruction is not in RAM or ROM, the record then never becomes valid. */
+static bool predecode040_fill(struct predecode040 *p, uaecptr pc, uae_u16 opcode)
+{
+    const uae_u32 *page_gen = memory_code_watch(mmu_get_iaddr(pc));
+    bool cached = page_gen != NULL;
+
+    p->pc = pc;
+    p->gen = 0;
+    p->page_gen = page_gen;
+    p->page_gen_val = cached ? *page_gen : 0;
+    p->s = regs.s;
+    p->opcode = opcode;
+    p->handler = cpufunctbl[opcode];
+    p->words[0] = opcode;
+    p->len = 2;
+    p->max = cached ? PREDECODE040_WORDS * 2 : 2;
+    if (p->max > 0x1000 - (pc & 0xfff))
+        p->max = 0x1000 - (pc & 0xfff);
+    predecode040_cur = p;
+    return cached;
+}
+
 void flush_cpu_caches_040(uae_u16 opcode)
 {
     int cache = (opcode >> 6) & 3;
     if (!(cache & 2))
         return;
+    predecode040_flush();
     set_cpu_caches(true);
 }
 
@@ -288,6 +332,7 @@ void build_cpufunctbl (void)
                currprefs.fpu_model, currprefs.fpu_revision,
 		currprefs.cachesize ? (currprefs.compfpu ? "=CPU/FPU" : "=CPU") : "",
 		currprefs.cachesize, ConfigureParams.System.bRealtime);
+	predecode040_flush ();
 	set_cpu_caches (0);
 	if (currprefs.mmu_model) {
         if (currprefs.cpu_model >= 68040) {
@@ -1334,6 +1379,7 @@ insretry:
 			mmu030_opcode = -1;
             
             M68000_AddCycles(cpu_cycles);
+            m68k_insn_count++;
             cpu_cycles = nCyclesMainCounter - beforeCycles;
             
 			DSP_Run(cpu_cycles);
@@ -1403,6 +1449,7 @@ static void m68k_run_mmu040 (void)
 	f.cznv = 0;
 	f.x    = 0;
 	uaecptr pc;
+	struct predecode040 *p;
     int intr = 0;
     int lastintr = 0;
 	
@@ -1416,9 +1463,28 @@ static void m68k_run_mmu040 (void)
         
             Uint64 beforeCycles = nCyclesMainCounter;
 			mmu_opcode = -1;
-			mmu_opcode = opcode = x_prefetch (0);
-			cpu_cycles = (*cpufunctbl[opcode])(opcode);
+			p = &predecodes040[(pc >> 1) & (PREDECODES040 - 1)];
+			if (p->pc == pc && p->gen == predecode040_gen && p->s == regs.s &&
+			    *p->page_gen == p->page_gen_val) {
+				/* hit: opcode and extension words come from the record */
+				mmu_opcode = opcode = p->opcode;
+				predecode040_cur = p;
+				cpu_cycles = (*p->handler)(opcode);
+			} else {
+				uae_u32 gen = predecode040_gen;
+				mmu_opcode = opcode = x_prefetch (0);
+				if (predecode040_fill (p, pc, opcode)) {
+					cpu_cycles = (*p->handler)(opcode);
+					/* only valid if nothing was flushed while it executed */
+					if (gen == predecode040_gen)
+						p->gen = gen;
+				} else {
+					cpu_cycles = (*p->handler)(opcode);
+				}
+			}
+			predecode040_cur = &predecode040_none;
             M68000_AddCycles(cpu_cycles);
+            m68k_insn_count++;
             
             cpu_cycles = nCyclesMainCounter - beforeCycles;
 
@@ -1455,6 +1521,8 @@ static void m68k_run_mmu040 (void)
 		} // end of for(;;)
 	} CATCH (prb) {
 
+		predecode040_cur = &predecode040_none;
+
 		if (mmu_restart) {
 			/* restore state if instruction restart */
 			regflags.cznv = f.cznv;
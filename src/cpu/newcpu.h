@@ -656,6 +656,9 @@ extern int get_cpu_model (void);
 extern void set_cpu_caches (bool flush);
 extern void flush_cpu_caches(bool flush);
 extern void flush_cpu_caches_040(uae_u16 opcode);
+extern void predecode040_flush(void);
+extern uae_u64 m68k_insn_count;
+extern void mmu_tlb_flush(void);
 extern void REGPARAM3 MakeSR (void) REGPARAM;
 extern void REGPARAM3 MakeFromSR (void) REGPARAM;
 extern void MakeSR (void);
@@ -699,6 +702,7 @@ extern void fpuop_save(uae_u32);
 extern void fpuop_restore(uae_u32);
 extern uae_u32 fpp_get_fpsr (void);
 extern void fpu_reset (void);
+extern void fpu_host_math_bench (void); /* ENABLE_TESTING builds only */
 extern void fpux_save (int*);
 extern void fpux_restore (int*);
 extern bool fpu_get_constant(fptype *fp, int cr);
@@ -34,6 +34,7 @@ const char CycInt_fileid[] = "Previous cycInt.c : " __DATE__ " " __TIME__;
 #include "floppy.h"
 #include "snd.h"
 #include "printer.h"
+#include "scc.h"
 #include "kms.h"
 #include "configuration.h"
 #include "main.h"
@@ -69,8 +70,36 @@ static void (* const pIntHandlerFunctions[MAX_INTERRUPTS])(void) =
     Main_EventHandlerInterrupt,
     nd_vbl_handler,
     nd_video_vbl_handler,
+    SCC_IO_Handler,
 };
 
+/* Handler names for reports, in the same order as above */
+static const char * const pIntHandlerNames[MAX_INTERRUPTS] =
+{
+	"null",
+	"video_vbl",
+	"hardclock",
+	"mouse",
+	"esp",
+	"esp_io",
+	"m2m_io",
+	"mo",
+	"mo_io",
+	"ecc_io",
+	"enet_io",
+	"flp_io",
+	"snd_out",
+	"snd_in",
+	"lp_io",
+	"event_loop",
+	"nd_vbl",
+	"nd_video_vbl",
+	"scc_io",
+};
+
+/* Number of times each handler has been called since reset */
+static Uint64 InterruptCounts[MAX_INTERRUPTS];
+
 static INTERRUPTHANDLER InterruptHandlers[MAX_INTERRUPTS];
 INTERRUPTHANDLER        PendingInterrupt;
 static int              ActiveInterrupt=0;
@@ -92,6 +121,7 @@ void CycInt_Reset(void) {
 	nCyclesOver           = 0;
     nCyclesMainCounter    = 0;
     usCheckCycles         = 0;
+    memset(InterruptCounts, 0, sizeof(InterruptCounts));
         
 	/* Reset interrupt table */
 	for (i=0; i<MAX_INTERRUPTS; i++) {
@@ -170,6 +200,7 @@ void CycInt_AcknowledgeInterrupt(void) {
 
 	/* Disable interrupt entry which has just occured */
 	InterruptHandlers[ActiveInterrupt].type = CYC_INT_NONE;
+	InterruptCounts[ActiveInterrupt]++;
 
 	/* Set new */
 	CycInt_SetNewInterrupt();
@@ -258,3 +289,21 @@ bool CycInt_InterruptActive(interrupt_id Handler)
 {
     return InterruptHandlers[Handler].type != CYC_INT_NONE;
 }
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return name of interrupt handler for reports
+ */
+const char *CycInt_Name(interrupt_id Handler)
+{
+    return pIntHandlerNames[Handler];
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return number of times interrupt handler has been called since reset
+ */
+Uint64 CycInt_Count(interrupt_id Handler)
+{
+    return InterruptCounts[Handler];
+}
@@ -31,6 +31,9 @@ const char BreakCond_fileid[] = "Hatari breakcond.c : " __DATE__ " " __TIME__;
 #include "evaluate.h"
 #include "symbols.h"
 #include "68kDisass.h"
+#if ENABLE_TESTING
+#include "host.h"
+#endif
 
 
 /* set to 1 to enable parsing function tracing / debug output */
@@ -39,11 +42,17 @@ const char BreakCond_fileid[] = "Hatari breakcond.c : " __DATE__ " " __TIME__;
 /* needs to go through long long to handle x=32 */
 #define BITMASK(x)      ((Uint32)(((unsigned long long)1<<(x))-1))
 
-#define BC_MAX_CONDITION_BREAKPOINTS 16
+#define BC_MAX_CONDITION_BREAKPOINTS 64
 #define BC_MAX_CONDITIONS_PER_BREAKPOINT 4
 
 #define BC_DEFAULT_DSP_SPACE 'P'
 
+/* CPU breakpoints with a "pc = <address>" condition are entered into
+ * a PC bitmap which is checked before evaluating any conditions
+ */
+#define BC_PC_FILTER_BITS 4096
+#define BC_PC_HASH(pc) (((pc) >> 1) & (BC_PC_FILTER_BITS-1))
+
 typedef enum {	
 	/* plain number */
 	VALUE_TYPE_NUMBER     = 0,
@@ -74,11 +83,14 @@ typedef struct {
 	Uint32 mask;	/* <width mask> && <value mask> */
 } bc_value_t;
 
-typedef struct {
+typedef struct bc_condition_s {
 	bc_value_t lvalue;
 	bc_value_t rvalue;
 	char comparison;
 	bool track;	/* track value changes */
+	/* compiled evaluator, see BreakCond_Compile() */
+	bool (*match)(const struct bc_condition_s *condition);
+	Uint32 constant;	/* masked right side for the evaluator */
 } bc_condition_t;
 
 typedef struct {
@@ -95,6 +107,8 @@ typedef struct {
 	bc_condition_t conditions[BC_MAX_CONDITIONS_PER_BREAKPOINT];
 	int ccount;	/* condition count */
 	int hits;	/* how many times breakpoint hit */
+	bool has_pc;	/* one of the conditions is "pc = <pc>" */
+	Uint32 pc;
 } bc_breakpoint_t;
 
 static bc_breakpoint_t BreakPointsCpu[BC_MAX_CONDITION_BREAKPOINTS];
@@ -102,10 +116,14 @@ static bc_breakpoint_t BreakPointsDsp[BC_MAX_CONDITION_BREAKPOINTS];
 static int BreakPointCpuCount;
 static int BreakPointDspCount;
 
+static Uint32 BreakPointCpuPcFilter[BC_PC_FILTER_BITS/32];
+static int BreakPointCpuNoPcCount;	/* CPU breakpoints without PC condition */
+
 
 /* forward declarations */
 static bool BreakCond_Remove(int position, bool bForDsp);
 static void BreakCond_Print(bc_breakpoint_t *bp);
+static Uint32 GetCpuPC(void);
 
 
 /**
@@ -218,39 +236,116 @@ static Uint32 BreakCond_GetValue(const bc_value_t *bc_value)
 }
 
 
+/**
+ * Return true if given condition matches, for any kind of values
+ */
+static bool BreakCond_MatchGeneric(const bc_condition_t *condition)
+{
+	Uint32 lvalue, rvalue;
+
+	lvalue = BreakCond_GetValue(&(condition->lvalue));
+	rvalue = BreakCond_GetValue(&(condition->rvalue));
+
+	switch (condition->comparison) {
+	case '<':
+		return (lvalue < rvalue);
+	case '>':
+		return (lvalue > rvalue);
+	case '=':
+		return (lvalue == rvalue);
+	case '!':
+		return (lvalue != rvalue);
+	default:
+		fprintf(stderr, "ERROR: Unknown breakpoint value comparison operator '%c'!\n",
+			condition->comparison);
+		abort();
+	}
+}
+
+
+/* Evaluators for conditions comparing a register, PC/SR or a memory
+ * location against a constant. Register pointers, addresses and masks
+ * are resolved when the breakpoint is added.
+ */
+#define BC_EVALUATORS(kind, value) \
+static bool BreakCond_Match##kind##Eq(const bc_condition_t *c) \
+{ return ((value) & c->lvalue.mask) == c->constant; } \
+static bool BreakCond_Match##kind##Ne(const bc_condition_t *c) \
+{ return ((value) & c->lvalue.mask) != c->constant; } \
+static bool BreakCond_Match##kind##Lt(const bc_condition_t *c) \
+{ return ((value) & c->lvalue.mask) < c->constant; } \
+static bool BreakCond_Match##kind##Gt(const bc_condition_t *c) \
+{ return ((value) & c->lvalue.mask) > c->constant; } \
+static bool (* const BreakCond_Match##kind[])(const bc_condition_t *) = { \
+	BreakCond_Match##kind##Eq, BreakCond_Match##kind##Ne, \
+	BreakCond_Match##kind##Lt, BreakCond_Match##kind##Gt \
+};
+
+BC_EVALUATORS(Reg32, *c->lvalue.value.reg32)
+BC_EVALUATORS(Reg16, *c->lvalue.value.reg16)
+BC_EVALUATORS(Func32, c->lvalue.value.func32())
+BC_EVALUATORS(Mem32, DBGMemory_ReadLong(c->lvalue.value.number))
+BC_EVALUATORS(Mem16, DBGMemory_ReadWord(c->lvalue.value.number))
+BC_EVALUATORS(Mem8, DBGMemory_ReadByte(c->lvalue.value.number))
+
+
+/**
+ * Select the evaluator for given condition
+ */
+static void BreakCond_Compile(bc_condition_t *condition)
+{
+	bool (* const *table)(const bc_condition_t *) = NULL;
+	const bc_value_t *lvalue = &(condition->lvalue);
+	int op;
+
+	condition->match = BreakCond_MatchGeneric;
+
+	switch (condition->comparison) {
+	case '=': op = 0; break;
+	case '!': op = 1; break;
+	case '<': op = 2; break;
+	case '>': op = 3; break;
+	default: return;
+	}
+	if (condition->rvalue.valuetype != VALUE_TYPE_NUMBER ||
+	    condition->rvalue.is_indirect) {
+		return;
+	}
+	if (lvalue->is_indirect) {
+		/* only fixed CPU memory addresses */
+		if (lvalue->valuetype != VALUE_TYPE_NUMBER || lvalue->dsp_space) {
+			return;
+		}
+		switch (lvalue->bits) {
+		case 32: table = BreakCond_MatchMem32; break;
+		case 16: table = BreakCond_MatchMem16; break;
+		case 8:  table = BreakCond_MatchMem8;  break;
+		}
+	} else {
+		switch (lvalue->valuetype) {
+		case VALUE_TYPE_VAR32:
+		case VALUE_TYPE_REG32:    table = BreakCond_MatchReg32;  break;
+		case VALUE_TYPE_REG16:    table = BreakCond_MatchReg16;  break;
+		case VALUE_TYPE_FUNCTION32: table = BreakCond_MatchFunc32; break;
+		default: break;
+		}
+	}
+	if (table) {
+		condition->constant = condition->rvalue.value.number & condition->rvalue.mask;
+		condition->match = table[op];
+	}
+}
+
+
 /**
  * Return true if all of the given breakpoint's conditions match
  */
 static bool BreakCond_MatchConditions(const bc_condition_t *condition, int count)
 {
-	Uint32 lvalue, rvalue;
-	bool hit = false;
 	int i;
 	
 	for (i = 0; i < count; condition++, i++) {
-
-		lvalue = BreakCond_GetValue(&(condition->lvalue));
-		rvalue = BreakCond_GetValue(&(condition->rvalue));
-
-		switch (condition->comparison) {
-		case '<':
-			hit = (lvalue < rvalue);
-			break;
-		case '>':
-			hit = (lvalue > rvalue);
-			break;
-		case '=':
-			hit = (lvalue == rvalue);
-			break;
-		case '!':
-			hit = (lvalue != rvalue);
-			break;
-		default:
-			fprintf(stderr, "ERROR: Unknown breakpoint value comparison operator '%c'!\n",
-				condition->comparison);
-			abort();
-		}
-		if (!hit) {
+		if (!condition->match(condition)) {
 			return false;
 		}
 	}
@@ -278,6 +373,7 @@ static void BreakCond_ShowTracked(bc_condition_t *condition, int count)
 		value = BreakCond_GetValue(&(condition->lvalue));
 		/* next monitor changes to this new value */
 		condition->rvalue.value.number = value;
+		condition->constant = value & condition->rvalue.mask;
 		
 		if (condition->lvalue.is_indirect &&
 		    condition->lvalue.valuetype == VALUE_TYPE_NUMBER) {
@@ -298,11 +394,14 @@ static void BreakCond_ShowTracked(bc_condition_t *condition, int count)
  * Return which of the given condition breakpoints match
  * or zero if none matched
  */
-static int BreakCond_MatchBreakPoints(bc_breakpoint_t *bp, int count, const char *name)
+static int BreakCond_MatchBreakPoints(bc_breakpoint_t *bp, int count, const char *name, Uint32 pc)
 {
 	int i;
 	
 	for (i = 0; i < count; bp++, i++) {
+		if (bp->has_pc && bp->pc != pc) {
+			continue;
+		}
 		if (BreakCond_MatchConditions(bp->conditions, bp->ccount)) {
 			BreakCond_ShowTracked(bp->conditions, bp->ccount);
 			bp->hits++;
@@ -343,7 +442,17 @@ static int BreakCond_MatchBreakPoints(bc_breakpoint_t *bp, int count, const char
  */
 int BreakCond_MatchCpu(void)
 {
-	return BreakCond_MatchBreakPoints(BreakPointsCpu, BreakPointCpuCount, "CPU");
+	Uint32 pc = M68000_GetPC();
+	Uint32 hash = BC_PC_HASH(pc);
+
+	/* if all breakpoints are for some PC, most instructions can be
+	 * rejected without evaluating any conditions
+	 */
+	if (!BreakPointCpuNoPcCount &&
+	    !(BreakPointCpuPcFilter[hash >> 5] & (1u << (hash & 31)))) {
+		return 0;
+	}
+	return BreakCond_MatchBreakPoints(BreakPointsCpu, BreakPointCpuCount, "CPU", pc);
 }
 
 /**
@@ -351,7 +460,7 @@ int BreakCond_MatchCpu(void)
  */
 int BreakCond_MatchDsp(void)
 {
-	return BreakCond_MatchBreakPoints(BreakPointsDsp, BreakPointDspCount, "DSP");
+	return BreakCond_MatchBreakPoints(BreakPointsDsp, BreakPointDspCount, "DSP", 0);
 }
 
 /**
@@ -1158,6 +1267,61 @@ static void BreakCond_CheckTracking(bc_breakpoint_t *bp)
 }
 
 
+/**
+ * Set breakpoint PC if one of its conditions compares the CPU PC
+ * (unmasked) for equality with a constant.
+ */
+static void BreakCond_CheckPC(bc_breakpoint_t *bp)
+{
+	const bc_value_t *pcvalue, *number;
+	bc_condition_t *condition;
+	int i;
+
+	condition = bp->conditions;
+	for (i = 0; i < bp->ccount; condition++, i++) {
+		if (condition->comparison != '=') {
+			continue;
+		}
+		if (condition->lvalue.valuetype == VALUE_TYPE_FUNCTION32) {
+			pcvalue = &(condition->lvalue);
+			number = &(condition->rvalue);
+		} else {
+			pcvalue = &(condition->rvalue);
+			number = &(condition->lvalue);
+		}
+		if (pcvalue->valuetype == VALUE_TYPE_FUNCTION32 &&
+		    pcvalue->value.func32 == GetCpuPC &&
+		    !pcvalue->is_indirect && pcvalue->mask == 0xffffffff &&
+		    number->valuetype == VALUE_TYPE_NUMBER && !number->is_indirect) {
+			bp->has_pc = true;
+			bp->pc = number->value.number & number->mask;
+			return;
+		}
+	}
+}
+
+
+/**
+ * Rebuild the PC bitmap from the current CPU breakpoints
+ */
+static void BreakCond_UpdatePCFilter(void)
+{
+	Uint32 hash;
+	int i;
+
+	memset(BreakPointCpuPcFilter, 0, sizeof(BreakPointCpuPcFilter));
+	BreakPointCpuNoPcCount = 0;
+	for (i = 0; i < BreakPointCpuCount; i++) {
+		if (BreakPointsCpu[i].has_pc) {
+			hash = BC_PC_HASH(BreakPointsCpu[i].pc);
+			BreakPointCpuPcFilter[hash >> 5] |= 1u << (hash & 31);
+		} else {
+			BreakPointCpuNoPcCount++;
+		}
+	}
+}
+
+
 /**
  * Parse given breakpoint expression and store it.
  * Return true for success and false for failure.
@@ -1169,7 +1333,7 @@ static bool BreakCond_Parse(const char *expression, bc_options_t *options, bool
 	const char *name;
 	char *normalized;
 	int *bcount;
-	int ccount;
+	int ccount, n;
 
 	bcount = BreakCond_GetListInfo(&bp, &name, bForDsp);
 	if (*bcount >= BC_MAX_CONDITION_BREAKPOINTS) {
@@ -1196,6 +1360,13 @@ static bool BreakCond_Parse(const char *expression, bc_options_t *options, bool
 		fprintf(stderr, "%s condition breakpoint %d with %d condition(s) added:\n\t%s\n",
 			name, *bcount, ccount, bp->expression);
 		BreakCond_CheckTracking(bp);
+		for (n = 0; n < ccount; n++) {
+			BreakCond_Compile(&(bp->conditions[n]));
+		}
+		if (!bForDsp) {
+			BreakCond_CheckPC(bp);
+			BreakCond_UpdatePCFilter();
+		}
 		if (options->skip) {
             fprintf(stderr, "-> Break only on every %d hit.\n", options->skip);
             bp->options.skip = options->skip;
@@ -1325,6 +1496,9 @@ static bool BreakCond_Remove(int position, bool bForDsp)
 			(*bcount-position)*sizeof(bc_breakpoint_t));
 	}
 	(*bcount)--;
+	if (!bForDsp) {
+		BreakCond_UpdatePCFilter();
+	}
 	return true;
 }
 
@@ -1355,6 +1529,84 @@ int BreakCond_MatchCpuExpression(int position, const char *expression)
 }
 
 
+#if ENABLE_TESTING
+/**
+ * Time CPU breakpoint matching per instruction with 1, 10 and 50 (never
+ * matching) breakpoints, through the compiled and the generic evaluators,
+ * and check that both give the same results.
+ */
+static void BreakCond_Benchmark(void)
+{
+	static const int counts[] = { 1, 10, 50 };
+	const int N = 100000;
+	bc_options_t options;
+	char expression[64];
+	Uint64 t[2];
+	int i, j, k, c, n, hits[2];
+	bool match;
+
+	if (BreakPointCpuCount) {
+		fprintf(stderr, "Remove CPU breakpoints before benchmarking.\n");
+		return;
+	}
+	memset(&options, 0, sizeof(options));
+	for (i = 0; i < 50; i++) {
+		switch (i & 3) {
+		case 0:
+			sprintf(expression, "d%d = $%x", i & 7, 0xdead0000 + i);
+			break;
+		case 1:
+			sprintf(expression, "a%d & $ffff0000 = $%x", i & 7, 0xbeef0000);
+			break;
+		case 2:
+			sprintf(expression, "sr & $ff = $%x", 0x100 + i);
+			break;
+		default:
+			sprintf(expression, "($%x).w > $ffff", 0x04000000 + i * 4);
+			break;
+		}
+		if (!BreakCond_Parse(expression, &options, false)) {
+			break;
+		}
+	}
+	for (k = 0; k < ARRAYSIZE(counts) && counts[k] <= BreakPointCpuCount; k++) {
+		n = counts[k];
+		hits[0] = hits[1] = 0;
+
+		t[0] = host_time_us();
+		for (i = 0; i < N; i++) {
+			for (j = 0; j < n; j++) {
+				hits[0] += BreakCond_MatchConditions(BreakPointsCpu[j].conditions,
+								     BreakPointsCpu[j].ccount);
+			}
+		}
+		t[0] = host_time_us() - t[0];
+
+		t[1] = host_time_us();
+		for (i = 0; i < N; i++) {
+			for (j = 0; j < n; j++) {
+				match = true;
+				for (c = 0; match && c < BreakPointsCpu[j].ccount; c++) {
+					match = BreakCond_MatchGeneric(&BreakPointsCpu[j].conditions[c]);
+				}
+				hits[1] += match;
+			}
+		}
+		t[1] = host_time_us() - t[1];
+
+		fprintf(stderr, "%2d breakpoints: compiled %.1f ns, generic %.1f ns per instruction%s\n",
+			n, t[0] * 1000.0 / N, t[1] * 1000.0 / N,
+			hits[0] == hits[1] ? "" : " - RESULTS DIFFER");
+	}
+	for (i = 0; i < BreakPointCpuCount; i++) {
+		free(BreakPointsCpu[i].expression);
+	}
+	BreakPointCpuCount = 0;
+	BreakCond_UpdatePCFilter();
+}
+#endif
+
+
 /**
  * help
  */
@@ -1519,6 +1771,12 @@ bool BreakCond_Command(const char *args, bool bForDsp)
 		BreakCond_RemoveAll(bForDsp);
 		goto cleanup;
 	}
+#if ENABLE_TESTING
+	if (strcmp(expression, "bench") == 0 && !bForDsp) {
+		BreakCond_Benchmark();
+		goto cleanup;
+	}
+#endif
 
     /* postfix options? */
     if (!BreakCond_Options(expression, &options, ':')) {
@@ -39,6 +39,7 @@ const char DebugUI_fileid[] = "Hatari debugui.c : " __DATE__ " " __TIME__;
 #include "debugui.h"
 #include "evaluate.h"
 #include "symbols.h"
+#include "bench.h"
 
 int bExceptionDebugging;
 
@@ -366,6 +367,23 @@ static int DebugUI_ChangeDir(int argc, char *argv[])
 }
 
 
+#if ENABLE_TESTING
+/**
+ * Command: Run a subsystem benchmark
+ */
+static int DebugUI_Bench(int argc, char *argv[])
+{
+	if (argc == 2 && Bench_Test(argv[1]))
+		return DEBUGGER_CMDDONE;
+
+	DebugUI_PrintCmdHelp(argv[0]);
+	fprintf(stderr, "Benchmarks:\n");
+	Bench_ListTests(stderr);
+	return DEBUGGER_CMDDONE;
+}
+#endif
+
+
 /**
  * Command: Read debugger commands from a file
  */
@@ -722,6 +740,15 @@ static char *DebugUI_GetCommand(char *input)
 static const dbgcommand_t uicommand[] =
 {
 	{ NULL, NULL, "Generic commands", NULL, NULL, NULL, false },
+#if ENABLE_TESTING
+	{ DebugUI_Bench, Bench_MatchTest,
+	  "bench", "",
+	  "run a subsystem benchmark",
+	  "<name>\n"
+	  "\tTime a fast path against its reference implementation and\n"
+	  "\tcheck that their results match. Results go to the log.",
+	  false },
+#endif
 	/* NULL as match function will complete file names */
 	{ DebugUI_ChangeDir, NULL,
 	  "cd", "",
@@ -871,6 +898,12 @@ void DebugUI(void)
 		"\n----------------------------------------------------------------------"
 		"\nYou have entered debug mode. Type c to continue emulation, h for help.\n";
 	
+	/* Benchmark end marker was hit */
+	if (Bench_Active()) {
+		Bench_Finish("breakpoint");
+		return;
+	}
+
 	if (bInFullScreen)
 		Screen_ReturnFromFullScreen();
 
@@ -57,6 +57,26 @@ static struct {
 } dsp_profile;
 
 
+/**
+ * Return tab separated name and offset of the symbol enclosing
+ * given address, or empty string if there's none.
+ */
+static const char* profile_symbol(const char *name, Uint32 offset)
+{
+	static char buf[64];
+
+	if (!name) {
+		return "";
+	}
+	if (offset) {
+		snprintf(buf, sizeof(buf), "\t%s+$%x", name, offset);
+	} else {
+		snprintf(buf, sizeof(buf), "\t%s", name);
+	}
+	return buf;
+}
+
+
 /* ------------------ CPU profile results ----------------- */
 
 /**
@@ -188,7 +208,8 @@ static int profile_by_cpu_cycles(const void *p1, const void *p2)
 void Profile_CpuShowCycles(unsigned int show)
 {
 	unsigned int active;
-	Uint32 *sort_arr, *end, addr;
+	Uint32 *sort_arr, *end, addr, offset;
+	const char *name;
 	profile_item_t *data = cpu_profile.data;
 	float percentage;
 	Uint32 count;
@@ -208,7 +229,9 @@ void Profile_CpuShowCycles(unsigned int show)
 		addr = index2address(*sort_arr);
 		count = data[*sort_arr].cycles;
 		percentage = 100.0*count/cpu_profile.all_cycles;
-		printf("0x%06x\t%.2f%%\t%d%s\n", addr, percentage, count,
+		name = Symbols_GetNearestCpuAddress(addr, &offset);
+		printf("0x%06x\t%.2f%%\t%d%s%s\n", addr, percentage, count,
+		       profile_symbol(name, offset),
 		       count == MAX_PROFILE_VALUE ? " (OVERFLOW)" : "");
 	}
 	printf("%d CPU addresses listed.\n", show);
@@ -241,7 +264,7 @@ void Profile_CpuShowCounts(unsigned int show, bool only_symbols)
 {
 	profile_item_t *data = cpu_profile.data;
 	unsigned int symbols, matched, active;
-	Uint32 *sort_arr, *end, addr;
+	Uint32 *sort_arr, *end, addr, offset;
 	const char *name;
 	float percentage;
 	Uint32 count;
@@ -262,8 +285,9 @@ void Profile_CpuShowCounts(unsigned int show, bool only_symbols)
 			addr = index2address(*sort_arr);
 			count = data[*sort_arr].count;
 			percentage = 100.0*count/cpu_profile.all_count;
-			printf("0x%06x\t%.2f%%\t%d%s\n",
-			       addr, percentage, count,
+			name = Symbols_GetNearestCpuAddress(addr, &offset);
+			printf("0x%06x\t%.2f%%\t%d%s%s\n",
+			       addr, percentage, count, profile_symbol(name, offset),
 			       count == MAX_PROFILE_VALUE ? " (OVERFLOW)" : "");
 		}
 		printf("%d CPU addresses listed.\n", show);
@@ -563,6 +587,8 @@ void Profile_DspShowCycles(unsigned int show)
 {
 	unsigned int active;
 	Uint16 *sort_arr, *end, addr;
+	const char *name;
+	Uint32 offset;
 	profile_item_t *data = dsp_profile.data;
 	float percentage;
 	Uint32 count;
@@ -582,7 +608,9 @@ void Profile_DspShowCycles(unsigned int show)
 		addr = *sort_arr;
 		count = data[addr].cycles;
 		percentage = 100.0*count/dsp_profile.ram.all_cycles;
-		printf("0x%04x\t%.2f%%\t%d%s\n", addr, percentage, count,
+		name = Symbols_GetNearestDspAddress(addr, &offset);
+		printf("0x%04x\t%.2f%%\t%d%s%s\n", addr, percentage, count,
+		       profile_symbol(name, offset),
 		       count == MAX_PROFILE_VALUE ? " (OVERFLOW)" : "");
 	}
 	printf("%d DSP addresses listed.\n", show);
@@ -617,6 +645,7 @@ void Profile_DspShowCounts(unsigned int show, bool only_symbols)
 	unsigned int symbols, matched, active;
 	Uint16 *sort_arr, *end, addr;
 	const char *name;
+	Uint32 offset;
 	float percentage;
 	Uint32 count;
 
@@ -636,8 +665,9 @@ void Profile_DspShowCounts(unsigned int show, bool only_symbols)
 			addr = *sort_arr;
 			count = data[addr].count;
 			percentage = 100.0*count/dsp_profile.ram.all_count;
-			printf("0x%04x\t%.2f%%\t%d%s\n",
-			       addr, percentage, count,
+			name = Symbols_GetNearestDspAddress(addr, &offset);
+			printf("0x%04x\t%.2f%%\t%d%s%s\n",
+			       addr, percentage, count, profile_symbol(name, offset),
 			       count == MAX_PROFILE_VALUE ? " (OVERFLOW)" : "");
 		}
 		printf("%d DSP addresses listed.\n", show);
@@ -33,10 +33,27 @@ typedef struct {
 	symtype_t type;
 } symbol_t;
 
+/* Address -> symbol lookups go through a direct mapped cache of
+ * SYMBOLS_PAGE_SIZE byte pages, which stores the index of the last
+ * symbol at or before the page start.
+ */
+#define SYMBOLS_PAGE_SHIFT 8
+#define SYMBOLS_CACHE_SIZE 1024
+#define SYMBOLS_NO_PAGE 0xFFFFFFFF
+
+/* addresses further than this from the previous symbol aren't its part */
+#define SYMBOLS_MAX_OFFSET 0x10000
+
+typedef struct {
+	Uint32 page;	/* address >> SYMBOLS_PAGE_SHIFT */
+	int index;	/* -1 if no symbol before page start */
+} symbol_page_t;
+
 typedef struct {
 	unsigned int count;
 	symbol_t *addresses;	/* items sorted by address */
 	symbol_t *names;	/* items sorted by symbol name */
+	symbol_page_t cache[SYMBOLS_CACHE_SIZE];
 } symbol_list_t;
 
 
@@ -199,6 +216,10 @@ static symbol_list_t* Symbols_Load(const char *filename, Uint32 offset, Uint32 m
 	qsort(list->addresses, count, sizeof(symbol_t), symbols_by_address);
 	qsort(list->names, count, sizeof(symbol_t), symbols_by_name);
 
+	for (line = 0; line < SYMBOLS_CACHE_SIZE; line++) {
+		list->cache[line].page = SYMBOLS_NO_PAGE;
+	}
+
 	fclose(fp);
 	fprintf(stderr, "Loaded %d symbols from '%s'.\n", count, filename);
 	return list;
@@ -365,36 +386,75 @@ bool Symbols_GetDspAddress(symtype_t symtype, const char *name, Uint32 *addr)
 /* ---------------- symbol address -> name search ------------------ */
 
 /**
- * Search symbol by address.
- * Return symbol name if address matches, NULL otherwise.
+ * Bisect index of the last symbol at or before given address.
+ * Return -1 if all symbols are after it.
  */
-static const char* Symbols_SearchByAddress(symbol_list_t* list, Uint32 addr)
+static int Symbols_SearchIndex(symbol_list_t* list, Uint32 addr)
 {
-	symbol_t *entries;
+	symbol_t *entries = list->addresses;
 	/* left, right, middle */
-        int l, r, m;
-	Uint32 curr;
-
-	if (!list) {
-		return NULL;
-	}
-	entries = list->addresses;
+	int l, r, m;
 
-	/* bisect */
 	l = 0;
 	r = list->count - 1;
-	do {
+	while (l <= r) {
 		m = (l+r) >> 1;
-		curr = entries[m].address;
-		if (curr == addr) {
-			return (const char*)entries[m].name;
-		}
-		if (curr > addr) {
+		if (entries[m].address > addr) {
 			r = m-1;
 		} else {
 			l = m+1;
 		}
-	} while (l <= r);
+	}
+	return r;
+}
+
+/**
+ * Search symbol enclosing given address, i.e. the last symbol at or
+ * before it, and set offset from its start.
+ * Return symbol or NULL if there's none.
+ */
+static const symbol_t* Symbols_SearchNearest(symbol_list_t* list, Uint32 addr, Uint32 *offset)
+{
+	symbol_page_t *page;
+	symbol_t *entries;
+	int i, last;
+
+	if (!list) {
+		return NULL;
+	}
+	entries = list->addresses;
+	last = list->count - 1;
+
+	page = &(list->cache[(addr >> SYMBOLS_PAGE_SHIFT) & (SYMBOLS_CACHE_SIZE-1)]);
+	if (page->page != addr >> SYMBOLS_PAGE_SHIFT) {
+		page->page = addr >> SYMBOLS_PAGE_SHIFT;
+		page->index = Symbols_SearchIndex(list, addr & ~((1 << SYMBOLS_PAGE_SHIFT) - 1));
+	}
+	/* skip symbols inside the page before the address */
+	i = page->index;
+	while (i < last && entries[i+1].address <= addr) {
+		i++;
+	}
+	if (i < 0 || addr - entries[i].address >= SYMBOLS_MAX_OFFSET) {
+		return NULL;
+	}
+	*offset = addr - entries[i].address;
+	return &(entries[i]);
+}
+
+/**
+ * Search symbol by address.
+ * Return symbol name if address matches, NULL otherwise.
+ */
+static const char* Symbols_SearchByAddress(symbol_list_t* list, Uint32 addr)
+{
+	const symbol_t *entry;
+	Uint32 offset;
+
+	entry = Symbols_SearchNearest(list, addr, &offset);
+	if (entry && offset == 0) {
+		return (const char*)entry->name;
+	}
 	return NULL;
 }
 
@@ -417,6 +477,27 @@ const char* Symbols_GetByDspAddress(Uint32 addr)
 	return Symbols_SearchByAddress(DspSymbolsList, addr);
 }
 
+/**
+ * Search CPU symbol enclosing given address and set offset from its start.
+ * Return symbol name or NULL if there's none.
+ * Returned name is valid only until next Symbols_* function call.
+ */
+const char* Symbols_GetNearestCpuAddress(Uint32 addr, Uint32 *offset)
+{
+	const symbol_t *entry = Symbols_SearchNearest(CpuSymbolsList, addr, offset);
+	return entry ? (const char*)entry->name : NULL;
+}
+/**
+ * Search DSP symbol enclosing given address and set offset from its start.
+ * Return symbol name or NULL if there's none.
+ * Returned name is valid only until next Symbols_* function call.
+ */
+const char* Symbols_GetNearestDspAddress(Uint32 addr, Uint32 *offset)
+{
+	const symbol_t *entry = Symbols_SearchNearest(DspSymbolsList, addr, offset);
+	return entry ? (const char*)entry->name : NULL;
+}
+
 
 /* ---------------- symbol showing and command parsing ------------------ */
 
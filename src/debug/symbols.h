@@ -31,6 +31,9 @@ extern bool Symbols_GetDspAddress(symtype_t symtype, const char *name, Uint32 *a
 /* symbol address -> name search */
 extern const char* Symbols_GetByCpuAddress(Uint32 addr);
 extern const char* Symbols_GetByDspAddress(Uint32 addr);
+/* symbol address -> enclosing symbol name & offset search */
+extern const char* Symbols_GetNearestCpuAddress(Uint32 addr, Uint32 *offset);
+extern const char* Symbols_GetNearestDspAddress(Uint32 addr, Uint32 *offset);
 /* symbols/dspsymbols command parsing */
 extern int Symbols_Command(int nArgc, char *psArgs[]);
 /* how many symbols are loaded */
@@ -8,10 +8,6 @@
 #include "nd_nbic.h"
 #include "nd_sdl.h"
 
-Uint8  ND_ram[64*1024*1024];
-Uint8  ND_rom[128*1024];
-Uint8  ND_vram[4*1024*1024];
-
 /* NeXTdimension board and slot memory */
 #define ND_BOARD_SIZE	0x10000000
 #define ND_BOARD_MASK	0x0FFFFFFF
@@ -23,6 +19,21 @@ Uint8  ND_vram[4*1024*1024];
 
 #define ND_NBIC_SPACE   0xFFFFFFE8
 
+/* NeXTdimension boards */
+NextDimension nd_boards[ND_MAX_BOARDS] = {
+    { 0, ND_SLOT(0) }, { 1, ND_SLOT(1) }, { 2, ND_SLOT(2) }
+};
+ND_THREAD_LOCAL NextDimension* nd_current = &nd_boards[0];
+
+int nd_num_boards(void) {
+    return ConfigureParams.Dimension.nNumBoards;
+}
+
+/* Select the board addressed by the m68k */
+static inline void nd_select_board(int slot) {
+    nd_current = &nd_boards[ND_NUM(slot)];
+}
+
 /* NeXTdimension board memory access (i860) */
 
 void   nd_board_rd8_be(Uint32 addr, Uint32* val) {
@@ -144,6 +155,7 @@ void   nd_board_wr128_le(Uint32 addr, const Uint32* val) {
 /* NeXTdimension board memory access (m68k) */
 
 inline Uint32 nd_board_lget(Uint32 addr) {
+    nd_select_board(addr>>28);
     addr |= ND_BOARD_BITS;
     Uint32 result = nd_longget(addr);
     // (SC) delay m68k read on csr0 while in ROM (CS8=1)to give ND some time to start up.
@@ -153,26 +165,31 @@ inline Uint32 nd_board_lget(Uint32 addr) {
 }
 
 inline Uint16 nd_board_wget(Uint32 addr) {
+    nd_select_board(addr>>28);
     addr |= ND_BOARD_BITS;
     return nd_wordget(addr);
 }
 
 inline Uint8 nd_board_bget(Uint32 addr) {
+    nd_select_board(addr>>28);
     addr |= ND_BOARD_BITS;
     return nd_byteget(addr);
 }
 
 inline void nd_board_lput(Uint32 addr, Uint32 l) {
+    nd_select_board(addr>>28);
     addr |= ND_BOARD_BITS;
     nd_longput(addr, l);
 }
 
 inline void nd_board_wput(Uint32 addr, Uint16 w) {
+    nd_select_board(addr>>28);
     addr |= ND_BOARD_BITS;
     nd_wordput(addr, w);
 }
 
 inline void nd_board_bput(Uint32 addr, Uint8 b) {
+    nd_select_board(addr>>28);
     addr |= ND_BOARD_BITS;
     nd_byteput(addr, b);
 }
@@ -184,6 +201,7 @@ inline Uint8 nd_board_cs8get(Uint32 addr) {
 
 /* NeXTdimension slot memory access */
 Uint32 nd_slot_lget(Uint32 addr) {
+    nd_select_board((addr>>24)&0xF);
     addr |= ND_SLOT_BITS;
     
     if (addr<ND_NBIC_SPACE) {
@@ -194,6 +212,7 @@ Uint32 nd_slot_lget(Uint32 addr) {
 }
 
 Uint16 nd_slot_wget(Uint32 addr) {
+    nd_select_board((addr>>24)&0xF);
     addr |= ND_SLOT_BITS;
     
     if (addr<ND_NBIC_SPACE) {
@@ -204,6 +223,7 @@ Uint16 nd_slot_wget(Uint32 addr) {
 }
 
 Uint8 nd_slot_bget(Uint32 addr) {
+    nd_select_board((addr>>24)&0xF);
     addr |= ND_SLOT_BITS;
     
     if (addr<ND_NBIC_SPACE) {
@@ -214,6 +234,7 @@ Uint8 nd_slot_bget(Uint32 addr) {
 }
 
 void nd_slot_lput(Uint32 addr, Uint32 l) {
+    nd_select_board((addr>>24)&0xF);
     addr |= ND_SLOT_BITS;
     
     if (addr<ND_NBIC_SPACE) {
@@ -224,6 +245,7 @@ void nd_slot_lput(Uint32 addr, Uint32 l) {
 }
 
 void nd_slot_wput(Uint32 addr, Uint16 w) {
+    nd_select_board((addr>>24)&0xF);
     addr |= ND_SLOT_BITS;
     
     if (addr<ND_NBIC_SPACE) {
@@ -234,6 +256,7 @@ void nd_slot_wput(Uint32 addr, Uint16 w) {
 }
 
 void nd_slot_bput(Uint32 addr, Uint8 b) {
+    nd_select_board((addr>>24)&0xF);
     addr |= ND_SLOT_BITS;
     
     if (addr<ND_NBIC_SPACE) {
@@ -246,22 +269,34 @@ void nd_slot_bput(Uint32 addr, Uint8 b) {
 /* Pause and resume function */
 
 void dimension_pause(bool pause) {
-    nd_i860_pause(pause);
-    nd_sdl_pause(pause);
+    int i;
+    for (i = 0; i < nd_num_boards(); i++) {
+        nd_current = &nd_boards[i];
+        nd_i860_pause(pause);
+        nd_sdl_pause(pause);
+    }
 }
 
 /* Reset function */
 
 void dimension_init(void) {
-    nd_i860_uninit();
-    nd_nbic_init();
-    nd_devs_init();
-    nd_memory_init();
-    nd_i860_init();
-    nd_sdl_init();
+    int i;
+    dimension_uninit();
+    for (i = 0; i < nd_num_boards(); i++) {
+        nd_current = &nd_boards[i];
+        nd_nbic_init();
+        nd_devs_init();
+        nd_memory_init();
+        nd_i860_init();
+        nd_sdl_init();
+    }
 }
 
 void dimension_uninit(void) {
-	nd_i860_uninit();
-    nd_sdl_uninit();
+    int i;
+    for (i = 0; i < ND_MAX_BOARDS; i++) {
+        nd_current = &nd_boards[i];
+        nd_i860_uninit();
+        nd_sdl_uninit();
+    }
 }
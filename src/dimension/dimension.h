@@ -3,7 +3,16 @@
 #ifndef __DIMENSION_H__
 #define __DIMENSION_H__
 
-#define ND_SLOT 2
+/* Up to three NeXTdimension boards in slots 2, 4 and 6 */
+#define ND_MAX_BOARDS   3
+#define ND_SLOT(num)    (2+2*(num))
+#define ND_NUM(slot)    (((slot)-2)>>1)
+
+#ifdef _MSC_VER
+#define ND_THREAD_LOCAL __declspec(thread)
+#else
+#define ND_THREAD_LOCAL __thread
+#endif
 
 /* NeXTdimension memory controller revision (0 and 1 allowed) */
 #define ND_STEP 1
@@ -47,9 +56,21 @@ void   nd_board_wr32_be (Uint32 addr, const Uint32* val);
 void   nd_board_wr64_be (Uint32 addr, const Uint32* val);
 void   nd_board_wr128_be(Uint32 addr, const Uint32* val);
 
-extern Uint8  ND_ram[64*1024*1024];
-extern Uint8  ND_rom[128*1024];
-extern Uint8  ND_vram[4*1024*1024];
+/* Per-board state. Each i860 thread works on its own board, the m68k
+ * selects a board by slot address before accessing it. */
+typedef struct {
+    int    num;
+    int    slot;
+    Uint8* ram;
+    Uint8* vram;
+    Uint8  rom[128*1024];
+    Uint8  dmem[512];
+} NextDimension;
+
+extern NextDimension nd_boards[ND_MAX_BOARDS];
+extern ND_THREAD_LOCAL NextDimension* nd_current;
+
+int  nd_num_boards(void);
 
 typedef void (*i860_run_func)(int);
 extern i860_run_func i860_Run;
@@ -62,8 +83,13 @@ void nd_i860_uninit(void);
 void nd_i860_pause(bool pause);
 void i860_reset(void);
 void i860_interrupt(void);
+void nd_display_blank(int slot);
+void nd_video_blank(int slot);
 void nd_start_debugger(void);
 const char* nd_reports(double realTime, double hostTime);
+Uint64 nd_insn_count(void);
+void nd_i860_fpu_bench(void);   /* ENABLE_TESTING builds only */
+void nd_i860_pixel_bench(void); /* ENABLE_TESTING builds only */
 
 #define ND_LOG_IO_RD LOG_NONE
 #define ND_LOG_IO_WR LOG_NONE
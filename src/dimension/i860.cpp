@@ -17,7 +17,15 @@
 
 #include "i860.hpp"
 
-static i860_cpu_device nd_i860;
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+static i860_cpu_device nd_i860[ND_MAX_BOARDS];
+
+ND_THREAD_LOCAL int i860_host_fpu_force = -1;
 
 extern "C" {
     
@@ -30,15 +38,19 @@ extern "C" {
     }
 
     static void i860_run_no_thread(int nHostCycles) {
-        nd_i860.handle_msgs();
-        
-        if(nd_i860.is_halted()) return;
-        
         nHostCycles *= 33; // i860 @ 33MHz
         nHostCycles /= ConfigureParams.System.nCpuFreq;
-        while (nHostCycles > 0) {
-            nd_i860.run_cycle();
-            nHostCycles -= 2;
+        
+        for(int i = 0; i < nd_num_boards(); i++) {
+            nd_current = &nd_boards[i];
+            nd_i860[i].handle_msgs();
+            
+            if(nd_i860[i].is_halted()) continue;
+            
+            /* The boards share this thread and its rounding mode */
+            nd_i860[i].load_fp_mode();
+            for(int cycles = nHostCycles; cycles > 0; cycles -= 2)
+                nd_i860[i].run_cycle();
         }
         
         nd_nbic_interrupt();
@@ -46,19 +58,19 @@ extern "C" {
     
     void nd_i860_init() {
         i860_Run = ConfigureParams.Dimension.bI860Thread ? i860_run_thread : i860_run_no_thread;
-        nd_i860.init();
+        nd_i860[nd_current->num].init();
     }
 	
 	void nd_i860_uninit() {
-        nd_i860.uninit();
+        nd_i860[nd_current->num].uninit();
 	}
     
     void nd_i860_pause(bool state) {
-        nd_i860.pause(state);
+        nd_i860[nd_current->num].pause(state);
     }
 	    
     void nd_start_debugger(void) {
-        nd_i860.send_msg(MSG_DBG_BREAK);
+        nd_i860[0].send_msg(MSG_DBG_BREAK);
     }
     
     int i860_thread(void* data) {
@@ -68,29 +80,51 @@ extern "C" {
     }
     
     void i860_reset() {
-        nd_i860.send_msg(MSG_I860_RESET);
+        nd_i860[nd_current->num].send_msg(MSG_I860_RESET);
     }
 
-    void nd_display_blank() {
-        nd_i860.send_msg(MSG_DISPLAY_BLANK);
+    void nd_display_blank(int slot) {
+        nd_i860[ND_NUM(slot)].send_msg(MSG_DISPLAY_BLANK);
     }
 
-    void nd_video_blank() {
-        nd_i860.send_msg(MSG_VIDEO_BLANK);
+    void nd_video_blank(int slot) {
+        nd_i860[ND_NUM(slot)].send_msg(MSG_VIDEO_BLANK);
     }
 
     void i860_interrupt() {
-        nd_i860.interrupt();
+        nd_i860[nd_current->num].interrupt();
     }
     
     const char* nd_reports(double realTime, double hostTime) {
-        return nd_i860.reports(realTime, hostTime);
+        static char report[ND_MAX_BOARDS * 1040];
+        char*       r = report;
+        
+        if(nd_num_boards() == 1)
+            return nd_i860[0].reports(realTime, hostTime);
+        
+        report[0] = 0;
+        for(int i = 0; i < nd_num_boards(); i++) {
+            const char* board = nd_i860[i].reports(realTime, hostTime);
+            if(board[0])
+                r += sprintf(r, "%sslot%d:%s", r == report ? "" : " ", ND_SLOT(i), board);
+        }
+        return report;
+    }
+    
+    Uint64 nd_insn_count(void) {
+        Uint64 count = 0;
+        for(int i = 0; i < nd_num_boards(); i++)
+            count += nd_i860[i].insn_count();
+        return count;
     }
 }
 
 i860_cpu_device::i860_cpu_device() {
     m_thread = NULL;
+    m_nd     = NULL;
     m_halt   = true;
+    m_port   = MSG_NONE;
+    m_insn_count = 0;
     
     for(int i = 0; i < 8192; i++) {
         int upper6 = i >> 7;
@@ -172,9 +206,7 @@ inline void i860_cpu_device::SET_PSR_CC(int val) {
 }
 
 void i860_cpu_device::send_msg(int msg) {
-    host_lock(&m_port_lock);
-    m_port |= msg;
-    host_unlock(&m_port_lock);
+    m_port.fetch_or(msg, std::memory_order_release);
 }
 
 void i860_cpu_device::handle_trap(UINT32 savepc) {
@@ -432,6 +464,100 @@ int i860_cpu_device::memtest(bool be) {
     return 0;
 }
 
+#if ENABLE_TESTING
+/* Random float64 with exponents clustered around the denormal, overflow
+   and unity ranges, so that all fallback cases get exercised. */
+static float64 fputest_rand64(UINT64* seed) {
+    static const int EXP[8] = {0x000, 0x001, 0x002, 0x3FF, 0x400, 0x7FD, 0x7FE, 0x7FF};
+    UINT64 x = *seed;
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    *seed = x;
+    int e = (x >> 60) & 7;
+    int exp = (e < 6) ? (EXP[x >> 52 & 7] + (int)(x >> 56 & 3) - 1) & 0x7FF : (x >> 52) & 0x7FF;
+    return (x & LIT64(0x800FFFFFFFFFFFFF)) | ((UINT64)exp << 52);
+}
+
+static float32 fputest_rand32(UINT64* seed) {
+    float64 d = fputest_rand64(seed);
+    int     exp = ((d >> 52) & 0x7FF) - 0x3FF + 0x7F;
+    return (float32)((d >> 32) & 0x80000000) | ((UINT32)exp & 0xFF) << 23 | (UINT32)(d & 0x7FFFFF);
+}
+
+/* Check the host FPU fast path bit for bit against softfloat and compare
+   their throughput on a 4x4 matrix transform, the inner loop of the
+   NeXTdimension graphics code. The configuration is left alone, a
+   mismatch is only reported. Run with the debugger "bench i860fpu"
+   command. */
+extern "C" void nd_i860_fpu_bench(void) {
+    const int N = 100000;
+    int8      mode = float_rounding_mode2;
+    int8      flags = float_exception_flags;
+    int8      flags2 = float_exception_flags2;
+    UINT64    seed = 0x0123456789ABCDEFULL;
+    int       err  = 0;
+    float64   r[2];
+    float32   s[2];
+
+    float_set_rounding_mode(0);
+    for(int i = 0; i < N; i++) {
+        float64 a = fputest_rand64(&seed), b = fputest_rand64(&seed);
+        float32 c = fputest_rand32(&seed), d = fputest_rand32(&seed);
+        for(int k = 0; k < 7; k++) {
+            for(int h = 0; h < 2; h++) {
+                i860_host_fpu_force = h;
+                switch(k) {
+                    case 0: r[h] = float64_add(a, b); s[h] = float32_add(c, d); break;
+                    case 1: r[h] = float64_sub(a, b); s[h] = float32_sub(c, d); break;
+                    case 2: r[h] = float64_mul(a, b); s[h] = float32_mul(c, d); break;
+                    case 3: r[h] = float64_div(a, b); s[h] = float32_div(c, d); break;
+                    case 4: r[h] = float64_sqrt(a);   s[h] = float32_sqrt(c);   break;
+                    case 5: r[h] = float32_to_float64(c); s[h] = float64_to_float32(a); break;
+                    case 6: r[h] = float64_div(FLOAT64_ONE, float64_sqrt(b)); s[h] = float32_div(FLOAT32_ONE, float32_sqrt(d)); break;
+                }
+            }
+            if(r[0] != r[1] || s[0] != s[1]) {
+                if(err++ < 8)
+                    Log_Printf(LOG_WARN, "[i860] Host FPU mismatch op %d: %016" FMT_ll "X %016" FMT_ll "X %08X %08X",
+                               k, (unsigned long long)a, (unsigned long long)b, c, d);
+            }
+        }
+    }
+
+    double mflops[2];
+    for(int h = 0; h < 2; h++) {
+        float64 m[16], v[4] = {FLOAT64_ONE, FLOAT64_ONE, FLOAT64_ONE, FLOAT64_ONE};
+        for(int i = 0; i < 16; i++) {
+            /* rows sum up to one, so v stays in the normal range */
+            float64 q = float32_to_float64(0x3E800000);
+            float64 d = float32_to_float64(0x3C000000 + ((i >> 2) << 18) + 0x1234);
+            m[i] = (i & 1) ? float64_add(q, d) : float64_sub(q, d);
+        }
+        i860_host_fpu_force = h;
+        Uint64 t = host_time_us();
+        for(int i = 0; i < N; i++) {
+            float64 o[4];
+            for(int row = 0; row < 4; row++) {
+                o[row] = float64_mul(m[row*4+0], v[0]);
+                o[row] = float64_add(o[row], float64_mul(m[row*4+1], v[1]));
+                o[row] = float64_add(o[row], float64_mul(m[row*4+2], v[2]));
+                o[row] = float64_add(o[row], float64_mul(m[row*4+3], v[3]));
+            }
+            memcpy(v, o, sizeof(v));
+        }
+        t = host_time_us() - t;
+        mflops[h] = (N * 28.0) / (t ? t : 1);
+    }
+
+    /* Back to the guest settings */
+    float_rounding_mode2   = mode;
+    float_exception_flags  = flags;
+    float_exception_flags2 = flags2;
+    i860_host_fpu_force    = -1;
+    Log_Printf(LOG_WARN, "[i860] Host FPU: %d mismatches in %d operations, %.1f Mflops softfloat, %.1f Mflops host",
+               err, N * 7 * 2, mflops[0], mflops[1]);
+}
+#endif
+
 void i860_cpu_device::init() {
     /* Configurations - keep in sync with i860cfg.h */
     static const char* CFGS[8];
@@ -532,12 +658,16 @@ error:
         exit(err);
     }
 
+    m_nd = nd_current;
+    
     send_msg(MSG_I860_RESET);
     if(ConfigureParams.Dimension.bI860Thread)
         m_thread = host_thread_create(i860_thread, this);
 }
 
 void i860_cpu_device::uninit() {
+    if(!(m_nd)) return; // never initialized
+    
 	halt(true);
 
     if(m_thread) {
@@ -550,10 +680,15 @@ void i860_cpu_device::uninit() {
 
 /* Message disaptcher - executed on i860 thread, safe to call i860 methods */
 bool i860_cpu_device::handle_msgs() {
-    host_lock(&m_port_lock);
-    int msg = m_port;
-    m_port = 0;
-    host_unlock(&m_port_lock);
+    /* Cheap poll, only drain the port if something is pending */
+    if(m_port.load(std::memory_order_relaxed) == 0)
+        return true;
+    
+    int msg = m_port.exchange(0, std::memory_order_acquire);
+
+#if ENABLE_PERF_COUNTERS
+    m_msgs++;
+#endif
     
     if(msg & MSG_I860_KILL)
         return false;
@@ -563,15 +698,19 @@ bool i860_cpu_device::handle_msgs() {
     else if(msg & MSG_INTR)
         intr();
     if(msg & MSG_DISPLAY_BLANK)
-        nd_set_blank_state(ND_DISPLAY, host_blank_state(ND_SLOT, ND_DISPLAY));
+        nd_set_blank_state(ND_DISPLAY, host_blank_state(m_nd->slot, ND_DISPLAY));
     if(msg & MSG_VIDEO_BLANK)
-        nd_set_blank_state(ND_VIDEO, host_blank_state(ND_SLOT, ND_VIDEO));
+        nd_set_blank_state(ND_VIDEO, host_blank_state(m_nd->slot, ND_VIDEO));
     if(msg & MSG_DBG_BREAK)
         debugger('d', "BREAK at pc=%08X", m_pc);
     return true;
 }
 
 void i860_cpu_device::run() {
+    /* This thread only ever works on its own board */
+    nd_current = m_nd;
+    load_fp_mode();
+    
     while(handle_msgs()) {
         
         /* Sleep a bit if halted */
@@ -586,6 +725,10 @@ void i860_cpu_device::run() {
     }
 }
 
+void i860_cpu_device::load_fp_mode() {
+    float_set_rounding_mode(GET_FSR_RM());
+}
+
 void i860_cpu_device::interrupt() {
     send_msg(MSG_INTR);
 }
@@ -597,13 +740,14 @@ const char* i860_cpu_device::reports(double realTime, double hostTime) {
         m_report[0] = 0;
     } else {
         if(dVT == 0) dVT = 0.0001;
-        sprintf(m_report, "i860:{MIPS=%.1f icache_hit=%lld%% tlb_hit=%lld%% icach_inval/s=%.0f tlb_inval/s=%.0f intr/s=%0.f}",
+        sprintf(m_report, "i860:{MIPS=%.1f icache_hit=%lld%% tlb_hit=%lld%% icach_inval/s=%.0f tlb_inval/s=%.0f intr/s=%0.f msg/s=%.0f}",
                                (m_insn_decoded / (dVT*1000*1000)),
                                m_icache_hit+m_icache_miss == 0 ? 0 : (100 * m_icache_hit) / (m_icache_hit+m_icache_miss) ,
                                m_tlb_hit+m_tlb_miss       == 0 ? 0 : (100 * m_tlb_hit)    / (m_tlb_hit+m_tlb_miss),
                                (m_icache_inval)/dVT,
                                (m_tlb_inval)/dVT,
-                               (m_intrs)/dVT
+                               (m_intrs)/dVT,
+                               (m_msgs)/dVT
                                );
         
         m_insn_decoded  = 0;
@@ -614,6 +758,7 @@ const char* i860_cpu_device::reports(double realTime, double hostTime) {
         m_tlb_miss      = 0;
         m_tlb_inval     = 0;
         m_intrs         = 0;
+        m_msgs          = 0;
 
         m_last_rt = realTime;
         m_last_vt = hostTime;
@@ -27,13 +27,13 @@
 #include <unistd.h>
 #include <ctype.h>
 #include <assert.h>
+#include <atomic>
 
 #include "i860cfg.h"
 #include "host.h"
 #include "nd_sdl.h"
 
 const int LOG_WARN = 3;
-const int ND_SLOT  = 2; // HACK: one day we should put the whole ND in a C++ class or make an array of NeXTbus slots
 
 extern "C" void Log_Printf(int nType, const char *psFormat, ...);
 
@@ -68,6 +68,8 @@ extern "C" {
 extern "C" {
 #include <softfloat.h>
 }
+#include <math.h>
+#include <float.h>
 typedef float32 FLOAT32;
 typedef float64 FLOAT64;
 
@@ -89,6 +91,79 @@ static inline void float_set_rounding_mode (int mode) {
     }
 }
 
+/* Host FPU fast path. With round to nearest, IEEE-754 hosts produce the
+   same bits as softfloat for normal operands and results, so those are
+   computed natively. Denormals, infinities, NaNs and other rounding modes
+   are left to softfloat. Hosts with excess precision always use softfloat.
+   The FPU benchmark selects the path for its own thread with
+   i860_host_fpu_force, -1 follows the configuration. */
+extern ND_THREAD_LOCAL int i860_host_fpu_force;
+#if FLT_EVAL_METHOD == 0
+#define FLOAT_HOST_I860 ((i860_host_fpu_force < 0 ? ConfigureParams.Dimension.bI860HostFPU : i860_host_fpu_force) && \
+                         float_rounding_mode2 == float_round_nearest_even)
+#else
+#define FLOAT_HOST_I860 0
+#endif
+
+static inline bool float32_is_host (float32 a) {
+    bits32 e = a & 0x7F800000;
+    return e ? e != 0x7F800000 : !(a & 0x007FFFFF);
+}
+static inline bool float64_is_host (float64 a) {
+    bits64 e = a & LIT64(0x7FF0000000000000);
+    return e ? e != LIT64(0x7FF0000000000000) : !(a & LIT64(0x000FFFFFFFFFFFFF));
+}
+
+#define FLOAT_HOST_OP2(T, H, name, op)                                     \
+static inline T i860_##name (T a, T b) {                                   \
+    if (FLOAT_HOST_I860 && T##_is_host(a) && T##_is_host(b)) {             \
+        H x, y; T r;                                                       \
+        memcpy(&x, &a, sizeof(x)); memcpy(&y, &b, sizeof(y));              \
+        x = x op y;                                                        \
+        memcpy(&r, &x, sizeof(r));                                         \
+        if (T##_is_host(r)) return r;                                      \
+    }                                                                      \
+    return name(a, b);                                                     \
+}
+
+#define FLOAT_HOST_OP1(T, H, R, HR, name, expr)                            \
+static inline R i860_##name (T a) {                                        \
+    if (FLOAT_HOST_I860 && T##_is_host(a)) {                               \
+        H x; HR y; R r;                                                    \
+        memcpy(&x, &a, sizeof(x));                                         \
+        y = expr;                                                          \
+        memcpy(&r, &y, sizeof(r));                                         \
+        if (R##_is_host(r)) return r;                                      \
+    }                                                                      \
+    return name(a);                                                        \
+}
+
+FLOAT_HOST_OP2(float32, float,  float32_add, +)
+FLOAT_HOST_OP2(float32, float,  float32_sub, -)
+FLOAT_HOST_OP2(float32, float,  float32_mul, *)
+FLOAT_HOST_OP2(float32, float,  float32_div, /)
+FLOAT_HOST_OP2(float64, double, float64_add, +)
+FLOAT_HOST_OP2(float64, double, float64_sub, -)
+FLOAT_HOST_OP2(float64, double, float64_mul, *)
+FLOAT_HOST_OP2(float64, double, float64_div, /)
+FLOAT_HOST_OP1(float32, float,  float32, float,  float32_sqrt, sqrtf(x))
+FLOAT_HOST_OP1(float64, double, float64, double, float64_sqrt, sqrt(x))
+FLOAT_HOST_OP1(float32, float,  float64, double, float32_to_float64, (double)x)
+FLOAT_HOST_OP1(float64, double, float32, float,  float64_to_float32, (float)x)
+
+#define float32_add             i860_float32_add
+#define float32_sub             i860_float32_sub
+#define float32_mul             i860_float32_mul
+#define float32_div             i860_float32_div
+#define float32_sqrt            i860_float32_sqrt
+#define float32_to_float64      i860_float32_to_float64
+#define float64_add             i860_float64_add
+#define float64_sub             i860_float64_sub
+#define float64_mul             i860_float64_mul
+#define float64_div             i860_float64_div
+#define float64_sqrt            i860_float64_sqrt
+#define float64_to_float32      i860_float64_to_float32
+
 #else // NATIVE FLOAT
 
 #include <math.h>
@@ -416,23 +491,28 @@ public:
     void    run_cycle();
     /* Run the i860 thread */
     void run();
+    /* Select this board's rounding mode on the calling thread */
+    void   load_fp_mode();
     /* i860 thread message handler */
     bool   handle_msgs();
     /* External interrupt for i860 emulator */
     void   interrupt();
     
     const char* reports(double realTime, double hostTIme);
+    inline UINT64 insn_count() {return m_insn_count;};
 private:
     // debugger
     void debugger(char cmd, const char* format, ...);
     void debugger();
     
     /* Message port for host->i860 communication */
-    volatile int m_port;
-    lock_t       m_port_lock;
-    thread_t*    m_thread;
+    std::atomic<int> m_port;
+    thread_t*        m_thread;
+    /* The board this i860 belongs to */
+    NextDimension*   m_nd;
 
     UINT64 m_insn_decoded;
+    UINT64 m_insn_count;    /* total, always counted */
     UINT64 m_icache_hit;
     UINT64 m_icache_miss;
     UINT64 m_icache_inval;
@@ -440,6 +520,7 @@ private:
     UINT64 m_tlb_miss;
     UINT64 m_tlb_inval;
     UINT64 m_intrs;
+    UINT64 m_msgs;
     UINT32 m_last_rt;
     UINT32 m_last_vt;
     char   m_report[1024];
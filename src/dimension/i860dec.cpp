@@ -897,6 +897,26 @@ void i860_cpu_device::insn_fldy (UINT32 insn)
 }
 
 
+/* Byte enables for pst.d, indexed by the PM bits of one 64-bit store.  */
+static const UINT8 pstd_wmask16[16] = {
+	0x00, 0x03, 0x0c, 0x0f, 0x30, 0x33, 0x3c, 0x3f,
+	0xc0, 0xc3, 0xcc, 0xcf, 0xf0, 0xf3, 0xfc, 0xff
+};
+static const UINT8 pstd_wmask32[4] = { 0x00, 0x0f, 0xf0, 0xff };
+
+/* Byte enables of pst.d for pixel size ps.  Each PM bit expands to 8/2^ps
+   byte enables.  */
+static inline UINT32 pstd_wmask (int ps, int pm)
+{
+	switch (ps)
+	{
+		case 0:  return pm & 0xff;
+		case 1:  return pstd_wmask16[pm & 0x0f];
+		case 2:  return pstd_wmask32[pm & 0x03];
+		default: return 0xff;
+	}
+}
+
 /* Execute "pst.d fdest,#const(isrc2)" or "fst.d fdest,#const(isrc2)++"
    instruction.  */
 void i860_cpu_device::insn_pstd (UINT32 insn)
@@ -907,7 +927,6 @@ void i860_cpu_device::insn_pstd (UINT32 insn)
 	UINT32 eff = 0;
 	int auto_inc = (insn & 1);
 	int pm = GET_PSR_PM ();
-	int i;
 	UINT32 wmask;
 	int orig_pm = pm;
 
@@ -963,34 +982,7 @@ void i860_cpu_device::insn_pstd (UINT32 insn)
 	/* Write data (value of freg fdest) to memory at eff-- but only those
 	   bytes that are enabled by the bits in PSR.PM.  Bit 0 of PM selects
 	   the pixel at the lowest address.  */
-	wmask = 0;
-	for (i = 0; i < 8; )
-	{
-		if (ps == 0)
-		{
-			if (orig_pm & 0x80)
-				wmask |= 1 << (7-i);
-			i += 1;
-		}
-		else if (ps == 1)
-		{
-			if (orig_pm & 0x08)
-				wmask |= 0x3 << (6-i);
-			i += 2;
-		}
-		else if (ps == 2)
-		{
-			if (orig_pm & 0x02)
-				wmask |= 0xf << (4-i);
-			i += 4;
-		}
-		else
-		{
-			wmask = 0xff;
-			break;
-		}
-		orig_pm <<= 1;
-	}
+	wmask = pstd_wmask (ps, orig_pm);
 	writemem_emu (eff, 8, (UINT8 *)(&m_fregs[4 * fdest]), wmask);
 }
 
@@ -3397,6 +3389,65 @@ void i860_cpu_device::insn_fcmp (UINT32 insn) {
 }
 
 
+/* Z-buffer compare of four 16-bit pixels.  Returns the unsigned lane-wise
+   minimum of a and b and sets bit i of *le if pixel i of b is less than or
+   equal to pixel i of a.  */
+static inline UINT64 zchk16_scalar (UINT64 a, UINT64 b, int *le)
+{
+	UINT64 r = 0;
+	int i;
+
+	*le = 0;
+	for (i = 0; i < 4; i++)
+	{
+		UINT16 ps1 = (a >> (i * 16)) & 0xffff;
+		UINT16 ps2 = (b >> (i * 16)) & 0xffff;
+		int le_i = (ps2 <= ps1);
+		r |= (UINT64)(le_i ? ps2 : ps1) << (i * 16);
+		*le |= le_i << i;
+	}
+	return r;
+}
+
+/* Same as zchk16_scalar, with SSE2 or NEON where the host has them.  Both
+   are part of the x86-64 and AArch64 base instruction sets.  */
+static inline UINT64 zchk16 (UINT64 a, UINT64 b, int *le)
+{
+#ifdef __SSE2__
+	const __m128i bias = _mm_set1_epi16 ((short)0x8000);
+	__m128i va = _mm_xor_si128 (_mm_loadl_epi64 ((const __m128i *)&a), bias);
+	__m128i vb = _mm_xor_si128 (_mm_loadl_epi64 ((const __m128i *)&b), bias);
+	__m128i gt = _mm_cmpgt_epi16 (vb, va);
+	UINT64 r;
+
+	*le = ~_mm_movemask_epi8 (_mm_packs_epi16 (gt, gt)) & 0x0f;
+	_mm_storel_epi64 ((__m128i *)&r, _mm_xor_si128 (_mm_min_epi16 (va, vb), bias));
+	return r;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	static const uint16_t lane_bit[4] = { 1, 2, 4, 8 };
+	uint16x4_t va = vcreate_u16 (a);
+	uint16x4_t vb = vcreate_u16 (b);
+
+	*le = vaddv_u16 (vand_u16 (vcle_u16 (vb, va), vld1_u16 (lane_bit)));
+	return vget_lane_u64 (vreinterpret_u64_u16 (vmin_u16 (va, vb)), 0);
+#else
+	return zchk16_scalar (a, b, le);
+#endif
+}
+
+/* Z-buffer compare of two 32-bit pixels, see zchk16.  */
+static inline UINT64 zchk32 (UINT64 a, UINT64 b, int *le)
+{
+	UINT32 a0 = (UINT32)a, a1 = (UINT32)(a >> 32);
+	UINT32 b0 = (UINT32)b, b1 = (UINT32)(b >> 32);
+	int le0 = (b0 <= a0);
+	int le1 = (b1 <= a1);
+
+	*le = le0 | (le1 << 1);
+	return (UINT64)(le1 ? b1 : a1) << 32 | (le0 ? b0 : a0);
+}
+
+
 /* Execute [p]fzchk{l,s} fsrc1,fsrc2,fdest.
    The fzchk instructions have S and R bits set.  */
 void i860_cpu_device::insn_fzchk (UINT32 insn)
@@ -3407,13 +3458,13 @@ void i860_cpu_device::insn_fzchk (UINT32 insn)
 	int piped = insn & 0x400;        /* 1 = pipelined, 0 = scalar.  */
 	int is_fzchks = insn & 8;        /* 1 = fzchks, 0 = fzchkl.  */
 	FLOAT64 dbl_tmp_dest = FLOAT64_ZERO;
-	int i;
 	FLOAT64 v1 = get_fregval_d (fsrc1);
 	FLOAT64 v2 = get_fregval_d (fsrc2);
 	UINT64 iv1 = *(UINT64 *)&v1;
 	UINT64 iv2 = *(UINT64 *)&v2;
 	UINT64 r = 0;
-	char pm = GET_PSR_PM ();
+	int pm = GET_PSR_PM ();
+	int le;
 
 #if TRACE_UNDEFINED_I860
 	/* Check for S and R bits set.  */
@@ -3429,41 +3480,13 @@ void i860_cpu_device::insn_fzchk (UINT32 insn)
 	   pixels (pixels are unsigned ordinals in this context).  */
 	if (is_fzchks)
 	{
-		pm = (pm >> 4) & 0x0f;
-		for (i = 3; i >= 0; i--)
-		{
-			UINT16 ps1 = (iv1 >> (i * 16)) & 0xffff;
-			UINT16 ps2 = (iv2 >> (i * 16)) & 0xffff;
-			if (ps2 <= ps1)
-			{
-				r |= ((UINT64)ps2 << (i * 16));
-				pm |= (1 << (7 - (3 - i)));
-			}
-			else
-			{
-				r |= ((UINT64)ps1 << (i * 16));
-				pm &= ~(1 << (7 - (3 - i)));
-			}
-		}
+		r = zchk16 (iv1, iv2, &le);
+		pm = ((pm >> 4) & 0x0f) | (le << 4);
 	}
 	else
 	{
-		pm = (pm >> 2) & 0x3f;
-		for (i = 1; i >= 0; i--)
-		{
-			UINT32 ps1 = (iv1 >> (i * 32)) & 0xffffffff;
-			UINT32 ps2 = (iv2 >> (i * 32)) & 0xffffffff;
-			if (ps2 <= ps1)
-			{
-				r |= ((UINT64)ps2 << (i * 32));
-				pm |= (1 << (7 - (1 - i)));
-			}
-			else
-			{
-				r |= ((UINT64)ps1 << (i * 32));
-				pm &= ~(1 << (7 - (1 - i)));
-			}
-		}
+		r = zchk32 (iv1, iv2, &le);
+		pm = ((pm >> 2) & 0x3f) | (le << 6);
 	}
 
 	dbl_tmp_dest = *(FLOAT64 *)&r;
@@ -3544,6 +3567,23 @@ void i860_cpu_device::insn_form (UINT32 insn)
 }
 
 
+/* Merge register update for faddp, indexed by pixel size.  The undefined
+   pixel size leaves the merge register unchanged.  */
+static const struct {
+	int    shift;
+	UINT64 mask;
+} faddp_merge[4] = {
+	{ 8, 0xff00ff00ff00ff00ULL },
+	{ 6, 0xfc00fc00fc00fc00ULL },
+	{ 8, 0xff000000ff000000ULL },
+	{ 0, 0 }
+};
+
+static inline UINT64 faddp_merge_update (UINT64 merge, UINT64 r, int ps)
+{
+	return ((merge >> faddp_merge[ps].shift) & ~faddp_merge[ps].mask) | (r & faddp_merge[ps].mask);
+}
+
 /* Execute [p]faddp fsrc1,fsrc2,fdest.  */
 void i860_cpu_device::insn_faddp (UINT32 insn)
 {
@@ -3564,23 +3604,9 @@ void i860_cpu_device::insn_faddp (UINT32 insn)
     
 	/* Update the merge register depending on the pixel size.
 	   PS: 0 = 8 bits, 1 = 16 bits, 2 = 32-bits.  */
-	if (ps == 0)
-	{
-		m_merge = ((m_merge >> 8) & ~0xff00ff00ff00ff00ULL);
-		m_merge |= (r & 0xff00ff00ff00ff00ULL);
-	}
-	else if (ps == 1)
-	{
-		m_merge = ((m_merge >> 6) & ~0xfc00fc00fc00fc00ULL);
-		m_merge |= (r & 0xfc00fc00fc00fc00ULL);
-	}
-	else if (ps == 2)
-	{
-		m_merge = ((m_merge >> 8) & ~0xff000000ff000000ULL);
-		m_merge |= (r & 0xff000000ff000000ULL);
-	}
+	m_merge = faddp_merge_update (m_merge, r, ps);
 #if TRACE_UNDEFINED_I860
-	else
+	if (ps == 3)
 		Log_Printf(LOG_WARN, "[i860:%08X] insn_faddp: Undefined i860XR behavior, invalid value %d for pixel size", m_pc, ps);
 #endif
 
@@ -3609,6 +3635,200 @@ void i860_cpu_device::insn_faddp (UINT32 insn)
 }
 
 
+#if ENABLE_TESTING
+/* The pixel handlers as they were before they became table driven and
+   vectorized, kept as the reference for the "bench i860pix" debugger
+   command.  */
+static int pixtest_fzchk_ref (UINT64 iv1, UINT64 iv2, int pm, int is_fzchks, UINT64 *res)
+{
+	UINT64 r = 0;
+	int i;
+
+	if (is_fzchks)
+	{
+		pm = (pm >> 4) & 0x0f;
+		for (i = 3; i >= 0; i--)
+		{
+			UINT16 ps1 = (iv1 >> (i * 16)) & 0xffff;
+			UINT16 ps2 = (iv2 >> (i * 16)) & 0xffff;
+			if (ps2 <= ps1)
+			{
+				r |= ((UINT64)ps2 << (i * 16));
+				pm |= (1 << (7 - (3 - i)));
+			}
+			else
+			{
+				r |= ((UINT64)ps1 << (i * 16));
+				pm &= ~(1 << (7 - (3 - i)));
+			}
+		}
+	}
+	else
+	{
+		pm = (pm >> 2) & 0x3f;
+		for (i = 1; i >= 0; i--)
+		{
+			UINT32 ps1 = (iv1 >> (i * 32)) & 0xffffffff;
+			UINT32 ps2 = (iv2 >> (i * 32)) & 0xffffffff;
+			if (ps2 <= ps1)
+			{
+				r |= ((UINT64)ps2 << (i * 32));
+				pm |= (1 << (7 - (1 - i)));
+			}
+			else
+			{
+				r |= ((UINT64)ps1 << (i * 32));
+				pm &= ~(1 << (7 - (1 - i)));
+			}
+		}
+	}
+	*res = r;
+	return pm & 0xff;
+}
+
+static UINT32 pixtest_pstd_ref (int ps, int orig_pm)
+{
+	UINT32 wmask = 0;
+	int i;
+
+	for (i = 0; i < 8; )
+	{
+		if (ps == 0)
+		{
+			if (orig_pm & 0x80)
+				wmask |= 1 << (7-i);
+			i += 1;
+		}
+		else if (ps == 1)
+		{
+			if (orig_pm & 0x08)
+				wmask |= 0x3 << (6-i);
+			i += 2;
+		}
+		else if (ps == 2)
+		{
+			if (orig_pm & 0x02)
+				wmask |= 0xf << (4-i);
+			i += 4;
+		}
+		else
+		{
+			wmask = 0xff;
+			break;
+		}
+		orig_pm <<= 1;
+	}
+	return wmask;
+}
+
+static UINT64 pixtest_faddp_ref (UINT64 merge, UINT64 r, int ps)
+{
+	if (ps == 0)
+	{
+		merge = ((merge >> 8) & ~0xff00ff00ff00ff00ULL);
+		merge |= (r & 0xff00ff00ff00ff00ULL);
+	}
+	else if (ps == 1)
+	{
+		merge = ((merge >> 6) & ~0xfc00fc00fc00fc00ULL);
+		merge |= (r & 0xfc00fc00fc00fc00ULL);
+	}
+	else if (ps == 2)
+	{
+		merge = ((merge >> 8) & ~0xff000000ff000000ULL);
+		merge |= (r & 0xff000000ff000000ULL);
+	}
+	return merge;
+}
+
+static UINT64 pixtest_rand (UINT64 *seed)
+{
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 7;
+	*seed ^= *seed << 17;
+	return *seed;
+}
+
+/* Compare fzchk, faddp and pst.d bit for bit against the reference over
+   random operands and all PSR.PM and PS values, and time the 16-bit
+   Z-buffer compare with and without SIMD.  */
+extern "C" void nd_i860_pixel_bench (void)
+{
+	const int N = 1000000;
+	UINT64 seed = 0x0123456789ABCDEFULL;
+	UINT64 a, b, r, ref, sum;
+	int    i, ps, pm, pm_ref, le, le_scalar;
+	int    err = 0;
+	Uint64 t[2];
+
+	for (i = 0; i < N; i++)
+	{
+		a  = pixtest_rand (&seed);
+		b  = pixtest_rand (&seed);
+		pm = pixtest_rand (&seed) & 0xff;
+		ps = pixtest_rand (&seed) & 3;
+		if (i & 1)  /* equal pixels in every other lane */
+			b = (b & 0xffff0000ffff0000ULL) | (a & 0x0000ffff0000ffffULL);
+
+		pm_ref = pixtest_fzchk_ref (a, b, pm, 1, &ref);
+		r = zchk16 (a, b, &le);
+		if (r != ref || (((pm >> 4) & 0x0f) | (le << 4)) != pm_ref ||
+		    zchk16_scalar (a, b, &le_scalar) != ref || le_scalar != le)
+		{
+			if (err++ < 8)
+				Log_Printf(LOG_WARN, "[i860] fzchks mismatch: %016" FMT_ll "X %016" FMT_ll "X PM=%02X",
+				           (unsigned long long)a, (unsigned long long)b, pm);
+		}
+
+		pm_ref = pixtest_fzchk_ref (a, b, pm, 0, &ref);
+		r = zchk32 (a, b, &le);
+		if (r != ref || (((pm >> 2) & 0x3f) | (le << 6)) != pm_ref)
+		{
+			if (err++ < 8)
+				Log_Printf(LOG_WARN, "[i860] fzchkl mismatch: %016" FMT_ll "X %016" FMT_ll "X PM=%02X",
+				           (unsigned long long)a, (unsigned long long)b, pm);
+		}
+
+		if (faddp_merge_update (a, b, ps) != pixtest_faddp_ref (a, b, ps))
+		{
+			if (err++ < 8)
+				Log_Printf(LOG_WARN, "[i860] faddp mismatch: %016" FMT_ll "X %016" FMT_ll "X PS=%d",
+				           (unsigned long long)a, (unsigned long long)b, ps);
+		}
+	}
+
+	for (ps = 0; ps < 4; ps++)
+	{
+		for (pm = 0; pm < 256; pm++)
+		{
+			if (pstd_wmask (ps, pm) != pixtest_pstd_ref (ps, pm))
+			{
+				if (err++ < 8)
+					Log_Printf(LOG_WARN, "[i860] pst.d mismatch: PM=%02X PS=%d", pm, ps);
+			}
+		}
+	}
+
+	sum = 0;
+	for (int k = 0; k < 2; k++)
+	{
+		seed = 0x0123456789ABCDEFULL;
+		t[k] = host_time_us ();
+		for (i = 0; i < N; i++)
+		{
+			a = pixtest_rand (&seed);
+			b = a ^ (a >> 29);
+			sum += (k ? zchk16_scalar (a, b, &le) : zchk16 (a, b, &le)) + le;
+		}
+		t[k] = host_time_us () - t[k];
+	}
+
+	Log_Printf(LOG_WARN, "[i860] Pixel handlers: %d mismatches, fzchks %.1f Mops/s vector, %.1f Mops/s scalar (sum %" FMT_ll "X)",
+	           err, (double)N / (t[0] ? t[0] : 1), (double)N / (t[1] ? t[1] : 1), (unsigned long long)sum);
+}
+#endif
+
+
 /* Execute [p]faddz fsrc1,fsrc2,fdest.  */
 void i860_cpu_device::insn_faddz (UINT32 insn)
 {
@@ -3886,6 +4106,7 @@ i860_cpu_device::insn_func i860_cpu_device::decoder_tbl[8192];
 void i860_cpu_device::decode_exec (UINT32 insn) {
     if(m_flow & EXITING_IFETCH) return;
     
+    m_insn_count++;
 #if ENABLE_PERF_COUNTERS
     m_insn_decoded++;
 #endif
@@ -3960,6 +4181,7 @@ void i860_cpu_device::reset() {
 	/* Set fir, fsr, KR, KI, MERGE, T to undefined.  */
 	m_cregs[CR_FIR] = UNDEF_VAL;
 	m_cregs[CR_FSR] = UNDEF_VAL;
+	float_set_rounding_mode (GET_FSR_RM());
 	m_KR.d          = FLOAT64_ZERO;
 	m_KI.d          = FLOAT64_ZERO;
 	m_T.d           = FLOAT64_ZERO;
@@ -62,7 +62,7 @@
 
 #define CSRDRAM_4MBIT       0x00000001
 
-static volatile struct {
+static volatile struct nd_mc {
     uae_u32 csr0;
     uae_u32 csr1;
     uae_u32 csr2;
@@ -84,7 +84,7 @@ static volatile struct {
     uae_u32 dma_out_a;
     uae_u32 vram;
     uae_u32 dram;
-} nd_mc;
+} nd_mc[ND_MAX_BOARDS];
 
 #define DP_IIC_MORE 0x20000000
 #define DP_IIC_BUSY 0x80000000
@@ -94,7 +94,7 @@ static volatile struct {
 #define DP_CSR_JPEG_MASK    0xFC
 
 
-static struct {
+static struct nd_dp {
     uae_u8  iic_addr;
     uae_u8  iic_msg;
     uae_u32 iic_msgsz;
@@ -109,41 +109,44 @@ static struct {
     uae_u32 dma_y;
     uae_u32 iic_stat_addr;
     uae_u32 iic_data;
-} nd_dp;
+} nd_dp[ND_MAX_BOARDS];
 
 void nd_devs_init() {
-    nd_mc.csr0          = CSR0_i860PIN_CS8;
-    nd_mc.csr1          = 0;
-    nd_mc.csr2          = 0;
-    nd_mc.sid           = ND_SLOT|(ND_STEP<<4);
-    nd_mc.dma_csr       = 0;
-    nd_mc.dma_start     = 0;
-    nd_mc.dma_width     = 0;
-    nd_mc.dma_pstart    = 0;
-    nd_mc.dma_pwidth    = 0;
-    nd_mc.dma_sstart    = 0;
-    nd_mc.dma_swidth    = 0;
-    nd_mc.dma_bsstart   = 0;
-    nd_mc.dma_bswidth   = 0;
-    nd_mc.dma_top       = 0;
-    nd_mc.dma_bottom    = 0;
-    nd_mc.dma_line_a    = 0;
-    nd_mc.dma_curr_a    = 0;
-    nd_mc.dma_scurr_a   = 0;
-    nd_mc.dma_out_a     = 0;
-    nd_mc.vram          = 0;
-    nd_mc.dram          = 0;
-    nd_dp.iic_msgsz     = 0;
-    nd_dp.iic_addr      = 0;
-    nd_dp.csr           = 0;
-    nd_dp.alpha         = 0;
-    nd_dp.dma           = 0;
-    nd_dp.cpu_x         = 0xc;
-    nd_dp.cpu_y         = 0xc;
-    nd_dp.dma_x         = 0xd;
-    nd_dp.dma_y         = 0xd;
-    nd_dp.iic_stat_addr = 0;
-    nd_dp.iic_data      = 0;
+    volatile struct nd_mc* mc = &nd_mc[nd_current->num];
+    struct nd_dp* dp = &nd_dp[nd_current->num];
+    
+    mc->csr0          = CSR0_i860PIN_CS8;
+    mc->csr1          = 0;
+    mc->csr2          = 0;
+    mc->sid           = nd_current->slot|(ND_STEP<<4);
+    mc->dma_csr       = 0;
+    mc->dma_start     = 0;
+    mc->dma_width     = 0;
+    mc->dma_pstart    = 0;
+    mc->dma_pwidth    = 0;
+    mc->dma_sstart    = 0;
+    mc->dma_swidth    = 0;
+    mc->dma_bsstart   = 0;
+    mc->dma_bswidth   = 0;
+    mc->dma_top       = 0;
+    mc->dma_bottom    = 0;
+    mc->dma_line_a    = 0;
+    mc->dma_curr_a    = 0;
+    mc->dma_scurr_a   = 0;
+    mc->dma_out_a     = 0;
+    mc->vram          = 0;
+    mc->dram          = 0;
+    dp->iic_msgsz     = 0;
+    dp->iic_addr      = 0;
+    dp->csr           = 0;
+    dp->alpha         = 0;
+    dp->dma           = 0;
+    dp->cpu_x         = 0xc;
+    dp->cpu_y         = 0xc;
+    dp->dma_x         = 0xd;
+    dp->dma_y         = 0xd;
+    dp->iic_stat_addr = 0;
+    dp->iic_data      = 0;
 }
 
 
@@ -238,73 +241,75 @@ static const char* MC_RD_FORMAT   = "[ND] Memory controller %s read %08X at %08X
 static const char* MC_RD_FORMAT_S = "[ND] Memory controller %s read (%s) at %08X";
 
 static uae_u32 nd_mc_read_register(uaecptr addr) {
+    volatile struct nd_mc* mc = &nd_mc[nd_current->num];
+    
 	switch (addr&0x3FFF) {
 		case 0x0000:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT_S,"csr0", decodeBits(ND_CSR0_BITS, nd_mc.csr0),addr);
-			return nd_mc.csr0;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT_S,"csr0", decodeBits(ND_CSR0_BITS, mc->csr0),addr);
+			return mc->csr0;
 		case 0x0010:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT_S,"csr1", decodeBits(ND_CSR1_BITS, nd_mc.csr1),addr);
-			return nd_mc.csr1;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT_S,"csr1", decodeBits(ND_CSR1_BITS, mc->csr1),addr);
+			return mc->csr1;
 		case 0x0020:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT_S,"csr2", decodeBits(ND_CSR2_BITS, nd_mc.csr2),addr);
-			return nd_mc.csr2;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT_S,"csr2", decodeBits(ND_CSR2_BITS, mc->csr2),addr);
+			return mc->csr2;
 		case 0x0030:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"sid", nd_mc.sid,addr);
-			return nd_mc.sid;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"sid", mc->sid,addr);
+			return mc->sid;
 		case 0x1000:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT_S,"dma_csr", decodeBits(ND_DMA_CSR_BITS, nd_mc.dma_csr),addr);
-            return nd_mc.dma_csr;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT_S,"dma_csr", decodeBits(ND_DMA_CSR_BITS, mc->dma_csr),addr);
+            return mc->dma_csr;
         case 0x1010:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_start", nd_mc.dma_start,addr);
-            return nd_mc.dma_start;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_start", mc->dma_start,addr);
+            return mc->dma_start;
         case 0x1020:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_width", nd_mc.dma_width,addr);
-            return nd_mc.dma_width;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_width", mc->dma_width,addr);
+            return mc->dma_width;
         case 0x1030:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_pstart", nd_mc.dma_pstart,addr);
-            return nd_mc.dma_pstart;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_pstart", mc->dma_pstart,addr);
+            return mc->dma_pstart;
         case 0x1040:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_pwidth", nd_mc.dma_pwidth,addr);
-            return nd_mc.dma_pwidth;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_pwidth", mc->dma_pwidth,addr);
+            return mc->dma_pwidth;
         case 0x1050:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_sstart", nd_mc.dma_sstart,addr);
-            return nd_mc.dma_sstart;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_sstart", mc->dma_sstart,addr);
+            return mc->dma_sstart;
         case 0x1060:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_swidth", nd_mc.dma_swidth,addr);
-            return nd_mc.dma_swidth;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_swidth", mc->dma_swidth,addr);
+            return mc->dma_swidth;
         case 0x1070:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_bsstart", nd_mc.dma_bsstart,addr);
-            return nd_mc.dma_bsstart;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_bsstart", mc->dma_bsstart,addr);
+            return mc->dma_bsstart;
         case 0x1080:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_bswidth", nd_mc.dma_bswidth,addr);
-            return nd_mc.dma_bswidth;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_bswidth", mc->dma_bswidth,addr);
+            return mc->dma_bswidth;
         case 0x1090:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_top", nd_mc.dma_top,addr);
-            return nd_mc.dma_top;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_top", mc->dma_top,addr);
+            return mc->dma_top;
         case 0x10A0:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_bottom", nd_mc.dma_bottom,addr);
-            return nd_mc.dma_bottom;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_bottom", mc->dma_bottom,addr);
+            return mc->dma_bottom;
         case 0x10B0:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_line_a", nd_mc.dma_line_a,addr);
-            return nd_mc.dma_line_a;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_line_a", mc->dma_line_a,addr);
+            return mc->dma_line_a;
         case 0x10C0:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_curr_a", nd_mc.dma_curr_a,addr);
-            return nd_mc.dma_curr_a;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_curr_a", mc->dma_curr_a,addr);
+            return mc->dma_curr_a;
         case 0x10D0:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_line_a", nd_mc.dma_line_a,addr);
-            return nd_mc.dma_line_a;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_line_a", mc->dma_line_a,addr);
+            return mc->dma_line_a;
         case 0x10E0:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_scurr_a", nd_mc.dma_scurr_a,addr);
-            return nd_mc.dma_scurr_a;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_scurr_a", mc->dma_scurr_a,addr);
+            return mc->dma_scurr_a;
         case 0x10F0:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_out_a", nd_mc.dma_out_a,addr);
-            return nd_mc.dma_out_a;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT,"dma_out_a", mc->dma_out_a,addr);
+            return mc->dma_out_a;
 		case 0x2000:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT_S,"vram", decodeBits(ND_VRAM_BITS, nd_mc.vram),addr);
-            return nd_mc.vram;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT_S,"vram", decodeBits(ND_VRAM_BITS, mc->vram),addr);
+            return mc->vram;
 		case 0x3000:
-            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT_S,"dram", decodeBits(ND_DRAM_BITS, nd_mc.dram),addr);
-            return nd_mc.dram;
+            Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT_S,"dram", decodeBits(ND_DRAM_BITS, mc->dram),addr);
+            return mc->dram;
 		default:
 			Log_Printf(LOG_WARN, "[ND] Memory controller UNKNOWN read at %08X",addr);
             break;
@@ -316,6 +321,8 @@ static const char* MC_WR_FORMAT   = "[ND] Memory controller %s write %08X at %08
 static const char* MC_WR_FORMAT_S = "[ND] Memory controller %s write (%s) at %08X";
 
 static void nd_mc_write_register(uaecptr addr, uae_u32 val) {
+    volatile struct nd_mc* mc = &nd_mc[nd_current->num];
+    
     switch (addr&0x3FFF) {
         case 0x0000:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT_S,"csr0", decodeBits(ND_CSR0_BITS, val), addr);
@@ -329,12 +336,12 @@ static void nd_mc_write_register(uaecptr addr, uae_u32 val) {
             if((val & CSR0_BE_INT) && (val & CSR0_BE_IMASK))
                 i860_interrupt();
             
-            nd_mc.csr0 = val;
+            mc->csr0 = val;
             break;
         case 0x0010:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT_S,"csr1", decodeBits(ND_CSR1_BITS, val),addr);
-            nd_mc.csr1 = val;
-			if (nd_mc.csr1&CSR1_CPU_INT) {
+            mc->csr1 = val;
+			if (mc->csr1&CSR1_CPU_INT) {
 				nd_nbic_set_intstatus(true);
 			} else {
                 nd_nbic_set_intstatus(false);
@@ -342,83 +349,83 @@ static void nd_mc_write_register(uaecptr addr, uae_u32 val) {
             break;
         case 0x0020:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT_S,"csr2", decodeBits(ND_CSR2_BITS, val),addr);
-            nd_mc.csr2 = val;
+            mc->csr2 = val;
             break;
         case 0x0030:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"sid", val,addr);
-            nd_mc.sid = val;
+            mc->sid = val;
             break;
         case 0x1000:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT_S,"dma_csr", decodeBits(ND_DMA_CSR_BITS, val),addr);
-            nd_mc.dma_csr = val;
+            mc->dma_csr = val;
             break;
         case 0x1010:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_start", val,addr);
-            nd_mc.dma_start = val;
+            mc->dma_start = val;
             break;
         case 0x1020:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_width", val,addr);
-            nd_mc.dma_width = val;
+            mc->dma_width = val;
             break;
         case 0x1030:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_pstart", val,addr);
-            nd_mc.dma_pstart = val;
+            mc->dma_pstart = val;
             break;
         case 0x1040:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_pwidth", val,addr);
-            nd_mc.dma_pwidth = val;
+            mc->dma_pwidth = val;
             break;
         case 0x1050:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_sstart", val,addr);
-            nd_mc.dma_sstart = val;
+            mc->dma_sstart = val;
             break;
         case 0x1060:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_swidth", val,addr);
-            nd_mc.dma_swidth = val;
+            mc->dma_swidth = val;
             break;
         case 0x1070:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_bsstart", val,addr);
-            nd_mc.dma_bsstart = val;
+            mc->dma_bsstart = val;
             break;
         case 0x1080:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_bswidth", val,addr);
-            nd_mc.dma_bswidth = val;
+            mc->dma_bswidth = val;
             break;
         case 0x1090:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_top", val,addr);
-            nd_mc.dma_top = val;
+            mc->dma_top = val;
             break;
         case 0x10A0:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_bottom", val,addr);
-            nd_mc.dma_bottom = val;
+            mc->dma_bottom = val;
             break;
         case 0x10B0:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_line_a", val,addr);
-            nd_mc.dma_line_a = val;
+            mc->dma_line_a = val;
             break;
         case 0x10C0:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_curr_a", val,addr);
-            nd_mc.dma_curr_a = val;
+            mc->dma_curr_a = val;
             break;
         case 0x10D0:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_line_a", val,addr);
-            nd_mc.dma_line_a = val;
+            mc->dma_line_a = val;
             break;
         case 0x10E0:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_scurr_a", val,addr);
-            nd_mc.dma_scurr_a = val;
+            mc->dma_scurr_a = val;
             break;
         case 0x10F0:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT,"dma_out_a", val,addr);
-            nd_mc.dma_out_a = val;
+            mc->dma_out_a = val;
             break;
         case 0x2000:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT_S,"vram", decodeBits(ND_VRAM_BITS, val),addr);
-            nd_mc.vram = val;
+            mc->vram = val;
             break;
         case 0x3000:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT_S,"dram", decodeBits(ND_DRAM_BITS, val),addr);
-            nd_mc.dram = val;
+            mc->dram = val;
             break;
         default:
             Log_Printf(LOG_WARN, "[ND] Memory controller UNKNOWN write at %08X",addr);
@@ -453,67 +460,71 @@ inline void nd_io_bput(uaecptr addr, uae_u32 b) {
 
 /* NeXTdimension RAMDAC */
 
-bt463 nd_ramdac;
+static bt463 nd_ramdac[ND_MAX_BOARDS];
 
 inline uae_u32 nd_ramdac_lget(uaecptr addr) {
-    return bt463_bget(&nd_ramdac, addr) << 24;
+    return bt463_bget(&nd_ramdac[nd_current->num], addr) << 24;
 }
 
 inline uae_u32 nd_ramdac_wget(uaecptr addr) {
-    return bt463_bget(&nd_ramdac, addr) << 8;
+    return bt463_bget(&nd_ramdac[nd_current->num], addr) << 8;
 }
 
 inline uae_u32 nd_ramdac_bget(uaecptr addr) {
-    return bt463_bget(&nd_ramdac, addr);
+    return bt463_bget(&nd_ramdac[nd_current->num], addr);
 }
 
 inline void nd_ramdac_lput(uaecptr addr, uae_u32 l) {
-    bt463_bput(&nd_ramdac, addr, l >> 24);
+    bt463_bput(&nd_ramdac[nd_current->num], addr, l >> 24);
 }
 
 inline void nd_ramdac_wput(uaecptr addr, uae_u32 w) {
-    bt463_bput(&nd_ramdac, addr, w >> 8);
+    bt463_bput(&nd_ramdac[nd_current->num], addr, w >> 8);
 }
 
 inline void nd_ramdac_bput(uaecptr addr, uae_u32 b) {
-    bt463_bput(&nd_ramdac, addr, b);
+    bt463_bput(&nd_ramdac[nd_current->num], addr, b);
 }
 
 /* NeXTdimension data path */
 
 static void nd_dp_iicmsg(void) {
-    Log_Printf(LOG_NONE, "[ND] data path IIC msg addr:%02X msg[%d]=%02X", nd_dp.iic_addr, nd_dp.iic_msgsz-1, nd_dp.iic_msg);
+    struct nd_dp* dp = &nd_dp[nd_current->num];
+    
+    Log_Printf(LOG_NONE, "[ND] data path IIC msg addr:%02X msg[%d]=%02X", dp->iic_addr, dp->iic_msgsz-1, dp->iic_msg);
     
-    nd_video_dev_write(nd_dp.iic_addr, nd_dp.iic_msgsz-1, nd_dp.iic_msg);
+    nd_video_dev_write(dp->iic_addr, dp->iic_msgsz-1, dp->iic_msg);
 }
 
 uae_u32 nd_dp_lget(uaecptr addr) {
+    struct nd_dp* dp = &nd_dp[nd_current->num];
+    
     switch(addr) {
         case 0x300: case 0x304: case 0x308: case 0x30C:
         case 0x310: case 0x314: case 0x318: case 0x31C:
         case 0x320: case 0x324: case 0x328: case 0x32C:
         case 0x330: case 0x334: case 0x338: case 0x33C:
-            return nd_dp.doff;
+            return dp->doff;
         case 0x340:
-            return nd_dp.csr;
+            return dp->csr;
         case 0x344:
-            return nd_dp.alpha;
+            return dp->alpha;
         case 0x348:
-            return nd_dp.dma;
+            return dp->dma;
         case 0x350:
-            return nd_dp.cpu_x;
+            return dp->cpu_x;
         case 0x354:
-            return nd_dp.cpu_y;
+            return dp->cpu_y;
         case 0x358:
-            return nd_dp.dma_x;
+            return dp->dma_x;
         case 0x35C:
-            return nd_dp.dma_y;
+            return dp->dma_y;
         case 0x360:
-            if(nd_dp.iic_busy <= 0)
-                nd_dp.iic_stat_addr &= ~DP_IIC_BUSY;
+            if(dp->iic_busy <= 0)
+                dp->iic_stat_addr &= ~DP_IIC_BUSY;
             else
-                nd_dp.iic_busy--;
-            return nd_dp.iic_stat_addr;
+                dp->iic_busy--;
+            return dp->iic_stat_addr;
         case 0x364:
             return 0;
         default:
@@ -523,48 +534,50 @@ uae_u32 nd_dp_lget(uaecptr addr) {
 }
 
 void nd_dp_lput(uaecptr addr, uae_u32 v) {
+    struct nd_dp* dp = &nd_dp[nd_current->num];
+    
     switch(addr) {
         case 0x300: case 0x304: case 0x308: case 0x30C:
         case 0x310: case 0x314: case 0x318: case 0x31C:
         case 0x320: case 0x324: case 0x328: case 0x32C:
         case 0x330: case 0x334: case 0x338: case 0x33C:
-            nd_dp.doff  = v;
+            dp->doff  = v;
             break;
         case 0x340:
-            nd_dp.csr = v;
+            dp->csr = v;
             break;
         case 0x344:
-            nd_dp.alpha = v;
+            dp->alpha = v;
             break;
         case 0x348:
-            nd_dp.dma = v;
+            dp->dma = v;
             break;
         case 0x350:
-            nd_dp.cpu_x = v;
+            dp->cpu_x = v;
             break;
         case 0x354:
-            nd_dp.cpu_y = v;
+            dp->cpu_y = v;
             break;
         case 0x358:
-            nd_dp.dma_x = v;
+            dp->dma_x = v;
             break;
         case 0x35C:
-            nd_dp.dma_y = v;
+            dp->dma_y = v;
             break;
         case 0x360:
-            nd_dp.iic_msgsz = 0;
-            nd_dp.iic_addr  = (v >> 8) & 0xFF;
-            nd_dp.iic_msg   = v;
-            nd_dp.iic_msgsz++;
-            nd_dp.iic_stat_addr |= DP_IIC_BUSY;
-            nd_dp.iic_busy       = 10;
+            dp->iic_msgsz = 0;
+            dp->iic_addr  = (v >> 8) & 0xFF;
+            dp->iic_msg   = v;
+            dp->iic_msgsz++;
+            dp->iic_stat_addr |= DP_IIC_BUSY;
+            dp->iic_busy       = 10;
             nd_dp_iicmsg();
             break;
         case 0x364:
-            nd_dp.iic_msg = v;
-            nd_dp.iic_msgsz++;
-            nd_dp.iic_stat_addr |= DP_IIC_BUSY;
-            nd_dp.iic_busy       = 10;
+            dp->iic_msg = v;
+            dp->iic_msgsz++;
+            dp->iic_stat_addr |= DP_IIC_BUSY;
+            dp->iic_busy       = 10;
             nd_dp_iicmsg();
             break;
         default:
@@ -573,25 +586,27 @@ void nd_dp_lput(uaecptr addr, uae_u32 v) {
 }
 
 void nd_set_blank_state(int src, bool state) {
+    volatile struct nd_mc* mc = &nd_mc[nd_current->num];
+    
     switch (src) {
         case ND_DISPLAY:
             if(state) {
-                nd_mc.csr0 |= CSR0_VBL_INT | CSR0_VBLANK;
-                if (nd_mc.csr0 & CSR0_VBL_IMASK) {
+                mc->csr0 |= CSR0_VBL_INT | CSR0_VBLANK;
+                if (mc->csr0 & CSR0_VBL_IMASK) {
                     i860_interrupt();
                 }
             } else {
-                nd_mc.csr0 &= ~CSR0_VBLANK;
+                mc->csr0 &= ~CSR0_VBLANK;
             }
             break;
         case ND_VIDEO:
             if(state) {
-                nd_mc.csr0 |= CSR0_VIOVBL_INT | CSR0_VIOBLANK;
-                if (nd_mc.csr0 & CSR0_VIOVBL_IMASK) {
+                mc->csr0 |= CSR0_VIOVBL_INT | CSR0_VIOBLANK;
+                if (mc->csr0 & CSR0_VIOVBL_IMASK) {
                     i860_interrupt();
                 }
             } else {
-                nd_mc.csr0 &= ~CSR0_VIOBLANK;
+                mc->csr0 &= ~CSR0_VIOBLANK;
             }
             break;
     }
@@ -601,6 +616,8 @@ static const char* nd_dump_path = "nd_memory.bin";
 
 /* debugger stuff */
 bool nd_dbg_cmd(const char* buf) {
+    volatile struct nd_mc* mc = &nd_mc[nd_current->num];
+    
     if(!(buf)) {
         fprintf(stderr,
                 "   w: write NeXTdimension DRAM to file '%s'\n"
@@ -618,33 +635,33 @@ bool nd_dbg_cmd(const char* buf) {
             size        += ConfigureParams.Dimension.nMemoryBankSize[3];
             fprintf(stderr, "Writing %"FMT_zu"MB to '%s'...", size, nd_dump_path);
             size <<= 20;
-            fwrite(ND_ram, sizeof(Uint8), size, fp);
+            fwrite(nd_current->ram, sizeof(Uint8), size, fp);
             fclose(fp);
             fprintf(stderr, "done.");
             return true;
         }
         case 'n': {
-            fprintf(stderr, "csr0        (%s)\n", decodeBits(ND_CSR0_BITS,    nd_mc.csr0));
-            fprintf(stderr, "csr1        (%s)\n", decodeBits(ND_CSR1_BITS,    nd_mc.csr1));
-            fprintf(stderr, "csr2        (%s)\n", decodeBits(ND_CSR2_BITS,    nd_mc.csr2));
-            fprintf(stderr, "sid         (%s)\n", decodeBits(0,               nd_mc.sid));
-            fprintf(stderr, "dma_csr     (%s)\n", decodeBits(ND_DMA_CSR_BITS, nd_mc.dma_csr));
-            fprintf(stderr, "dma_start   (%s)\n", decodeBits(0,               nd_mc.dma_start));
-            fprintf(stderr, "dma_width   (%s)\n", decodeBits(0,               nd_mc.dma_width));
-            fprintf(stderr, "dma_pstart  (%s)\n", decodeBits(0,               nd_mc.dma_pstart));
-            fprintf(stderr, "dma_pwidth  (%s)\n", decodeBits(0,               nd_mc.dma_pwidth));
-            fprintf(stderr, "dma_sstart  (%s)\n", decodeBits(0,               nd_mc.dma_sstart));
-            fprintf(stderr, "dma_swidth  (%s)\n", decodeBits(0,               nd_mc.dma_swidth));
-            fprintf(stderr, "dma_bsstart (%s)\n", decodeBits(0,               nd_mc.dma_bsstart));
-            fprintf(stderr, "dma_bswidth (%s)\n", decodeBits(0,               nd_mc.dma_bswidth));
-            fprintf(stderr, "dma_top     (%s)\n", decodeBits(0,               nd_mc.dma_top));
-            fprintf(stderr, "dma_bottom  (%s)\n", decodeBits(0,               nd_mc.dma_bottom));
-            fprintf(stderr, "dma_line_a  (%s)\n", decodeBits(0,               nd_mc.dma_line_a));
-            fprintf(stderr, "dma_curr_a  (%s)\n", decodeBits(0,               nd_mc.dma_curr_a));
-            fprintf(stderr, "dma_scurr_a (%s)\n", decodeBits(0,               nd_mc.dma_scurr_a));
-            fprintf(stderr, "dma_out_a   (%s)\n", decodeBits(0,               nd_mc.dma_out_a));
-            fprintf(stderr, "vram        (%s)\n", decodeBits(ND_VRAM_BITS,    nd_mc.vram));
-            fprintf(stderr, "dram        (%s)\n", decodeBits(ND_DRAM_BITS,    nd_mc.dram));
+            fprintf(stderr, "csr0        (%s)\n", decodeBits(ND_CSR0_BITS,    mc->csr0));
+            fprintf(stderr, "csr1        (%s)\n", decodeBits(ND_CSR1_BITS,    mc->csr1));
+            fprintf(stderr, "csr2        (%s)\n", decodeBits(ND_CSR2_BITS,    mc->csr2));
+            fprintf(stderr, "sid         (%s)\n", decodeBits(0,               mc->sid));
+            fprintf(stderr, "dma_csr     (%s)\n", decodeBits(ND_DMA_CSR_BITS, mc->dma_csr));
+            fprintf(stderr, "dma_start   (%s)\n", decodeBits(0,               mc->dma_start));
+            fprintf(stderr, "dma_width   (%s)\n", decodeBits(0,               mc->dma_width));
+            fprintf(stderr, "dma_pstart  (%s)\n", decodeBits(0,               mc->dma_pstart));
+            fprintf(stderr, "dma_pwidth  (%s)\n", decodeBits(0,               mc->dma_pwidth));
+            fprintf(stderr, "dma_sstart  (%s)\n", decodeBits(0,               mc->dma_sstart));
+            fprintf(stderr, "dma_swidth  (%s)\n", decodeBits(0,               mc->dma_swidth));
+            fprintf(stderr, "dma_bsstart (%s)\n", decodeBits(0,               mc->dma_bsstart));
+            fprintf(stderr, "dma_bswidth (%s)\n", decodeBits(0,               mc->dma_bswidth));
+            fprintf(stderr, "dma_top     (%s)\n", decodeBits(0,               mc->dma_top));
+            fprintf(stderr, "dma_bottom  (%s)\n", decodeBits(0,               mc->dma_bottom));
+            fprintf(stderr, "dma_line_a  (%s)\n", decodeBits(0,               mc->dma_line_a));
+            fprintf(stderr, "dma_curr_a  (%s)\n", decodeBits(0,               mc->dma_curr_a));
+            fprintf(stderr, "dma_scurr_a (%s)\n", decodeBits(0,               mc->dma_scurr_a));
+            fprintf(stderr, "dma_out_a   (%s)\n", decodeBits(0,               mc->dma_out_a));
+            fprintf(stderr, "vram        (%s)\n", decodeBits(ND_VRAM_BITS,    mc->vram));
+            fprintf(stderr, "dram        (%s)\n", decodeBits(ND_DRAM_BITS,    mc->dram));
             return true;
         }
         default:
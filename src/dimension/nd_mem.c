@@ -6,6 +6,7 @@
 #include "nd_mem.h"
 #include "nd_devs.h"
 #include "nd_rom.h"
+#include "host.h"
 
 #define write_log printf
 
@@ -32,11 +33,6 @@ uae_u32 ND_RAM_bankmask1;
 uae_u32 ND_RAM_bankmask2;
 uae_u32 ND_RAM_bankmask3;
 
-Uint8  ND_ram[64*1024*1024];
-Uint8  ND_vram[4*1024*1024];
-Uint8  ND_rom[128*1024];
-
-Uint8 ND_dmem[512];
 
 /* NeXTdimension dither memory */
 #define ND_DMEM_START   0xFF000000
@@ -76,7 +72,7 @@ static uaecptr nd_rom_addr_fix(uaecptr addr)
     return addr;
 }
 
-/* Memory banks */
+/* Memory banks, the address map is the same for all boards */
 
 nd_addrbank *nd_mem_banks[65536];
 
@@ -93,145 +89,145 @@ static void nd_map_banks (nd_addrbank *bank, int start, int size)
 static uae_u32 nd_ram_bank0_lget(uaecptr addr)
 {
 	addr &= ND_RAM_bankmask0;
-	return do_get_mem_long(ND_ram + addr);
+	return do_get_mem_long(nd_current->ram + addr);
 }
 
 static uae_u32 nd_ram_bank0_wget(uaecptr addr)
 {
 	addr &= ND_RAM_bankmask0;
-	return do_get_mem_word(ND_ram + addr);
+	return do_get_mem_word(nd_current->ram + addr);
 }
 
 static uae_u32 nd_ram_bank0_bget(uaecptr addr)
 {
 	addr &= ND_RAM_bankmask0;
-	return ND_ram[addr];
+	return nd_current->ram[addr];
 }
 
 static void nd_ram_bank0_lput(uaecptr addr, uae_u32 l)
 {
 	addr &= ND_RAM_bankmask0;
-	do_put_mem_long(ND_ram + addr, l);
+	do_put_mem_long(nd_current->ram + addr, l);
 }
 
 static void nd_ram_bank0_wput(uaecptr addr, uae_u32 w)
 {
 	addr &= ND_RAM_bankmask0;
-	do_put_mem_word(ND_ram + addr, w);
+	do_put_mem_word(nd_current->ram + addr, w);
 }
 
 static void nd_ram_bank0_bput(uaecptr addr, uae_u32 b)
 {
 	addr &= ND_RAM_bankmask0;
-	ND_ram[addr] = b;
+	nd_current->ram[addr] = b;
 }
 
 static uae_u32 nd_ram_bank1_lget(uaecptr addr)
 {
     addr &= ND_RAM_bankmask1;
-    return do_get_mem_long(ND_ram + addr);
+    return do_get_mem_long(nd_current->ram + addr);
 }
 
 static uae_u32 nd_ram_bank1_wget(uaecptr addr)
 {
     addr &= ND_RAM_bankmask1;
-    return do_get_mem_word(ND_ram + addr);
+    return do_get_mem_word(nd_current->ram + addr);
 }
 
 static uae_u32 nd_ram_bank1_bget(uaecptr addr)
 {
     addr &= ND_RAM_bankmask1;
-    return ND_ram[addr];
+    return nd_current->ram[addr];
 }
 
 static void nd_ram_bank1_lput(uaecptr addr, uae_u32 l)
 {
     addr &= ND_RAM_bankmask1;
-    do_put_mem_long(ND_ram + addr, l);
+    do_put_mem_long(nd_current->ram + addr, l);
 }
 
 static void nd_ram_bank1_wput(uaecptr addr, uae_u32 w)
 {
     addr &= ND_RAM_bankmask1;
-    do_put_mem_word(ND_ram + addr, w);
+    do_put_mem_word(nd_current->ram + addr, w);
 }
 
 static void nd_ram_bank1_bput(uaecptr addr, uae_u32 b)
 {
     addr &= ND_RAM_bankmask1;
-    ND_ram[addr] = b;
+    nd_current->ram[addr] = b;
 }
 
 static uae_u32 nd_ram_bank2_lget(uaecptr addr)
 {
     addr &= ND_RAM_bankmask2;
-    return do_get_mem_long(ND_ram + addr);
+    return do_get_mem_long(nd_current->ram + addr);
 }
 
 static uae_u32 nd_ram_bank2_wget(uaecptr addr)
 {
     addr &= ND_RAM_bankmask2;
-    return do_get_mem_word(ND_ram + addr);
+    return do_get_mem_word(nd_current->ram + addr);
 }
 
 static uae_u32 nd_ram_bank2_bget(uaecptr addr)
 {
     addr &= ND_RAM_bankmask2;
-    return ND_ram[addr];
+    return nd_current->ram[addr];
 }
 
 static void nd_ram_bank2_lput(uaecptr addr, uae_u32 l)
 {
     addr &= ND_RAM_bankmask2;
-    do_put_mem_long(ND_ram + addr, l);
+    do_put_mem_long(nd_current->ram + addr, l);
 }
 
 static void nd_ram_bank2_wput(uaecptr addr, uae_u32 w)
 {
     addr &= ND_RAM_bankmask2;
-    do_put_mem_word(ND_ram + addr, w);
+    do_put_mem_word(nd_current->ram + addr, w);
 }
 
 static void nd_ram_bank2_bput(uaecptr addr, uae_u32 b)
 {
     addr &= ND_RAM_bankmask2;
-    ND_ram[addr] = b;
+    nd_current->ram[addr] = b;
 }
 
 static uae_u32 nd_ram_bank3_lget(uaecptr addr)
 {
     addr &= ND_RAM_bankmask3;
-    return do_get_mem_long(ND_ram + addr);
+    return do_get_mem_long(nd_current->ram + addr);
 }
 
 static uae_u32 nd_ram_bank3_wget(uaecptr addr)
 {
     addr &= ND_RAM_bankmask3;
-    return do_get_mem_word(ND_ram + addr);
+    return do_get_mem_word(nd_current->ram + addr);
 }
 
 static uae_u32 nd_ram_bank3_bget(uaecptr addr)
 {
     addr &= ND_RAM_bankmask3;
-    return ND_ram[addr];
+    return nd_current->ram[addr];
 }
 
 static void nd_ram_bank3_lput(uaecptr addr, uae_u32 l)
 {
     addr &= ND_RAM_bankmask3;
-    do_put_mem_long(ND_ram + addr, l);
+    do_put_mem_long(nd_current->ram + addr, l);
 }
 
 static void nd_ram_bank3_wput(uaecptr addr, uae_u32 w)
 {
     addr &= ND_RAM_bankmask3;
-    do_put_mem_word(ND_ram + addr, w);
+    do_put_mem_word(nd_current->ram + addr, w);
 }
 
 static void nd_ram_bank3_bput(uaecptr addr, uae_u32 b)
 {
     addr &= ND_RAM_bankmask3;
-    ND_ram[addr] = b;
+    nd_current->ram[addr] = b;
 }
 
 static uae_u32 nd_ram_empty_lget(uaecptr addr)
@@ -271,37 +267,37 @@ static void nd_ram_empty_bput(uaecptr addr, uae_u32 b)
 static uae_u32 nd_vram_lget(uaecptr addr)
 {
     addr &= ND_VRAM_MASK;
-    return do_get_mem_long(ND_vram + addr);
+    return do_get_mem_long(nd_current->vram + addr);
 }
 
 static uae_u32 nd_vram_wget(uaecptr addr)
 {
     addr &= ND_VRAM_MASK;
-    return do_get_mem_word(ND_vram + addr);
+    return do_get_mem_word(nd_current->vram + addr);
 }
 
 static uae_u32 nd_vram_bget(uaecptr addr)
 {
     addr &= ND_VRAM_MASK;
-    return ND_vram[addr];
+    return nd_current->vram[addr];
 }
 
 static void nd_vram_lput(uaecptr addr, uae_u32 l)
 {
     addr &= ND_VRAM_MASK;
-    do_put_mem_long(ND_vram + addr, l);
+    do_put_mem_long(nd_current->vram + addr, l);
 }
 
 static void nd_vram_wput(uaecptr addr, uae_u32 w)
 {
     addr &= ND_VRAM_MASK;
-    do_put_mem_word(ND_vram + addr, w);
+    do_put_mem_word(nd_current->vram + addr, w);
 }
 
 static void nd_vram_bput(uaecptr addr, uae_u32 b)
 {
     addr &= ND_VRAM_MASK;
-    ND_vram[addr] = b;
+    nd_current->vram[addr] = b;
 }
 
 /* NeXTdimension ROM */
@@ -350,7 +346,7 @@ static void nd_rom_bput(uaecptr addr, uae_u32 b)
 static uae_u32 nd_rom_cs8get(uaecptr addr)
 {
     addr &= ND_EEPROM_MASK;
-    return ND_rom[addr];
+    return nd_current->rom[addr];
 }
 
 /* Illegal access functions */
@@ -429,26 +425,26 @@ static void nd_unknown_bput(uaecptr addr, uae_u32 b)
 static uae_u32 nd_dmem_lget(uaecptr addr)
 {
     addr &= ND_DP_MASK;
-    return addr < ND_DMEM_SIZE ? do_get_mem_long(ND_dmem + addr) : nd_dp_lget(addr);
+    return addr < ND_DMEM_SIZE ? do_get_mem_long(nd_current->dmem + addr) : nd_dp_lget(addr);
 }
 
 static uae_u32 nd_dmem_wget(uaecptr addr)
 {
     addr &= ND_DP_MASK;
-    return addr < ND_DMEM_SIZE ? do_get_mem_word(ND_dmem + addr) : nd_dp_lget(addr);
+    return addr < ND_DMEM_SIZE ? do_get_mem_word(nd_current->dmem + addr) : nd_dp_lget(addr);
 }
 
 static uae_u32 nd_dmem_bget(uaecptr addr)
 {
     addr &= ND_DP_MASK;
-    return addr < ND_DMEM_SIZE ? do_get_mem_byte(ND_dmem + addr) : nd_dp_lget(addr);
+    return addr < ND_DMEM_SIZE ? do_get_mem_byte(nd_current->dmem + addr) : nd_dp_lget(addr);
 }
 
 static void nd_dmem_lput(uaecptr addr, uae_u32 l)
 {
     addr &= ND_DP_MASK;
     if(addr < ND_DMEM_SIZE)
-        do_put_mem_long(ND_dmem + addr, l);
+        do_put_mem_long(nd_current->dmem + addr, l);
     else
         nd_dp_lput(addr, l);
 }
@@ -457,7 +453,7 @@ static void nd_dmem_wput(uaecptr addr, uae_u32 w)
 {
     addr &= ND_DP_MASK;
     if(addr < ND_DMEM_SIZE)
-        do_put_mem_word(ND_dmem + addr, w);
+        do_put_mem_word(nd_current->dmem + addr, w);
     else
         nd_dp_lput(addr, w);
 }
@@ -466,7 +462,7 @@ static void nd_dmem_bput(uaecptr addr, uae_u32 b)
 {
     addr &= ND_DP_MASK;
     if(addr < ND_DMEM_SIZE)
-        do_put_mem_byte(ND_dmem + addr, b);
+        do_put_mem_byte(nd_current->dmem + addr, b);
     else
         nd_dp_lput(addr, b);
 }
@@ -567,14 +563,28 @@ static void nd_init_mem_banks (void)
 
 void nd_memory_init(void) {
 	
-	write_log("[ND] Memory init: Memory size: %iMB\n",
+	write_log("[ND] Slot %i: Memory init: Memory size: %iMB\n", nd_current->slot,
               Configuration_CheckDimensionMemory(ConfigureParams.Dimension.nMemoryBankSize));
 
     /* Initialize banks with error memory */
     nd_init_mem_banks();
     
+    /* Allocate memory for all banks, pages are committed when used */
+    if (nd_current->ram == NULL) {
+        nd_current->ram = host_mem_alloc(ND_RAM_SIZE);
+        if (nd_current->ram == NULL) {
+            abort();
+        }
+    }
+    if (nd_current->vram == NULL) {
+        nd_current->vram = host_mem_alloc(ND_VRAM_SIZE);
+        if (nd_current->vram == NULL) {
+            abort();
+        }
+    }
+    
     /* Clear first 4k of memory for m68k ROM polling code */
-    memset(ND_ram, 0, 4096 * sizeof(Uint8));
+    memset(nd_current->ram, 0, 4096 * sizeof(Uint8));
     
     /* Map main memory */
     if (ConfigureParams.Dimension.nMemoryBankSize[0]) {
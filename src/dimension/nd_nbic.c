@@ -16,98 +16,98 @@ static volatile struct {
     Uint32 id;
     Uint8  intstatus;
     Uint8  intmask;
-} nd_nbic;
+} nd_nbic[ND_MAX_BOARDS];
 
 #if 0 // We keep this code around in case registers turn out to be accessible. For now, just for reference.
 static Uint8 nd_nbic_control_read0(Uint32 addr) {
     Log_Printf(ND_LOG_IO_RD, "[ND] NBIC Control (byte 0) read at %08X",addr);
-    return (nd_nbic.control>>24);
+    return (nd_nbic[nd_current->num].control>>24);
 }
 static Uint8 nd_nbic_control_read1(Uint32 addr) {
     Log_Printf(ND_LOG_IO_RD, "[ND] NBIC Control (byte 1) read at %08X",addr);
-    return (nd_nbic.control>>16);
+    return (nd_nbic[nd_current->num].control>>16);
 }
 static Uint8 nd_nbic_control_read2(Uint32 addr) {
     Log_Printf(ND_LOG_IO_RD, "[ND] NBIC Control (byte 2) read at %08X",addr);
-    return (nd_nbic.control>>8);
+    return (nd_nbic[nd_current->num].control>>8);
 }
 static Uint8 nd_nbic_control_read3(Uint32 addr) {
     Log_Printf(ND_LOG_IO_RD, "[ND] NBIC Control (byte 3) read at %08X",addr);
-    return nd_nbic.control;
+    return nd_nbic[nd_current->num].control;
 }
 
 static void nd_nbic_control_write0(Uint32 addr, Uint8 val) {
     Log_Printf(ND_LOG_IO_WR, "[ND] NBIC Control (byte 0) write %02X at %08X",val,addr);
-    nd_nbic.control &= 0x00FFFFFF;
-    nd_nbic.control |= (val&0xFF)<<24;
+    nd_nbic[nd_current->num].control &= 0x00FFFFFF;
+    nd_nbic[nd_current->num].control |= (val&0xFF)<<24;
 }
 static void nd_nbic_control_write1(Uint32 addr, Uint8 val) {
     Log_Printf(ND_LOG_IO_WR, "[ND] NBIC Control (byte 1) write %02X at %08X",val,addr);
-    nd_nbic.control &= 0xFF00FFFF;
-    nd_nbic.control |= (val&0xFF)<<16;
+    nd_nbic[nd_current->num].control &= 0xFF00FFFF;
+    nd_nbic[nd_current->num].control |= (val&0xFF)<<16;
 }
 static void nd_nbic_control_write2(Uint32 addr, Uint8 val) {
     Log_Printf(ND_LOG_IO_WR, "[ND] NBIC Control (byte 2) write %02X at %08X",val,addr);
-    nd_nbic.control &= 0xFFFF00FF;
-    nd_nbic.control |= (val&0xFF)<<8;
+    nd_nbic[nd_current->num].control &= 0xFFFF00FF;
+    nd_nbic[nd_current->num].control |= (val&0xFF)<<8;
 }
 static void nd_nbic_control_write3(Uint32 addr, Uint8 val) {
     Log_Printf(ND_LOG_IO_WR, "[ND] NBIC Control (byte 3) write %02X at %08X",val,addr);
-    nd_nbic.control &= 0xFFFFFF00;
-    nd_nbic.control |= val&0xFF;
+    nd_nbic[nd_current->num].control &= 0xFFFFFF00;
+    nd_nbic[nd_current->num].control |= val&0xFF;
 }
 
 static void nd_nbic_id_write0(Uint32 addr, Uint8 val) {
     Log_Printf(ND_LOG_IO_WR, "[ND] NBIC ID (byte 0) write %02X at %08X",val,addr);
-    nd_nbic.id &= 0x00FFFFFF;
-    nd_nbic.id |= (val&0xFF)<<24;
+    nd_nbic[nd_current->num].id &= 0x00FFFFFF;
+    nd_nbic[nd_current->num].id |= (val&0xFF)<<24;
 }
 static void nd_nbic_id_write1(Uint32 addr, Uint8 val) {
     Log_Printf(ND_LOG_IO_WR, "[ND] NBIC ID (byte 1) write %02X at %08X",val,addr);
-    nd_nbic.id &= 0xFF00FFFF;
-    nd_nbic.id |= (val&0xFF)<<16;
+    nd_nbic[nd_current->num].id &= 0xFF00FFFF;
+    nd_nbic[nd_current->num].id |= (val&0xFF)<<16;
 }
 static void nd_nbic_id_write2(Uint32 addr, Uint8 val) {
     Log_Printf(ND_LOG_IO_WR, "[ND] NBIC ID (byte 2) write %02X at %08X",val,addr);
-    nd_nbic.id &= 0xFFFF00FF;
-    nd_nbic.id |= (val&0xFF)<<8;
+    nd_nbic[nd_current->num].id &= 0xFFFF00FF;
+    nd_nbic[nd_current->num].id |= (val&0xFF)<<8;
 }
 static void nd_nbic_id_write3(Uint32 addr, Uint8 val) {
     Log_Printf(ND_LOG_IO_WR, "[ND] NBIC ID (byte 3) write %02X at %08X",val,addr);
-    nd_nbic.id &= 0xFFFFFF00;
-    nd_nbic.id |= val&0xFF;
+    nd_nbic[nd_current->num].id &= 0xFFFFFF00;
+    nd_nbic[nd_current->num].id |= val&0xFF;
 }
 #endif
 
 static Uint8 nd_nbic_id_read0(Uint32 addr) {
     Log_Printf(ND_LOG_IO_RD, "[ND] NBIC ID (byte 0) read at %08X",addr);
-    return (nd_nbic.id>>24);
+    return (nd_nbic[nd_current->num].id>>24);
 }
 static Uint8 nd_nbic_id_read1(Uint32 addr) {
     Log_Printf(ND_LOG_IO_RD, "[ND] NBIC ID (byte 1) read at %08X",addr);
-    return (nd_nbic.id>>16);
+    return (nd_nbic[nd_current->num].id>>16);
 }
 static Uint8 nd_nbic_id_read2(Uint32 addr) {
     Log_Printf(ND_LOG_IO_RD, "[ND] NBIC ID (byte 2) read at %08X",addr);
-    return (nd_nbic.id>>8);
+    return (nd_nbic[nd_current->num].id>>8);
 }
 static Uint8 nd_nbic_id_read3(Uint32 addr) {
     Log_Printf(ND_LOG_IO_RD, "[ND] NBIC ID (byte 3) read at %08X",addr);
-    return nd_nbic.id;
+    return nd_nbic[nd_current->num].id;
 }
 
 static Uint8 nd_nbic_intstatus_read(Uint32 addr) {
     Log_Printf(ND_LOG_IO_RD, "[ND] NBIC Interrupt status read at %08X",addr);
-    return nd_nbic.intstatus;
+    return nd_nbic[nd_current->num].intstatus;
 }
 
 static Uint8 nd_nbic_intmask_read(Uint32 addr) {
     Log_Printf(ND_LOG_IO_RD, "[ND] NBIC Interrupt mask read at %08X",addr);
-    return nd_nbic.intmask;
+    return nd_nbic[nd_current->num].intmask;
 }
 static void nd_nbic_intmask_write(Uint32 addr, Uint8 val) {
     Log_Printf(ND_LOG_IO_WR, "[ND] NBIC Interrupt mask write %02X at %08X",val,addr);
-    nd_nbic.intmask = val;
+    nd_nbic[nd_current->num].intmask = val;
 }
 
 static Uint8 nd_nbic_zero_read(Uint32 addr) {
@@ -212,9 +212,9 @@ void nd_nbic_bput(Uint32 addr, Uint8 b) {
 
 void nd_nbic_set_intstatus(bool set) {
 	if (set) {
-        nd_nbic.intstatus |= ND_NBIC_INTR;
+        nd_nbic[nd_current->num].intstatus |= ND_NBIC_INTR;
 	} else {
-        nd_nbic.intstatus &= ~ND_NBIC_INTR;
+        nd_nbic[nd_current->num].intstatus &= ~ND_NBIC_INTR;
 	}
 }
 
@@ -222,18 +222,21 @@ void nd_nbic_set_intstatus(bool set) {
 /* Reset function */
 
 void nd_nbic_init(void) {
-    nd_nbic.id = ND_NBIC_ID;
+    nd_nbic[nd_current->num].id = ND_NBIC_ID;
     /* Release any interrupt that may be pending */
-    nd_nbic.intmask   = 0;
-    nd_nbic.intstatus = 0;
+    nd_nbic[nd_current->num].intmask   = 0;
+    nd_nbic[nd_current->num].intstatus = 0;
     set_interrupt(INT_REMOTE, RELEASE_INT);
 }
 
-/* Interrupt functions */
+/* Interrupt functions, all boards share the remote interrupt */
 void nd_nbic_interrupt(void) {
-    if (nd_nbic.intmask&nd_nbic.intstatus&ND_NBIC_INTR) {
-        set_interrupt(INT_REMOTE, SET_INT);
-    } else {
-        set_interrupt(INT_REMOTE, RELEASE_INT);
+    int i;
+    for (i = 0; i < nd_num_boards(); i++) {
+        if (nd_nbic[i].intmask&nd_nbic[i].intstatus&ND_NBIC_INTR) {
+            set_interrupt(INT_REMOTE, SET_INT);
+            return;
+        }
     }
+    set_interrupt(INT_REMOTE, RELEASE_INT);
 }
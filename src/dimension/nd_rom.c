@@ -24,13 +24,19 @@
 #define ROM_ID_DEV      0xB4
 
 
-Uint8 nd_rom_command = 0x00;
-Uint32 nd_rom_last_addr = 0x00;
+/* Flash command state for each board */
+static struct nd_rom_state {
+    Uint8  command;
+    Uint32 last_addr;
+} nd_rom_state[ND_MAX_BOARDS];
 
 Uint8 nd_rom_read(Uint32 addr) {
-    switch (nd_rom_command) {
+    struct nd_rom_state* rs = &nd_rom_state[nd_current->num];
+    Uint8* rom = nd_current->rom;
+    
+    switch (rs->command) {
         case ROM_CMD_READ:
-            return ND_rom[addr];
+            return rom[addr];
         case ROM_CMD_READ_ID:
             switch (addr) {
                 case 0: return ROM_ID_MFG;
@@ -38,11 +44,11 @@ Uint8 nd_rom_read(Uint32 addr) {
                 default: return ROM_ID_DEV;
             }
         case (ROM_CMD_ERASE|ROM_CMD_VERIFY):
-            nd_rom_command = ROM_CMD_READ;
-            return ND_rom[addr];
+            rs->command = ROM_CMD_READ;
+            return rom[addr];
         case (ROM_CMD_WRITE|ROM_CMD_VERIFY):
-            nd_rom_command = ROM_CMD_READ;
-            return ND_rom[nd_rom_last_addr];
+            rs->command = ROM_CMD_READ;
+            return rom[rs->last_addr];
         case ROM_CMD_RESET:
         default:
             return 0;
@@ -50,25 +56,27 @@ Uint8 nd_rom_read(Uint32 addr) {
 }
 
 void nd_rom_write(Uint32 addr, Uint8 val) {
+    struct nd_rom_state* rs = &nd_rom_state[nd_current->num];
+    Uint8* rom = nd_current->rom;
     int i;
     
-    switch (nd_rom_command) {
+    switch (rs->command) {
         case ROM_CMD_WRITE:
             Log_Printf(LOG_WARN, "[ND] ROM: Writing ROM (addr=%04X, val=%02X)",addr,val);
-            ND_rom[addr] = val;
-            nd_rom_last_addr = addr;
-            nd_rom_command = ROM_CMD_READ;
+            rom[addr] = val;
+            rs->last_addr = addr;
+            rs->command = ROM_CMD_READ;
             break;
         case ROM_CMD_ERASE:
             if (val==ROM_CMD_ERASE) {
                 Log_Printf(LOG_WARN, "[ND] ROM: Erasing ROM");
                 for (i = 0; i < (128*1024); i++)
-                    ND_rom[i] = 0xFF;
+                    rom[i] = 0xFF;
                 break;
             } /* else fall through */
         default:
             Log_Printf(LOG_WARN, "[ND] ROM: Command %02X",val);
-            nd_rom_command = val;
+            rs->command = val;
             break;
     }
 }
@@ -78,8 +86,8 @@ void nd_rom_write(Uint32 addr, Uint8 val) {
 void nd_rom_load(void) {
     FILE* romfile;
     
-    nd_rom_command = ROM_CMD_READ;
-    nd_rom_last_addr = 0;
+    nd_rom_state[nd_current->num].command   = ROM_CMD_READ;
+    nd_rom_state[nd_current->num].last_addr = 0;
     
     if (!File_Exists(ConfigureParams.Dimension.szRomFileName)) {
         Log_Printf(LOG_WARN, "[ND] Error: ROM file does not exist or is not readable");
@@ -93,9 +101,9 @@ void nd_rom_load(void) {
         return;
     }
     
-    fread(ND_rom,1, 128 * 1024 ,romfile);
+    fread(nd_current->rom,1, 128 * 1024 ,romfile);
     
-    Log_Printf(LOG_WARN, "[ND] Read ROM from %s",ConfigureParams.Dimension.szRomFileName);
+    Log_Printf(LOG_WARN, "[ND] Slot %i: Read ROM from %s",nd_current->slot,ConfigureParams.Dimension.szRomFileName);
     
     File_Close(romfile);
 }
\ No newline at end of file
@@ -12,46 +12,51 @@ const int VIDEO_VBL_MS   = 1000 / 60; // NTSC display at 60Hz, actually this is
 const int BLANK_MS       = 2;         // Give some blank time for both
 
 static volatile bool doRepaint     = true;
-static SDL_Thread*   repaintThread = NULL;
-static SDL_Window*   ndWindow      = NULL;
-static SDL_Renderer* ndRenderer    = NULL;
 
-SDL_atomic_t blitNDFB;
+/* Each board has its own window and repaint thread */
+typedef struct {
+    NextDimension* nd;
+    SDL_Thread*    repaintThread;
+    SDL_Window*    ndWindow;
+    SDL_Renderer*  ndRenderer;
+    SDL_atomic_t   blitNDFB;
+} nd_sdl_t;
 
-void blitDimension(SDL_Texture* tex);
+static nd_sdl_t nd_sdl[ND_MAX_BOARDS];
 
-static int repainter(void* unused) {
+static int repainter(void* data) {
     SDL_SetThreadPriority(SDL_THREAD_PRIORITY_NORMAL);
     
+    nd_sdl_t*     sdl        = (nd_sdl_t*)data;
     SDL_Texture*  ndTexture  = NULL;
     
     SDL_Rect r = {0,0,1120,832};
     
-    ndRenderer = SDL_CreateRenderer(ndWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    sdl->ndRenderer = SDL_CreateRenderer(sdl->ndWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     
-    if (!ndRenderer) {
+    if (!sdl->ndRenderer) {
         fprintf(stderr,"[ND] Failed to create renderer!\n");
         exit(-1);
     }
     
-    SDL_RenderSetLogicalSize(ndRenderer, r.w, r.h);
-    ndTexture = SDL_CreateTexture(ndRenderer, SDL_PIXELFORMAT_UNKNOWN, SDL_TEXTUREACCESS_STREAMING, r.w, r.h);
+    SDL_RenderSetLogicalSize(sdl->ndRenderer, r.w, r.h);
+    ndTexture = SDL_CreateTexture(sdl->ndRenderer, SDL_PIXELFORMAT_UNKNOWN, SDL_TEXTUREACCESS_STREAMING, r.w, r.h);
     
-    SDL_AtomicSet(&blitNDFB, 1);
+    SDL_AtomicSet(&sdl->blitNDFB, 1);
     
     while(doRepaint) {
-        if (SDL_AtomicGet(&blitNDFB)) {
-            blitDimension(ndTexture);
-            SDL_RenderCopy(ndRenderer, ndTexture, NULL, NULL);
-            SDL_RenderPresent(ndRenderer);
+        if (SDL_AtomicGet(&sdl->blitNDFB)) {
+            blitDimension(sdl->nd->vram, ndTexture);
+            SDL_RenderCopy(sdl->ndRenderer, ndTexture, NULL, NULL);
+            SDL_RenderPresent(sdl->ndRenderer);
         } else {
             host_sleep_ms(100);
         }
     }
 
     SDL_DestroyTexture(ndTexture);
-    SDL_DestroyRenderer(ndRenderer);
-    SDL_DestroyWindow(ndWindow);
+    SDL_DestroyRenderer(sdl->ndRenderer);
+    SDL_DestroyWindow(sdl->ndWindow);
 
     return 0;
 }
@@ -60,7 +65,8 @@ static bool ndVBLtoggle;
 void nd_vbl_handler() {
     CycInt_AcknowledgeInterrupt();
     
-    host_blank(ND_SLOT, ND_DISPLAY, ndVBLtoggle);
+    for (int i = 0; i < nd_num_boards(); i++)
+        host_blank(ND_SLOT(i), ND_DISPLAY, ndVBLtoggle);
     ndVBLtoggle = !ndVBLtoggle;
     
     CycInt_AddRelativeInterruptUs((1000*1000)/136, 0, INTERRUPT_ND_VBL); // 136Hz with toggle gives 68Hz, blank time is 1/2 frame time
@@ -70,35 +76,50 @@ bool ndVideoVBLtoggle;
 void nd_video_vbl_handler() {
     CycInt_AcknowledgeInterrupt();
     
-    host_blank(ND_SLOT, ND_VIDEO, ndVideoVBLtoggle);
+    for (int i = 0; i < nd_num_boards(); i++)
+        host_blank(ND_SLOT(i), ND_VIDEO, ndVideoVBLtoggle);
     ndVideoVBLtoggle = !ndVideoVBLtoggle;
     
     CycInt_AddRelativeInterruptUs((1000*1000)/120, 0, INTERRUPT_ND_VIDEO_VBL); // 120Hz with toggle gives 60Hz NTSC, blank time is 1/2 frame time
 }
 
 void nd_sdl_init() {
-    if(!(repaintThread)) {
+    nd_sdl_t* sdl = &nd_sdl[nd_current->num];
+    
+    if(!(sdl->repaintThread) && !(sdl->ndWindow)) {
         int x, y, w, h;
+        char title[32];
         SDL_GetWindowPosition(sdlWindow, &x, &y);
         SDL_GetWindowSize(sdlWindow, &w, &h);
-        ndWindow   = SDL_CreateWindow("NeXTdimension",(x-w)+1, y, 1120, 832, SDL_WINDOW_HIDDEN);
+        if (nd_current->num)
+            snprintf(title, sizeof(title), "NeXTdimension (slot %i)", nd_current->slot);
+        else
+            snprintf(title, sizeof(title), "NeXTdimension");
+        x = (x-w)+1 + 32*nd_current->num;
+        y = y + 32*nd_current->num;
+        sdl->nd       = nd_current;
+        sdl->ndWindow = SDL_CreateWindow(title, x, y, 1120, 832, SDL_WINDOW_HIDDEN);
         
-        if (!ndWindow) {
+        if (!sdl->ndWindow) {
             fprintf(stderr,"[ND] Failed to create window!\n");
             exit(-1);
         }
     }
     
     if(ConfigureParams.Screen.nMonitorType == MONITOR_TYPE_DUAL) {
-        SDL_ShowWindow(ndWindow);
+        SDL_ShowWindow(sdl->ndWindow);
     } else {
-        SDL_HideWindow(ndWindow);
+        SDL_HideWindow(sdl->ndWindow);
     }
 }
 
 void nd_start_interrupts() {
-    if(!(repaintThread) && ConfigureParams.Screen.nMonitorType == MONITOR_TYPE_DUAL)
-        repaintThread = SDL_CreateThread(repainter, "[ND] repainter", NULL);
+    if (ConfigureParams.Screen.nMonitorType == MONITOR_TYPE_DUAL) {
+        for (int i = 0; i < nd_num_boards(); i++) {
+            if(nd_sdl[i].ndWindow && !(nd_sdl[i].repaintThread))
+                nd_sdl[i].repaintThread = SDL_CreateThread(repainter, "[ND] repainter", &nd_sdl[i]);
+        }
+    }
     
     // if this is a cube and we have an ND configured, install ND VBL handlers
     if (ConfigureParams.Dimension.bEnabled && (ConfigureParams.System.nMachineType == NEXT_CUBE030 || ConfigureParams.System.nMachineType == NEXT_CUBE040)) {
@@ -108,21 +129,24 @@ void nd_start_interrupts() {
 }
 
 void nd_sdl_uninit() {
-    SDL_HideWindow(ndWindow);
+    if (nd_sdl[nd_current->num].ndWindow)
+        SDL_HideWindow(nd_sdl[nd_current->num].ndWindow);
 }
 
 void nd_sdl_pause(bool pause) {
     if (pause) {
-        SDL_AtomicSet(&blitNDFB, 0);
+        SDL_AtomicSet(&nd_sdl[nd_current->num].blitNDFB, 0);
     } else {
-        SDL_AtomicSet(&blitNDFB, 1);
+        SDL_AtomicSet(&nd_sdl[nd_current->num].blitNDFB, 1);
     }
 }
 
 void nd_sdl_destroy() {
-    doRepaint = false; // stop repaint thread
+    doRepaint = false; // stop repaint threads
     int s;
-    SDL_WaitThread(repaintThread, &s);
-    nd_sdl_uninit();
+    for (int i = 0; i < ND_MAX_BOARDS; i++) {
+        if (nd_sdl[i].repaintThread)
+            SDL_WaitThread(nd_sdl[i].repaintThread, &s);
+    }
 }
 
@@ -30,23 +30,25 @@
 
 #define ND_DMCD_NUM_REG 25
 
-struct {
+struct nd_dmcd {
     uae_u8 addr;
     uae_u8 reg[ND_DMCD_NUM_REG];
-} dmcd;
+} dmcd[ND_MAX_BOARDS];
 
 
 void dmcd_write(uae_u32 step, uae_u8 data) {
+    struct nd_dmcd* d = &dmcd[nd_current->num];
+    
     if (step == 0) {
-        dmcd.addr = data;
+        d->addr = data;
     } else {
-        Log_Printf(LOG_VID_LEVEL, "[ND] DMCD: Writing register %i (%02X)", dmcd.addr, data);
+        Log_Printf(LOG_VID_LEVEL, "[ND] DMCD: Writing register %i (%02X)", d->addr, data);
         
-        if (dmcd.addr < ND_DMCD_NUM_REG) {
-            dmcd.reg[dmcd.addr] = data;
-            dmcd.addr++;
+        if (d->addr < ND_DMCD_NUM_REG) {
+            d->reg[d->addr] = data;
+            d->addr++;
         } else {
-            Log_Printf(LOG_WARN, "[ND] DMCD: Illegal register (%i)", dmcd.addr);
+            Log_Printf(LOG_WARN, "[ND] DMCD: Illegal register (%i)", d->addr);
         }
     }
 }
@@ -57,38 +59,40 @@ void dmcd_write(uae_u32 step, uae_u8 data) {
 #define ND_DCSC_CTRL    0x00
 #define ND_DCSC_CLUT    0x01
 
-struct {
+struct nd_dcsc {
     uae_u8 addr;
     uae_u8 ctrl;
     uae_u8 lut_r[256];
     uae_u8 lut_g[256];
     uae_u8 lut_b[256];
-} dcsc[2];
+} dcsc[ND_MAX_BOARDS][2];
 
 
 void dcsc_write(uae_u8 dev, uae_u32 step, uae_u8 data) {
+    struct nd_dcsc* d = &dcsc[nd_current->num][dev];
+    
     switch (step) {
         case 0:
-            dcsc[dev].addr = data;
+            d->addr = data;
             break;
         case 1:
-            if (dcsc[dev].addr == ND_DCSC_CTRL) {
+            if (d->addr == ND_DCSC_CTRL) {
                 Log_Printf(LOG_VID_LEVEL, "[ND] DCSC%i: Writing control (%02X)", dev, data);
                 
-                dcsc[dev].ctrl = data;
+                d->ctrl = data;
                 break;
             }
             /* else fall through */
 
         default:
-            if (dcsc[dev].addr == ND_DCSC_CLUT) {
+            if (d->addr == ND_DCSC_CLUT) {
                 Log_Printf(LOG_VID_LEVEL, "[ND] DCSC%i: Writing LUT at %i (%02X)", dev, step-1, data);
 
-                dcsc[dev].lut_r[(step-1)&0xFF] = data;
-                dcsc[dev].lut_g[(step-1)&0xFF] = data;
-                dcsc[dev].lut_b[(step-1)&0xFF] = data;
+                d->lut_r[(step-1)&0xFF] = data;
+                d->lut_g[(step-1)&0xFF] = data;
+                d->lut_b[(step-1)&0xFF] = data;
             } else {
-                Log_Printf(LOG_WARN, "[ND] DCSC%i: Unknown address (%02X)", dev, dcsc[dev].addr);
+                Log_Printf(LOG_WARN, "[ND] DCSC%i: Unknown address (%02X)", dev, d->addr);
             }
             break;
     }
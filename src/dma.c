@@ -161,12 +161,16 @@ int get_interrupt_type(int channel) {
     }
 }
 
-void DMA_CSR_Read(void) { // 0x02000010, length of register is byte on 68030 based NeXT Computer
-    int channel = get_channel(IoAccessCurrentAddress);
+Uint32 DMA_CSR_ReadLong(Uint32 addr) { // native long word read, used for status polling
+    int channel = get_channel(addr);
     
-    IoMem[IoAccessCurrentAddress & IO_SEG_MASK] = dma[channel].csr;
-    IoMem[(IoAccessCurrentAddress+1) & IO_SEG_MASK] = IoMem[(IoAccessCurrentAddress+2) & IO_SEG_MASK] = IoMem[(IoAccessCurrentAddress+3) & IO_SEG_MASK] = 0x00; // just to be sure
-    Log_Printf(LOG_DMA_LEVEL,"DMA CSR read at $%08x val=$%02x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].csr, m68k_getpc());
+    Log_Printf(LOG_DMA_LEVEL,"DMA CSR read at $%08x val=$%02x PC=$%08x\n", addr, dma[channel].csr, m68k_getpc());
+    return (Uint32)dma[channel].csr << 24;
+}
+
+void DMA_CSR_Read(void) { // 0x02000010, length of register is byte on 68030 based NeXT Computer
+    /* Lower bytes are zero, just to be sure */
+    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, DMA_CSR_ReadLong(IoAccessCurrentAddress));
 }
 
 void DMA_CSR_Write(void) {
@@ -283,52 +287,84 @@ void DMA_Saved_Stop_Write(void) {
     Log_Printf(LOG_DMA_LEVEL,"DMA SStop write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].saved_stop, m68k_getpc());
 }
 
-void DMA_Next_Read(void) { // 0x02004010
-    int channel = get_channel(IoAccessCurrentAddress-0x4000);
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].next);
- 	Log_Printf(LOG_DMA_LEVEL,"DMA Next read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].next, m68k_getpc());
+Uint32 DMA_Next_ReadLong(Uint32 addr) { // 0x02004010
+    int channel = get_channel(addr-0x4000);
+ 	Log_Printf(LOG_DMA_LEVEL,"DMA Next read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].next, m68k_getpc());
+    return dma[channel].next;
+}
+
+void DMA_Next_WriteLong(Uint32 addr, Uint32 val) {
+    int channel = get_channel(addr-0x4000);
+    dma[channel].next = val;
+    Log_Printf(LOG_DMA_LEVEL,"DMA Next write at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].next, m68k_getpc());
+}
+
+void DMA_Next_Read(void) {
+    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, DMA_Next_ReadLong(IoAccessCurrentAddress));
 }
 
 void DMA_Next_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress-0x4000);
-    dma[channel].next = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
-    Log_Printf(LOG_DMA_LEVEL,"DMA Next write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].next, m68k_getpc());
+    DMA_Next_WriteLong(IoAccessCurrentAddress, IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK));
+}
+
+Uint32 DMA_Limit_ReadLong(Uint32 addr) { // 0x02004014
+    int channel = get_channel(addr-0x4004);
+ 	Log_Printf(LOG_DMA_LEVEL,"DMA Limit read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].limit, m68k_getpc());
+    return dma[channel].limit;
 }
 
-void DMA_Limit_Read(void) { // 0x02004014
-    int channel = get_channel(IoAccessCurrentAddress-0x4004);
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].limit);
- 	Log_Printf(LOG_DMA_LEVEL,"DMA Limit read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].limit, m68k_getpc());
+void DMA_Limit_WriteLong(Uint32 addr, Uint32 val) {
+    int channel = get_channel(addr-0x4004);
+    dma[channel].limit = val;
+    Log_Printf(LOG_DMA_LEVEL,"DMA Limit write at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].limit, m68k_getpc());
+}
+
+void DMA_Limit_Read(void) {
+    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, DMA_Limit_ReadLong(IoAccessCurrentAddress));
 }
 
 void DMA_Limit_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress-0x4004);
-    dma[channel].limit = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
-    Log_Printf(LOG_DMA_LEVEL,"DMA Limit write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].limit, m68k_getpc());
+    DMA_Limit_WriteLong(IoAccessCurrentAddress, IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK));
+}
+
+Uint32 DMA_Start_ReadLong(Uint32 addr) { // 0x02004018
+    int channel = get_channel(addr-0x4008);
+ 	Log_Printf(LOG_DMA_LEVEL,"DMA Start read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].start, m68k_getpc());
+    return dma[channel].start;
+}
+
+void DMA_Start_WriteLong(Uint32 addr, Uint32 val) {
+    int channel = get_channel(addr-0x4008);
+    dma[channel].start = val;
+    Log_Printf(LOG_DMA_LEVEL,"DMA Start write at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].start, m68k_getpc());
 }
 
-void DMA_Start_Read(void) { // 0x02004018
-    int channel = get_channel(IoAccessCurrentAddress-0x4008);
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].start);
- 	Log_Printf(LOG_DMA_LEVEL,"DMA Start read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].start, m68k_getpc());
+void DMA_Start_Read(void) {
+    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, DMA_Start_ReadLong(IoAccessCurrentAddress));
 }
 
 void DMA_Start_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress-0x4008);
-    dma[channel].start = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
-    Log_Printf(LOG_DMA_LEVEL,"DMA Start write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].start, m68k_getpc());
+    DMA_Start_WriteLong(IoAccessCurrentAddress, IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK));
 }
 
-void DMA_Stop_Read(void) { // 0x0200401c
-    int channel = get_channel(IoAccessCurrentAddress-0x400C);
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].stop);
- 	Log_Printf(LOG_DMA_LEVEL,"DMA Stop read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].stop, m68k_getpc());
+Uint32 DMA_Stop_ReadLong(Uint32 addr) { // 0x0200401c
+    int channel = get_channel(addr-0x400C);
+ 	Log_Printf(LOG_DMA_LEVEL,"DMA Stop read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].stop, m68k_getpc());
+    return dma[channel].stop;
+}
+
+void DMA_Stop_WriteLong(Uint32 addr, Uint32 val) {
+    int channel = get_channel(addr-0x400C);
+    dma[channel].stop = val;
+    Log_Printf(LOG_DMA_LEVEL,"DMA Stop write at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].stop, m68k_getpc());
+}
+
+void DMA_Stop_Read(void) {
+    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, DMA_Stop_ReadLong(IoAccessCurrentAddress));
 }
 
 void DMA_Stop_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress-0x400C);
-    dma[channel].stop = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
-    Log_Printf(LOG_DMA_LEVEL,"DMA Stop write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].stop, m68k_getpc());
+    DMA_Stop_WriteLong(IoAccessCurrentAddress, IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK));
 }
 
 void DMA_Init_Read(void) { // 0x02004210
@@ -690,10 +726,8 @@ void dma_mo_read_memory(void) {
 }
 
 
-Uint8* dma_sndout_read_memory(int* len) {
-    int i;
-    Uint8* result = NULL;
-    *len          = 0;
+int dma_sndout_read_memory(Uint8* buf, int size) {
+    volatile int len = 0;
     
     if (dma[CHANNEL_SOUNDOUT].csr&DMA_ENABLE) {
         
@@ -708,10 +742,12 @@ Uint8* dma_sndout_read_memory(int* len) {
         }
         
         TRY(prb) {
-            *len   = dma[CHANNEL_SOUNDOUT].limit - dma[CHANNEL_SOUNDOUT].next;
-            result = malloc(*len * 2);
-            for(i = 0; dma[CHANNEL_SOUNDOUT].next<dma[CHANNEL_SOUNDOUT].limit; dma[CHANNEL_SOUNDOUT].next++, i++)
-                result[i] = NEXTMemory_ReadByte(dma[CHANNEL_SOUNDOUT].next);
+            /* Read at most size bytes, the rest is read on the next call */
+            while (dma[CHANNEL_SOUNDOUT].next<dma[CHANNEL_SOUNDOUT].limit && len<size) {
+                dma_putlong(NEXTMemory_ReadLong(dma[CHANNEL_SOUNDOUT].next), buf, len);
+                dma[CHANNEL_SOUNDOUT].next+=4;
+                len+=4;
+            }
         } CATCH(prb) {
             Log_Printf(LOG_WARN, "[DMA] Channel Sound Out: Bus error reading from %08x",dma[CHANNEL_SOUNDOUT].next);
             dma[CHANNEL_SOUNDOUT].csr &= ~DMA_ENABLE;
@@ -719,7 +755,7 @@ Uint8* dma_sndout_read_memory(int* len) {
         } ENDTRY
     }
     
-    return result;
+    return len;
 }
 
 void dma_sndout_intr() {
@@ -728,32 +764,42 @@ void dma_sndout_intr() {
     }
 }
 
+#define SNDIN_SPAN 1024
+
 int dma_sndin_write_memory() {
-	int value = 0;
+	Uint8 buf[SNDIN_SPAN];
+	int len, i;
 	
     if (dma[CHANNEL_SOUNDIN].csr&DMA_ENABLE) {
 		
-		Audio_Input_Lock();
-
         Log_Printf(LOG_DMA_LEVEL, "[DMA] Channel Sound In: Write to memory at $%08x, %i bytes",
                    dma[CHANNEL_SOUNDIN].next,dma[CHANNEL_SOUNDIN].limit-dma[CHANNEL_SOUNDIN].next);
 
 		TRY(prb) {
             while (dma[CHANNEL_SOUNDIN].next<dma[CHANNEL_SOUNDIN].limit) {
-                value = Audio_Input_Read();
-				if (value < 0) {
+				/* Take a span from the input ring and store it long by long */
+                len = dma[CHANNEL_SOUNDIN].limit-dma[CHANNEL_SOUNDIN].next;
+				len = Audio_Input_Read(buf, len < SNDIN_SPAN ? len : SNDIN_SPAN);
+				if (len <= 0) {
 					break;
 				}
-				NEXTMemory_WriteByte(dma[CHANNEL_SOUNDIN].next, value);
-				dma[CHANNEL_SOUNDIN].next++;
+				for (i = 0; i < len; ) {
+					if (!(dma[CHANNEL_SOUNDIN].next&3) && len-i >= 4) {
+						NEXTMemory_WriteLong(dma[CHANNEL_SOUNDIN].next, dma_getlong(buf, i));
+						dma[CHANNEL_SOUNDIN].next+=4;
+						i+=4;
+					} else {
+						NEXTMemory_WriteByte(dma[CHANNEL_SOUNDIN].next, buf[i]);
+						dma[CHANNEL_SOUNDIN].next++;
+						i++;
+					}
+				}
             }
         } CATCH(prb) {
             Log_Printf(LOG_WARN, "[DMA] Channel Sound In: Bus error reading from %08x",dma[CHANNEL_SOUNDIN].next);
             dma[CHANNEL_SOUNDIN].csr &= ~DMA_ENABLE;
             dma[CHANNEL_SOUNDIN].csr |= (DMA_COMPLETE|DMA_BUSEXC);
         } ENDTRY
-		
-		Audio_Input_Unlock();
 
         dma[CHANNEL_SOUNDIN].saved_limit = dma[CHANNEL_SOUNDIN].next;
         dma_interrupt(CHANNEL_SOUNDIN);
@@ -776,10 +822,15 @@ void dma_printer_read_memory(void) {
         }
         
         TRY(prb) {
+            /* Alignment is checked above, transfer long words */
             while (dma[CHANNEL_PRINTER].next<dma[CHANNEL_PRINTER].limit && lp_buffer.size<lp_buffer.limit) {
-                lp_buffer.data[lp_buffer.size]=NEXTMemory_ReadByte(dma[CHANNEL_PRINTER].next);
-                lp_buffer.size++;
-                dma[CHANNEL_PRINTER].next++;
+                Uint32 val = NEXTMemory_ReadLong(dma[CHANNEL_PRINTER].next);
+                lp_buffer.data[lp_buffer.size]   = val>>24;
+                lp_buffer.data[lp_buffer.size+1] = val>>16;
+                lp_buffer.data[lp_buffer.size+2] = val>>8;
+                lp_buffer.data[lp_buffer.size+3] = val;
+                lp_buffer.size+=4;
+                dma[CHANNEL_PRINTER].next+=4;
             }
         } CATCH(prb) {
             Log_Printf(LOG_WARN, "[DMA] Channel Printer: Bus error reading from %08x",dma[CHANNEL_PRINTER].next);
@@ -959,18 +1010,23 @@ void dma_m2m_write_memory(void) {
 /* Channel DSP */
 #define LOG_DMA_DSP_LEVEL	LOG_DEBUG
 
-void dma_dsp_write_memory(Uint8 val) {
+/* The DSP host port moves a whole word per request, transfer it as one
+ * block with a single DMA state update at the end. Both functions
+ * return the number of bytes transferred. */
+int dma_dsp_write_memory(const Uint8 *buf, int len) {
+	Uint32 start = dma[CHANNEL_DSP].next;
+	
 	Log_Printf(LOG_DMA_DSP_LEVEL, "[DMA] Channel DSP: Write to memory at $%08x, %i bytes",
 			   dma[CHANNEL_DSP].next,dma[CHANNEL_DSP].limit-dma[CHANNEL_DSP].next);
 	
 	if (!(dma[CHANNEL_DSP].csr&DMA_ENABLE)) {
 		Log_Printf(LOG_WARN, "[DMA] Channel DSP: Error! DMA not enabled!");
-		return;
+		return 0;
 	}
 	
 	TRY(prb) {
-		if (dma[CHANNEL_DSP].next<dma[CHANNEL_DSP].limit) {
-			NEXTMemory_WriteByte(dma[CHANNEL_DSP].next, val);
+		while (dma[CHANNEL_DSP].next<dma[CHANNEL_DSP].limit && dma[CHANNEL_DSP].next-start<(Uint32)len) {
+			NEXTMemory_WriteByte(dma[CHANNEL_DSP].next, buf[dma[CHANNEL_DSP].next-start]);
 			dma[CHANNEL_DSP].next++;
 		}
 	} CATCH(prb) {
@@ -983,26 +1039,27 @@ void dma_dsp_write_memory(Uint8 val) {
 		DSP_SetIRQB();
 		dma_interrupt(CHANNEL_DSP);
 	}
+	return dma[CHANNEL_DSP].next-start;
 }
 
-Uint8 dma_dsp_read_memory(void) {
-	Uint8 val = 0;
+int dma_dsp_read_memory(Uint8 *buf, int len) {
+	Uint32 start = dma[CHANNEL_DSP].next;
 	
 	Log_Printf(LOG_DMA_DSP_LEVEL, "[DMA] Channel DSP: Read from memory at $%08x, %i bytes",
 			   dma[CHANNEL_DSP].next,dma[CHANNEL_DSP].limit-dma[CHANNEL_DSP].next);
 	
 	if (!(dma[CHANNEL_DSP].csr&DMA_ENABLE)) {
 		Log_Printf(LOG_WARN, "[DMA] Channel DSP: Error! DMA not enabled!");
-		return val;
+		return 0;
 	}
 	
 	TRY(prb) {
-		if (dma[CHANNEL_DSP].next<dma[CHANNEL_DSP].limit) {
-			val = NEXTMemory_ReadByte(dma[CHANNEL_DSP].next);
+		while (dma[CHANNEL_DSP].next<dma[CHANNEL_DSP].limit && dma[CHANNEL_DSP].next-start<(Uint32)len) {
+			buf[dma[CHANNEL_DSP].next-start] = NEXTMemory_ReadByte(dma[CHANNEL_DSP].next);
 			dma[CHANNEL_DSP].next++;
 		}
 	} CATCH(prb) {
-		Log_Printf(LOG_WARN, "[DMA] Channel DSP: Bus error while writing to %08x",dma[CHANNEL_DSP].next);
+		Log_Printf(LOG_WARN, "[DMA] Channel DSP: Bus error while reading from %08x",dma[CHANNEL_DSP].next);
 		dma[CHANNEL_DSP].csr &= ~DMA_ENABLE;
 		dma[CHANNEL_DSP].csr |= (DMA_COMPLETE|DMA_BUSEXC);
 	} ENDTRY
@@ -1011,17 +1068,16 @@ Uint8 dma_dsp_read_memory(void) {
 		DSP_SetIRQB();
 		dma_interrupt(CHANNEL_DSP);
 	}
-	return val;
+	return dma[CHANNEL_DSP].next-start;
 }
 
-bool dma_dsp_ready(void) {
+/* Bytes left in the current DSP DMA buffer */
+int dma_dsp_available(void) {
 	if (!(dma[CHANNEL_DSP].csr&DMA_ENABLE) ||
 		!(dma[CHANNEL_DSP].next<dma[CHANNEL_DSP].limit)) {
-		Log_Printf(LOG_DEBUG, "[DMA] Channel DSP: Not ready!");
-		return false;
-	} else {
-		return true;
+		return 0;
 	}
+	return dma[CHANNEL_DSP].limit-dma[CHANNEL_DSP].next;
 }
 
 
@@ -1044,17 +1100,52 @@ void dma_video_interrupt(void) {
 }
 
 
-/* FIXME: This is just for passing power-on test. Add real SCC channel later. */
-
+/* Channel SCC */
 void dma_scc_read_memory(void) {
-    Log_Printf(LOG_DMA_LEVEL, "[DMA] Channel SCC: Read from memory at $%08x, %i bytes",
-               dma[CHANNEL_SCC].next,dma[CHANNEL_SCC].limit-dma[CHANNEL_SCC].next);
-    while (dma[CHANNEL_SCC].next<dma[CHANNEL_SCC].limit) {
-        scc_buf[0]=NEXTMemory_ReadByte(dma[CHANNEL_SCC].next);
-        dma[CHANNEL_SCC].next++;
+    if (dma[CHANNEL_SCC].csr&DMA_ENABLE) {
+        Log_Printf(LOG_DMA_LEVEL, "[DMA] Channel SCC: Read from memory at $%08x, %i bytes",
+                   dma[CHANNEL_SCC].next,dma[CHANNEL_SCC].limit-dma[CHANNEL_SCC].next);
+        
+        TRY(prb) {
+            while (dma[CHANNEL_SCC].next<dma[CHANNEL_SCC].limit && SCC_DMA_TxReady()) {
+                SCC_DMA_Transmit(NEXTMemory_ReadByte(dma[CHANNEL_SCC].next));
+                dma[CHANNEL_SCC].next++;
+            }
+        } CATCH(prb) {
+            Log_Printf(LOG_WARN, "[DMA] Channel SCC: Bus error reading from %08x",dma[CHANNEL_SCC].next);
+            dma[CHANNEL_SCC].csr &= ~DMA_ENABLE;
+            dma[CHANNEL_SCC].csr |= (DMA_COMPLETE|DMA_BUSEXC);
+        } ENDTRY
+        
+        dma_interrupt(CHANNEL_SCC);
     }
+}
+
+void dma_scc_write_memory(void) {
+    int value;
     
-    dma_interrupt(CHANNEL_SCC);
+    if (dma[CHANNEL_SCC].csr&DMA_ENABLE) {
+        Log_Printf(LOG_DMA_LEVEL, "[DMA] Channel SCC: Write to memory at $%08x, %i bytes",
+                   dma[CHANNEL_SCC].next,dma[CHANNEL_SCC].limit-dma[CHANNEL_SCC].next);
+        
+        TRY(prb) {
+            while (dma[CHANNEL_SCC].next<dma[CHANNEL_SCC].limit) {
+                value = SCC_DMA_Receive();
+                if (value < 0) {
+                    break;
+                }
+                NEXTMemory_WriteByte(dma[CHANNEL_SCC].next, value);
+                dma[CHANNEL_SCC].next++;
+            }
+        } CATCH(prb) {
+            Log_Printf(LOG_WARN, "[DMA] Channel SCC: Bus error writing to %08x",dma[CHANNEL_SCC].next);
+            dma[CHANNEL_SCC].csr &= ~DMA_ENABLE;
+            dma[CHANNEL_SCC].csr |= (DMA_COMPLETE|DMA_BUSEXC);
+        } ENDTRY
+        
+        dma[CHANNEL_SCC].saved_limit = dma[CHANNEL_SCC].next;
+        dma_interrupt(CHANNEL_SCC);
+    }
 }
 
 
@@ -132,36 +132,58 @@ void DSP_SetIRQB(void)
 
 
 /**
- * Handling DMA transfers.
+ * Handling DMA transfers. The rest of the current host port word is
+ * moved in one go, as long as the host port requests more data.
  */
 static void DSP_HandleDMA(void)
 {
 #if ENABLE_DSP_EMU
-	if (dsp_core.dma_mode && dsp_core.dma_request && dma_dsp_ready()) {
+	Uint8 buf[5];
+	int count, extra, avail, n, i;
+
+	while (dsp_core.dma_mode && dsp_core.dma_request && (avail = dma_dsp_available()) > 0) {
 		/* Set the counter according to selected DMA mode */
 		if (dsp_core.dma_address_counter==0) {
 			dsp_core.dma_address_counter = 4-dsp_core.dma_mode;
 			/* Handle unpacked mode on Turbo systems */
 			if (dsp_dma_unpacked && ConfigureParams.System.bTurbo) {
-					dsp_core.dma_address_counter = 4;
+				dsp_core.dma_address_counter = 4;
 			}
 		}
-		dsp_core.dma_address_counter--;
-		
+		count = dsp_core.dma_address_counter;
+		if (count > avail) {
+			count = avail;
+		}
+		/* Unpacked mode on non-Turbo systems transfers an additional byte */
+		extra = (dsp_dma_unpacked && count==dsp_core.dma_address_counter &&
+		         !ConfigureParams.System.bTurbo) ? 1 : 0;
+
 		/* Read or write via DMA */
 		if (dsp_core.dma_direction==(1<<CPU_HOST_ICR_TREQ)) {
-			dsp_core_write_host(CPU_HOST_TRXL-dsp_core.dma_address_counter, dma_dsp_read_memory());
+			memset(buf, 0, sizeof(buf));
+			n = dma_dsp_read_memory(buf, count+extra);
+			if (n < count) {
+				count = n;	/* bus error */
+				extra = 0;
+			}
+			for (i = 0; i < count; i++) {
+				dsp_core.dma_address_counter--;
+				dsp_core_write_host(CPU_HOST_TRXL-dsp_core.dma_address_counter, buf[i]);
+			}
+			if (extra) {
+				dsp_core_write_host(CPU_HOST_TRX0, buf[count]);
+			}
 		} else {
-			dma_dsp_write_memory(dsp_core_read_host(CPU_HOST_TRXL-dsp_core.dma_address_counter));
-		}
-		
-		/* Handle unpacked mode on non-Turbo systems */
-		if (dsp_dma_unpacked && dsp_core.dma_address_counter==0 && !ConfigureParams.System.bTurbo) {
-			if (dsp_core.dma_direction==(1<<CPU_HOST_ICR_TREQ)) {
-				dsp_core_write_host(CPU_HOST_TRX0, dma_dsp_read_memory());
-			} else {
-				dma_dsp_write_memory(dsp_core_read_host(CPU_HOST_TRX0));
+			for (i = 0; i < count; i++) {
+				dsp_core.dma_address_counter--;
+				buf[i] = dsp_core_read_host(CPU_HOST_TRXL-dsp_core.dma_address_counter);
 			}
+			if (extra) {
+				buf[count] = dsp_core_read_host(CPU_HOST_TRX0);
+			}
+			n = dma_dsp_write_memory(buf, count+extra);
+		}
+		if (extra || n < count+extra) {
 			return;
 		}
 	}
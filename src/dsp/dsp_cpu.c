@@ -118,6 +118,9 @@
 static Uint32 start_time;
 static Uint32 num_inst;
 
+/* Total number of executed instructions */
+Uint64 dsp56k_insn_count;
+
 /* Length of current instruction */
 static Uint32 cur_inst_len;	/* =0:jump, >0:increment */
 
@@ -852,6 +855,8 @@ void dsp56k_execute_instruction(void)
 	/* Process Interrupts */
 	dsp_postexecute_interrupts();
 
+	dsp56k_insn_count++;
+
 #if DSP_COUNT_IPS
 	++num_inst;
 	if ((num_inst & 63) == 0) {
@@ -113,6 +113,7 @@ extern "C" {
 /* Functions */
 extern void dsp56k_init_cpu(void);		/* Set dsp_core to use */
 extern void dsp56k_execute_instruction(void);	/* Execute 1 instruction */
+extern Uint64 dsp56k_insn_count;		/* Instructions executed since start */
 extern Uint16 dsp56k_execute_one_disasm_instruction(FILE *out, Uint16 pc);	/* Execute 1 instruction in disasm mode */
 
 /* Interrupt relative functions */
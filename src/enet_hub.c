@@ -0,0 +1,186 @@
+/*  Previous - enet_hub.c
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+
+  Hub process for the virtual Ethernet switch backend (enet_switch.c).
+  Instances send raw frames as datagrams to the hub socket. The hub learns
+  which instance owns which MAC address, forwards unicast frames to their
+  owner and floods broadcast, multicast and unknown destinations to all
+  other instances. Instances join by sending an empty datagram and are
+  dropped when they can no longer be reached.
+
+  usage: enet_hub [socket path]
+*/
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define HUB_MAX_PEERS   64
+#define HUB_MAX_MACS    256
+#define HUB_FRAMESZ     1536
+
+typedef struct {
+    struct sockaddr_un addr;
+    socklen_t          len;
+    bool               used;
+} hub_peer_t;
+
+typedef struct {
+    unsigned char mac[6];
+    int           peer;
+} hub_mac_t;
+
+static hub_peer_t    peers[HUB_MAX_PEERS];
+static hub_mac_t     macs[HUB_MAX_MACS];
+static int           nmacs;
+static int           sock;
+static const char   *path;
+
+
+static int hub_find_peer(const struct sockaddr_un *addr, socklen_t len) {
+    int i, free_slot = -1;
+
+    for (i = 0; i < HUB_MAX_PEERS; i++) {
+        if (peers[i].used) {
+            if (peers[i].len == len && !memcmp(&peers[i].addr, addr, len))
+                return i;
+        } else if (free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    if (free_slot >= 0) {
+        peers[free_slot].addr = *addr;
+        peers[free_slot].len  = len;
+        peers[free_slot].used = true;
+        printf("enet_hub: peer %s joined\n", addr->sun_path);
+    }
+    return free_slot;
+}
+
+static void hub_drop_peer(int p) {
+    int i;
+
+    printf("enet_hub: peer %s left\n", peers[p].addr.sun_path);
+    peers[p].used = false;
+    for (i = 0; i < nmacs; i++) {
+        if (macs[i].peer == p) {
+            macs[i--] = macs[--nmacs];
+        }
+    }
+}
+
+static void hub_learn(const unsigned char *mac, int p) {
+    int i;
+
+    if (mac[0] & 1)
+        return;     /* group addresses are never sources */
+    for (i = 0; i < nmacs; i++) {
+        if (!memcmp(macs[i].mac, mac, 6)) {
+            macs[i].peer = p;
+            return;
+        }
+    }
+    if (nmacs < HUB_MAX_MACS) {
+        memcpy(macs[nmacs].mac, mac, 6);
+        macs[nmacs++].peer = p;
+    }
+}
+
+static int hub_lookup(const unsigned char *mac) {
+    int i;
+
+    if (mac[0] & 1)
+        return -1;  /* broadcast or multicast */
+    for (i = 0; i < nmacs; i++) {
+        if (!memcmp(macs[i].mac, mac, 6))
+            return macs[i].peer;
+    }
+    return -1;
+}
+
+static void hub_send(int p, const unsigned char *frame, int len) {
+    if (sendto(sock, frame, len, MSG_DONTWAIT, (struct sockaddr*)&peers[p].addr, peers[p].len) < 0) {
+        if (errno == ECONNREFUSED || errno == ENOENT)
+            hub_drop_peer(p);
+    }
+}
+
+static void hub_exit(int sig) {
+    unlink(path);
+    exit(0);
+}
+
+int main(int argc, char *argv[]) {
+    struct sockaddr_un addr, from;
+    unsigned char frame[HUB_FRAMESZ];
+    socklen_t fromlen;
+    int len, src, dst, i;
+
+    if (argc > 2) {
+        fprintf(stderr, "usage: %s [socket path]\n", argv[0]);
+        return 1;
+    }
+    if (argc == 2) {
+        path = argv[1];
+    } else {
+        static char def[FILENAME_MAX];
+        snprintf(def, sizeof(def), "%s/.previous/enet_hub", getenv("HOME") ? getenv("HOME") : ".");
+        path = def;
+    }
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "enet_hub: socket path %s is too long\n", path);
+        return 1;
+    }
+
+    sock = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        perror("enet_hub: socket");
+        return 1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("enet_hub: bind");
+        return 1;
+    }
+    signal(SIGINT, hub_exit);
+    signal(SIGTERM, hub_exit);
+    printf("enet_hub: listening on %s\n", path);
+
+    for (;;) {
+        fromlen = sizeof(from);
+        len = recvfrom(sock, frame, sizeof(frame), 0, (struct sockaddr*)&from, &fromlen);
+        if (len < 0) {
+            if (errno != EINTR)
+                perror("enet_hub: recvfrom");
+            continue;
+        }
+        src = hub_find_peer(&from, fromlen);
+        if (src < 0 || len < 14)
+            continue;   /* join message or runt frame */
+
+        hub_learn(frame + 6, src);
+        dst = hub_lookup(frame);
+        if (dst >= 0) {
+            if (dst != src)
+                hub_send(dst, frame, len);
+        } else {
+            for (i = 0; i < HUB_MAX_PEERS; i++) {
+                if (peers[i].used && i != src)
+                    hub_send(i, frame, len);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,219 @@
+/*  Previous - enet_switch.c
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+
+  Virtual Ethernet switch backend. Raw frames are exchanged with the
+  enet_hub process over a UNIX datagram socket, so that several emulated
+  machines on the same host can talk to each other without going through
+  SLiRP. Frames are batched in both directions: received frames are read
+  with one recvmmsg call into a ring and handed to the controller one at a
+  time, sent frames are collected and flushed with one sendmmsg call on the
+  next poll.
+
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     /* sendmmsg, recvmmsg */
+#endif
+
+#include "main.h"
+#include "configuration.h"
+#include "log.h"
+#include "ethernet.h"
+#include "enet_switch.h"
+
+#if HAVE_UNIX_DOMAIN_SOCKETS
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+
+#define SWITCH_BATCH    32      /* frames per sendmmsg/recvmmsg call */
+#define SWITCH_FRAMESZ  1536    /* larger than maximum Ethernet frame */
+
+static int  switch_sock = -1;
+static char switch_local[sizeof(((struct sockaddr_un*)0)->sun_path)];
+
+/* Receive ring, filled by recvmmsg and drained by enet_switch_queue_poll */
+static Uint8 rx_ring[SWITCH_BATCH][SWITCH_FRAMESZ];
+static int   rx_len[SWITCH_BATCH];
+static int   rx_head;
+static int   rx_count;
+
+/* Transmit batch, flushed by sendmmsg */
+static Uint8 tx_ring[SWITCH_BATCH][SWITCH_FRAMESZ];
+static int   tx_len[SWITCH_BATCH];
+static int   tx_count;
+
+
+static void enet_switch_flush(void) {
+    int i = 0;
+#if HAVE_SENDMMSG
+    struct mmsghdr msg[SWITCH_BATCH];
+    struct iovec   iov[SWITCH_BATCH];
+    int n;
+
+    memset(msg, 0, sizeof(msg));
+    for (n = 0; n < tx_count; n++) {
+        iov[n].iov_base = tx_ring[n];
+        iov[n].iov_len  = tx_len[n];
+        msg[n].msg_hdr.msg_iov    = &iov[n];
+        msg[n].msg_hdr.msg_iovlen = 1;
+    }
+    while (i < tx_count) {
+        n = sendmmsg(switch_sock, &msg[i], tx_count - i, MSG_DONTWAIT);
+        if (n <= 0)
+            break;
+        i += n;
+    }
+#else
+    for (; i < tx_count; i++) {
+        if (send(switch_sock, tx_ring[i], tx_len[i], MSG_DONTWAIT) < 0)
+            break;
+    }
+#endif
+    if (i < tx_count) {
+        Log_Printf(LOG_WARN, "[SWITCH] Dropped %i packets (%s)", tx_count - i, strerror(errno));
+    }
+    tx_count = 0;
+}
+
+static void enet_switch_fill(void) {
+    int n;
+#if HAVE_RECVMMSG
+    struct mmsghdr msg[SWITCH_BATCH];
+    struct iovec   iov[SWITCH_BATCH];
+
+    memset(msg, 0, sizeof(msg));
+    for (n = 0; n < SWITCH_BATCH; n++) {
+        iov[n].iov_base = rx_ring[n];
+        iov[n].iov_len  = SWITCH_FRAMESZ;
+        msg[n].msg_hdr.msg_iov    = &iov[n];
+        msg[n].msg_hdr.msg_iovlen = 1;
+    }
+    rx_count = recvmmsg(switch_sock, msg, SWITCH_BATCH, MSG_DONTWAIT, NULL);
+    if (rx_count < 0)
+        rx_count = 0;
+    for (n = 0; n < rx_count; n++) {
+        rx_len[n] = msg[n].msg_len;
+    }
+#else
+    for (rx_count = 0; rx_count < SWITCH_BATCH; rx_count++) {
+        n = recv(switch_sock, rx_ring[rx_count], SWITCH_FRAMESZ, MSG_DONTWAIT);
+        if (n < 0)
+            break;
+        rx_len[rx_count] = n;
+    }
+#endif
+    rx_head = 0;
+}
+
+void enet_switch_queue_poll(void)
+{
+    if (switch_sock < 0)
+        return;
+
+    if (tx_count > 0) {
+        enet_switch_flush();
+    }
+    if (rx_count == 0) {
+        enet_switch_fill();
+    }
+    while (rx_count > 0) {
+        int len = rx_len[rx_head];
+        Uint8 *pkt = rx_ring[rx_head];
+        rx_head++;
+        rx_count--;
+        if (len > 0) {
+            Log_Printf(LOG_DEBUG, "[SWITCH] Getting packet from ring");
+            enet_receive(pkt, len);
+            break;
+        }
+    }
+}
+
+void enet_switch_input(Uint8 *pkt, int pkt_len) {
+    if (switch_sock < 0)
+        return;
+
+    if (pkt_len > SWITCH_FRAMESZ) {
+        Log_Printf(LOG_WARN, "[SWITCH] Packet too large (%i bytes)", pkt_len);
+        return;
+    }
+    memcpy(tx_ring[tx_count], pkt, pkt_len);
+    tx_len[tx_count] = pkt_len;
+    if (++tx_count == SWITCH_BATCH) {
+        enet_switch_flush();
+    }
+}
+
+void enet_switch_stop(void) {
+    if (switch_sock >= 0) {
+        Log_Printf(LOG_WARN, "Stopping virtual switch");
+        if (tx_count > 0) {
+            enet_switch_flush();
+        }
+        close(switch_sock);
+        unlink(switch_local);
+        switch_sock = -1;
+    }
+}
+
+void enet_switch_start(void) {
+    struct sockaddr_un addr;
+
+    if (switch_sock >= 0)
+        return;
+
+    Log_Printf(LOG_WARN, "Starting virtual switch at %s", ConfigureParams.Ethernet.szSwitchPath);
+
+    rx_head = rx_count = tx_count = 0;
+
+    /* Bind to a per-instance address so the hub can send to us */
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (snprintf(switch_local, sizeof(switch_local), "%s.%i", ConfigureParams.Ethernet.szSwitchPath,
+                 (int)getpid()) >= (int)sizeof(switch_local)) {
+        Log_Printf(LOG_WARN, "[SWITCH] Socket path %s is too long", ConfigureParams.Ethernet.szSwitchPath);
+        switch_local[0] = '\0';
+        return;
+    }
+    strcpy(addr.sun_path, switch_local);
+
+    switch_sock = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (switch_sock < 0) {
+        Log_Printf(LOG_WARN, "[SWITCH] Cannot create socket: %s", strerror(errno));
+        return;
+    }
+    unlink(switch_local);
+    if (bind(switch_sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        Log_Printf(LOG_WARN, "[SWITCH] Cannot bind to %s: %s", switch_local, strerror(errno));
+        close(switch_sock);
+        switch_sock = -1;
+        return;
+    }
+
+    /* Connect to the hub and announce ourself with an empty frame */
+    strcpy(addr.sun_path, ConfigureParams.Ethernet.szSwitchPath);  /* shorter than switch_local */
+    if (connect(switch_sock, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        send(switch_sock, tx_ring[0], 0, MSG_DONTWAIT) < 0) {
+        Log_Printf(LOG_WARN, "[SWITCH] Cannot connect to hub at %s: %s",
+                   ConfigureParams.Ethernet.szSwitchPath, strerror(errno));
+        close(switch_sock);
+        unlink(switch_local);
+        switch_sock = -1;
+    }
+}
+
+#else /* !HAVE_UNIX_DOMAIN_SOCKETS */
+
+void enet_switch_queue_poll(void) {}
+void enet_switch_input(Uint8 *pkt, int pkt_len) {}
+void enet_switch_stop(void) {}
+void enet_switch_start(void) {
+    Log_Printf(LOG_WARN, "[SWITCH] Virtual switch is not supported on this host");
+}
+
+#endif /* HAVE_UNIX_DOMAIN_SOCKETS */
@@ -16,8 +16,10 @@
 #include "bmap.h"
 #include "ethernet.h"
 #include "enet_slirp.h"
+#include "enet_switch.h"
 #include "cycInt.h"
 #include "statusbar.h"
+#include "replay.h"
 
 
 #define LOG_EN_LEVEL        LOG_DEBUG
@@ -369,7 +371,60 @@ static bool enet_packet_for_me(Uint8 *packet) {
     }
 }
 
+/* Host network backends, indexed by ENETINTERFACE */
+static const enet_backend_t enet_backends[] = {
+    { enet_slirp_start,  enet_slirp_stop,  enet_slirp_input,  enet_slirp_queue_poll },
+    { enet_switch_start, enet_switch_stop, enet_switch_input, enet_switch_queue_poll }
+};
+
+static const enet_backend_t* enet_host = NULL;
+static bool enet_host_polling = false;    /* frames come from the host backend */
+
+static void enet_host_start(void) {
+    int i = ConfigureParams.Ethernet.nHostInterface;
+    if (i < 0 || i >= ARRAYSIZE(enet_backends)) {
+        i = ENET_SLIRP;
+    }
+    if (enet_host && enet_host != &enet_backends[i]) {
+        enet_host->stop();
+    }
+    enet_host = &enet_backends[i];
+    enet_host->start();
+}
+
+static void enet_host_stop(void) {
+    if (enet_host) {
+        enet_host->stop();
+    }
+}
+
+static void enet_host_input(Uint8 *pkt, int len) {
+    /* During replay the host side of the network is the recording */
+    if (enet_host && replay_mode != REPLAY_PLAY) {
+        enet_host->input(pkt, len);
+    }
+}
+
+static void enet_host_queue_poll(void) {
+    Uint8 pkt[2048];
+    int len;
+    
+    if (replay_mode == REPLAY_PLAY) {
+        len = Replay_Fetch(REPLAY_ENET, pkt, sizeof(pkt));
+        if (len > 0) {
+            enet_receive(pkt, len);
+        }
+    } else if (enet_host) {
+        enet_host_polling = true;
+        enet_host->queue_poll();
+        enet_host_polling = false;
+    }
+}
+
 void enet_receive(Uint8 *pkt, int len) {
+    if (enet_host_polling) {
+        Replay_Record(REPLAY_ENET, pkt, len);
+    }
     if (enet_packet_for_me(pkt)) {
 #if 1   /* Hack for short packets from SLIRP */
         if (len<60) {
@@ -478,7 +533,7 @@ static void enet_io(void) {
 					receiver_state = RECV_STATE_RECEIVING;
 			} else if (en_state == EN_THINWIRE || en_state == EN_TWISTEDPAIR) {
 				/* Receive from real world network */
-				enet_slirp_queue_poll();
+				enet_host_queue_poll();
 				break;
 			} else
 				break;
@@ -551,7 +606,7 @@ static void enet_io(void) {
 						enet_receive(enet_tx_buffer.data, enet_tx_buffer.size);
 					} else {
 						/* Send to real world network */
-						enet_slirp_input(enet_tx_buffer.data,enet_tx_buffer.size);
+						enet_host_input(enet_tx_buffer.data,enet_tx_buffer.size);
 						/* Simultaneously receive packet on thin ethernet */
 						if (en_state == EN_THINWIRE) {
 							enet_receive(enet_tx_buffer.data, enet_tx_buffer.size);
@@ -632,7 +687,7 @@ static void new_enet_io(void) {
 					receiver_state = RECV_STATE_RECEIVING;
 			} else if (en_state == EN_THINWIRE || en_state == EN_TWISTEDPAIR) {
 				/* Receive from real world network */
-				enet_slirp_queue_poll();
+				enet_host_queue_poll();
 				break;
 			} else
 				break;
@@ -691,7 +746,7 @@ static void new_enet_io(void) {
 						enet_receive(enet_tx_buffer.data, enet_tx_buffer.size);
 					} else {
 						/* Send to real world network */
-						enet_slirp_input(enet_tx_buffer.data,enet_tx_buffer.size);
+						enet_host_input(enet_tx_buffer.data,enet_tx_buffer.size);
 						/* Simultaneously receive packet on thin ethernet */
 						if (en_state == EN_THINWIRE) {
 							enet_receive(enet_tx_buffer.data, enet_tx_buffer.size);
@@ -718,9 +773,9 @@ void ENET_IO_Handler(void) {
 	if (enet.reset&EN_RESET) {
 		Log_Printf(LOG_WARN, "Stopping Ethernet Transmitter/Receiver");
 		enet_stopped=true;
-		/* Stop SLIRP */
+		/* Stop host network */
 		if (ConfigureParams.Ethernet.bEthernetConnected) {
-			enet_slirp_stop();
+			enet_host_stop();
 		}
 		return;
 	}
@@ -741,9 +796,9 @@ void enet_reset(void) {
         Log_Printf(LOG_WARN, "Starting Ethernet Transmitter/Receiver");
         enet_stopped=false;
         CycInt_AddRelativeInterruptUs(ENET_IO_DELAY, 0, INTERRUPT_ENET_IO);
-        /* Start SLIRP */
+        /* Start host network */
         if (ConfigureParams.Ethernet.bEthernetConnected) {
-            enet_slirp_start();
+            enet_host_start();
         }
     }
 }
@@ -755,15 +810,15 @@ void Ethernet_Reset(bool hard) {
         enet_rx_buffer.size=enet_tx_buffer.size=0;
         enet_rx_buffer.limit=enet_tx_buffer.limit=64*1024;
         enet.tx_status=ConfigureParams.System.bTurbo?0:TXSTAT_READY;
-        /* Stop SLIRP */
-        enet_slirp_stop();
+        /* Stop host network */
+        enet_host_stop();
     } else {
         if (ConfigureParams.Ethernet.bEthernetConnected && !(enet.reset&EN_RESET)) {
-            /* Start SLIRP */
-            enet_slirp_start();
+            /* Start host network */
+            enet_host_start();
         } else {
-            /* Stop SLIRP */
-            enet_slirp_stop();
+            /* Stop host network */
+            enet_host_stop();
         }
     }
 }
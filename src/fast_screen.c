@@ -23,6 +23,7 @@ const char Screen_fileid[] = "Previous fast_screen.c : " __DATE__ " " __TIME__;
 #include "control.h"
 #include "statusbar.h"
 #include "video.h"
+#include "avi_record.h"
 
 SDL_Window*   sdlWindow;
 SDL_Surface*  sdlscrn = NULL;   /* The SDL screen surface */
@@ -73,12 +74,8 @@ static Uint32 col2rgb(SDL_PixelFormat* format, int col) {
 /*
  BW format is 2bit per pixel
  */
-static void blitBW(SDL_Texture* tex) {
-    void* pixels;
-    int   d;
+static void blitBW(Uint32* dst) {
     int   pitch = (NeXT_SCRN_WIDTH + (ConfigureParams.System.bTurbo ? 0 : 32)) / 4;
-    SDL_LockTexture(tex, NULL, &pixels, &d);
-    Uint32* dst = (Uint32*)pixels;
     for(int y = 0; y < NeXT_SCRN_HEIGHT; y++) {
         int src     = y * pitch;
         for(int x = 0; x < NeXT_SCRN_WIDTH/4; x++, src++) {
@@ -89,42 +86,34 @@ static void blitBW(SDL_Texture* tex) {
             *dst++  = BW2RGB[idx+3];
         }
     }
-    SDL_UnlockTexture(tex);
 }
 
 /*
  Color format is 4bit per pixel, big-endian: RGBx
  */
-static void blitColor(SDL_Texture* tex) {
-    void* pixels;
-    int   d;
+static void blitColor(Uint32* dst) {
     int pitch = NeXT_SCRN_WIDTH + (ConfigureParams.System.bTurbo ? 0 : 32);
-    SDL_LockTexture(tex, NULL, &pixels, &d);
-    Uint32* dst = (Uint32*)pixels;
     for(int y = 0; y < NeXT_SCRN_HEIGHT; y++) {
         Uint16* src = (Uint16*)NEXTColorVideo + (y*pitch);
         for(int x = 0; x < NeXT_SCRN_WIDTH; x++) {
             *dst++ = COL2RGB[*src++];
         }
     }
-    SDL_UnlockTexture(tex);
 }
 
 /*
  Dimension format is 8bit per pixel, big-endian: RRGGBBAA
  */
-void blitDimension(SDL_Texture* tex) {
+static void blitDimensionPixels(const Uint8* vram, Uint32* dst, Uint32 format) {
+    /* board memory is allocated on cold reset, after the repainters start */
+    if (vram == NULL) {
+        return;
+    }
 #if ND_STEP
-    Uint32* src = (Uint32*)&ND_vram[0];
+    const Uint32* src = (const Uint32*)&vram[0];
 #else
-    Uint32* src = (Uint32*)&ND_vram[16];
+    const Uint32* src = (const Uint32*)&vram[16];
 #endif
-    void*   pixels;
-    int     d;
-    Uint32  format;
-    SDL_QueryTexture(tex, &format, &d, &d, &d);
-    SDL_LockTexture(tex, NULL, &pixels, &d);
-    Uint32* dst = (Uint32*)pixels;
     if(SDL_BYTEORDER == SDL_BIG_ENDIAN) {
         /* Add big-endian accelerated blit loops as needed here */
         switch (format) {
@@ -171,22 +160,39 @@ void blitDimension(SDL_Texture* tex) {
             }
         }
     }
+}
+
+void blitDimension(const Uint8* vram, SDL_Texture* tex) {
+    void*   pixels;
+    int     d;
+    Uint32  format;
+    SDL_QueryTexture(tex, &format, &d, &d, &d);
+    SDL_LockTexture(tex, NULL, &pixels, &d);
+    blitDimensionPixels(vram, (Uint32*)pixels, format);
     SDL_UnlockTexture(tex);
 }
 
 /*
- Blit NeXT framebuffer to texture.
+ Blit NeXT framebuffer to texture and hand it to the AVI recorder.
  */
 static void blitScreen(SDL_Texture* tex) {
+    void*   pixels;
+    int     pitch;
+    int     d;
+    Uint32  format;
+    SDL_QueryTexture(tex, &format, &d, &d, &d);
+    SDL_LockTexture(tex, NULL, &pixels, &pitch);
     if (ConfigureParams.Screen.nMonitorType==MONITOR_TYPE_DIMENSION) {
-        blitDimension(tex);
-        return;
-    }
-    if(ConfigureParams.System.bColor) {
-        blitColor(tex);
+        blitDimensionPixels(nd_boards[0].vram, (Uint32*)pixels, format);
+    } else if(ConfigureParams.System.bColor) {
+        blitColor((Uint32*)pixels);
     } else {
-        blitBW(tex);
+        blitBW((Uint32*)pixels);
+    }
+    if (bRecordingAvi) {
+        Avi_CaptureFrame(pixels, NeXT_SCRN_WIDTH, NeXT_SCRN_HEIGHT, pitch, format);
     }
+    SDL_UnlockTexture(tex);
 }
 
 /*
@@ -445,6 +451,14 @@ void Screen_ReturnFromFullScreen(void) {
 /**
  * Force things associated with changing between fullscreen/windowed
  */
+/*
+ Size of the emulated screen (main display or NeXTdimension) as blitted.
+ */
+void Screen_GetFrameSize(int *width, int *height) {
+    *width  = NeXT_SCRN_WIDTH;
+    *height = NeXT_SCRN_HEIGHT;
+}
+
 void Screen_ModeChanged(void) {
 	if (!sdlscrn) {
 		/* screen not yet initialized */
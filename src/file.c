@@ -24,6 +24,7 @@ const char File_fileid[] = "Hatari file.c : " __DATE__ " " __TIME__;
 #include "main.h"
 #include "dialog.h"
 #include "file.h"
+#include "cimage.h"
 #include "createBlankImage.h"
 #include "str.h"
 #include "zip.h"
@@ -289,10 +290,17 @@ off_t File_Length(const char *pszFileName)
 {
 	FILE *hDiskFile;
 	off_t FileSize;
+	Uint64 ImageSize;
 
 	hDiskFile = fopen(pszFileName, "rb");
 	if (hDiskFile!=NULL)
 	{
+		/* Compressed images report their uncompressed size */
+		if (CImage_Probe(hDiskFile, &ImageSize))
+		{
+			fclose(hDiskFile);
+			return ImageSize;
+		}
 		fseek(hDiskFile, 0, SEEK_END);
 		FileSize = ftello(hDiskFile);
 		fseek(hDiskFile, 0, SEEK_SET);
@@ -556,6 +564,20 @@ FILE *File_Open(const char *path, const char *mode)
         fprintf(stderr, "Can't open file '%s' (wr=%i, rd=%i):\n  %s\n",
                 path, wr, rd, strerror(errno));
     
+    /* Attach compressed disk images for File_Read and File_Write */
+    if (fp && rd && !wr)
+    {
+        if (CImage_Probe(fp, NULL))
+        {
+            if (!CImage_Attach(fp, strchr(mode, '+') != NULL))
+            {
+                fclose(fp);
+                return NULL;
+            }
+        }
+        rewind(fp);
+    }
+    
     /* printf("'%s' opened in mode '%s'\n", path, mode, fp); */
 	return fp;
 }
@@ -570,6 +592,7 @@ FILE *File_Close(FILE *fp)
 {
 	if (fp && fp != stdin && fp != stdout && fp != stderr)
 	{
+		CImage_Detach(fp);
 		fclose(fp);
 	}
 	return NULL;
@@ -582,6 +605,10 @@ FILE *File_Close(FILE *fp)
  */
 bool File_Read(Uint8 *data, Uint32 size, Uint64 offset, FILE *fp)
 {
+    cimage_t *img = CImage_Find(fp);
+    if (img)
+        return CImage_Read(img, data, size, offset);
+    
     if (fseek(fp, offset, SEEK_SET))
     {
         fprintf(stderr, "File seek failed:\n  %s\n", strerror(errno));
@@ -602,6 +629,10 @@ bool File_Read(Uint8 *data, Uint32 size, Uint64 offset, FILE *fp)
  */
 bool File_Write(Uint8 *data, Uint32 size, Uint64 offset, FILE *fp)
 {
+    cimage_t *img = CImage_Find(fp);
+    if (img)
+        return CImage_Write(img, data, size, offset);
+    
     if (fseek(fp, offset, SEEK_SET))
     {
         fprintf(stderr, "File seek failed:\n  %s\n", strerror(errno));
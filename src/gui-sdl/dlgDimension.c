@@ -18,17 +18,20 @@ const char DlgDimension_fileid[] = "Previous dlgDimension.c : " __DATE__ " " __T
 #define DLGND_ENABLE        4
 #define DLGND_CUSTOMIZE     5
 #define DLGND_I860THREAD    6
-#define DLGND_MEMSIZE       13
-#define DLGND_BROWSE        18
-#define DLGND_NAME          19
-#define DLGND_COLOR         22
-#define DLGND_MONOCHROME    23
-#define DLGND_BOTH          24
-#define DLGND_DISPLAY		25
-#define DLGND_EXIT          27
+#define DLGND_I860HOSTFPU   7
+#define DLGND_MEMSIZE       14
+#define DLGND_BOARDS        18
+#define DLGND_BROWSE        21
+#define DLGND_NAME          22
+#define DLGND_COLOR         25
+#define DLGND_MONOCHROME    26
+#define DLGND_BOTH          27
+#define DLGND_DISPLAY		28
+#define DLGND_EXIT          30
 
 /* Variable strings */
 char dimension_memory[16] = "64 MB";
+char dimension_boards[16] = "2";
 
 /* Additional functions */
 void print_nd_overview(void);
@@ -45,6 +48,7 @@ static SGOBJ dimensiondlg[] =
     { SGCHECKBOX, 0, 0, 4,  6, 9,  1, "Enabled" },
     { SGBUTTON,   0, 0, 15, 6, 11, 1, "Customize" },
     { SGCHECKBOX, 0, 0, 6,  8, 21,  1, "Run separate thread" },
+    { SGCHECKBOX, 0, 0, 6,  9, 19,  1, "Use host FPU" },
 	
     { SGTEXT, 0, 0, 30,4, 13,1, "System overview:" },
     { SGTEXT, 0, 0, 30,6, 13,1, "CPU type:" },
@@ -55,6 +59,8 @@ static SGOBJ dimensiondlg[] =
     { SGTEXT, 0, 0, 44,8, 13,1, dimension_memory },
     { SGTEXT, 0, 0, 30,9, 13,1, "NBIC:" },
     { SGTEXT, 0, 0, 44,9, 13,1, "present" },
+    { SGTEXT, 0, 0, 30,10, 13,1, "Slots:" },
+    { SGBUTTON, 0, 0, 44,10, 9,1, dimension_boards },
 
     { SGBOX, 0, 0, 2,12, 54,5, NULL },
     { SGTEXT, 0, 0, 3,13, 22,1, "ROM for NeXTdimension:" },
@@ -82,6 +88,11 @@ void Dialog_NDMemDlg(int *membank);
 /* Function to print system overview */
 void print_nd_overview(void) {
     sprintf(dimension_memory, "%i MB", Configuration_CheckDimensionMemory(ConfigureParams.Dimension.nMemoryBankSize));
+    switch (ConfigureParams.Dimension.nNumBoards) {
+        case 3:  sprintf(dimension_boards, "2, 4, 6"); break;
+        case 2:  sprintf(dimension_boards, "2, 4");    break;
+        default: sprintf(dimension_boards, "2");       break;
+    }
     
     update_monitor_selection();
 }
@@ -120,6 +131,9 @@ void Dialog_DimensionDlg(void)
     if (ConfigureParams.Dimension.bI860Thread) dimensiondlg[DLGND_I860THREAD].state |= SG_SELECTED;
     else                                       dimensiondlg[DLGND_I860THREAD].state &= ~SG_SELECTED;
 
+    if (ConfigureParams.Dimension.bI860HostFPU) dimensiondlg[DLGND_I860HOSTFPU].state |= SG_SELECTED;
+    else                                        dimensiondlg[DLGND_I860HOSTFPU].state &= ~SG_SELECTED;
+
     dimensiondlg[DLGND_COLOR].state      &= ~SG_SELECTED;
     dimensiondlg[DLGND_MONOCHROME].state &= ~SG_SELECTED;
     dimensiondlg[DLGND_BOTH].state       &= ~SG_SELECTED;
@@ -167,6 +181,11 @@ void Dialog_DimensionDlg(void)
                 print_nd_overview();
                 break;
                 
+            case DLGND_BOARDS:
+                ConfigureParams.Dimension.nNumBoards = ConfigureParams.Dimension.nNumBoards % 3 + 1;
+                print_nd_overview();
+                break;
+                
             default:
                 break;
         }
@@ -177,6 +196,7 @@ void Dialog_DimensionDlg(void)
     /* Read values from dialog */
     ConfigureParams.Dimension.bEnabled     = (dimensiondlg[DLGND_ENABLE].    state&SG_SELECTED) != 0;
     ConfigureParams.Dimension.bI860Thread  = (dimensiondlg[DLGND_I860THREAD].state&SG_SELECTED) != 0;
+    ConfigureParams.Dimension.bI860HostFPU = (dimensiondlg[DLGND_I860HOSTFPU].state&SG_SELECTED) != 0;
 	ConfigureParams.Dimension.bMainDisplay = (dimensiondlg[DLGND_DISPLAY].state&SG_SELECTED) != 0;
 	
     if (ConfigureParams.Dimension.bEnabled)
@@ -15,15 +15,16 @@ const char DlgPrinter_fileid[] = "Previous dlgPrinter.c : " __DATE__ " " __TIME_
 
 
 #define DLGPRINT_CONNECTED  3
-#define DLGPRINT_A4         6
-#define DLGPRINT_LETTER     7
-#define DLGPRINT_B5         8
-#define DLGPRINT_LEGAL      9
+#define DLGPRINT_FAST       4
+#define DLGPRINT_A4         7
+#define DLGPRINT_LETTER     8
+#define DLGPRINT_B5         9
+#define DLGPRINT_LEGAL      10
 
-#define DLGPRINT_BROWSE     12
-#define DLGPRINT_DIRECTORY  13
+#define DLGPRINT_BROWSE     13
+#define DLGPRINT_DIRECTORY  14
 
-#define DLGPRINT_EXIT       14
+#define DLGPRINT_EXIT       15
 
 char dlgprint_dirname[64];
 
@@ -35,6 +36,7 @@ static SGOBJ printerdlg[] =
 
     { SGBOX, 0, 0, 1,4, 22,8, NULL },
     { SGCHECKBOX, 0, 0, 2,5, 19,1, "Printer connected" },
+    { SGCHECKBOX, 0, 0, 2,7, 15,1, "Fast printing" },
     
     { SGBOX, 0, 0, 24,4, 22,8, NULL },
 	{ SGTEXT, 0, 0, 25,5, 30,1, "Paper size:" },
@@ -70,6 +72,11 @@ void DlgPrinter_Main(void)
     else
         printerdlg[DLGPRINT_CONNECTED].state &= ~SG_SELECTED;
     
+    if (ConfigureParams.Printer.bFastPrint)
+        printerdlg[DLGPRINT_FAST].state |= SG_SELECTED;
+    else
+        printerdlg[DLGPRINT_FAST].state &= ~SG_SELECTED;
+    
     printerdlg[DLGPRINT_A4].state &= ~SG_SELECTED;
     printerdlg[DLGPRINT_LETTER].state &= ~SG_SELECTED;
     printerdlg[DLGPRINT_B5].state &= ~SG_SELECTED;
@@ -116,6 +123,7 @@ void DlgPrinter_Main(void)
     
     /* Read values from dialog */
     ConfigureParams.Printer.bPrinterConnected = printerdlg[DLGPRINT_CONNECTED].state & SG_SELECTED;
+    ConfigureParams.Printer.bFastPrint = printerdlg[DLGPRINT_FAST].state & SG_SELECTED;
     
     if (printerdlg[DLGPRINT_A4].state & SG_SELECTED)
         ConfigureParams.Printer.nPaperSize = PAPER_A4;
@@ -8,14 +8,18 @@
 #endif
 #endif
 #include <errno.h>
+#if HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 #include "host.h"
 #include "configuration.h"
 #include "main.h"
+#include "replay.h"
 
 /* NeXTdimension blank handling, see nd_sdl.c */
-void nd_display_blank(void);
-void nd_video_blank(void);
+void nd_display_blank(int slot);
+void nd_video_blank(int slot);
 
 #define NUM_BLANKS 3
 static const char* BLANKS[] = {
@@ -47,7 +51,7 @@ void host_reset() {
     pauseTimeStamp    = perfCounterStart;
     perfFrequency     = SDL_GetPerformanceFrequency();
     ticksStart        = SDL_GetTicks();
-    unixTimeStart     = time(NULL);
+    unixTimeStart     = Replay_Reset(time(NULL));
     cycleCounterStart = 0;
     cycleSecsStart    = 0;
     isRealtime        = false;
@@ -69,16 +73,17 @@ void host_reset() {
 }
 
 void host_blank(int slot, int src, bool state) {
-    slot = 1 << slot;
+    Uint32 bit = 1 << slot;
     if(state) {
-        blank[src] |=  slot;
-        vblCounter[src]++;
+        if (!blank[src])
+            vblCounter[src]++; /* count once for all boards */
+        blank[src] |=  bit;
     }
     else
-        blank[src] &= ~slot;
+        blank[src] &= ~bit;
     switch (src) {
-        case ND_DISPLAY:   nd_display_blank(); break;
-        case ND_VIDEO:     nd_video_blank();   break;
+        case ND_DISPLAY:   nd_display_blank(slot); break;
+        case ND_VIDEO:     nd_video_blank(slot);   break;
     }
 }
 
@@ -239,6 +244,49 @@ int host_thread_wait(thread_t* thread) {
   return status;
 }
                 
+/*-----------------------------------------------------------------------*/
+/**
+ * Allocate zeroed guest memory. Pages are only committed when touched.
+ */
+void* host_mem_alloc(size_t size) {
+#if HAVE_MMAP
+    void* mem = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        fprintf(stderr, "[Host] Cannot map %"FMT_zu" bytes of guest memory: %s\n", size, strerror(errno));
+        return NULL;
+    }
+#if HAVE_MADVISE && defined(MADV_HUGEPAGE)
+    if (ConfigureParams.Memory.bHugePages)
+        madvise(mem, size, MADV_HUGEPAGE);
+#endif
+#if HAVE_MADVISE && defined(MADV_MERGEABLE)
+    if (ConfigureParams.Memory.bMergePages)
+        madvise(mem, size, MADV_MERGEABLE);
+#endif
+    return mem;
+#else
+    return calloc(1, size);
+#endif
+}
+
+void host_mem_free(void* mem, size_t size) {
+    if (mem == NULL) return;
+#if HAVE_MMAP
+    munmap(mem, size);
+#else
+    free(mem);
+#endif
+}
+
+/* Zero guest memory and give committed pages back to the host */
+void host_mem_clear(void* mem, size_t size) {
+#if HAVE_MADVISE && defined(MADV_DONTNEED)
+    if (madvise(mem, size, MADV_DONTNEED) == 0)
+        return;
+#endif
+    memset(mem, 0, size);
+}
+
 int host_num_cpus() {
   return  SDL_GetCPUCount();
 }
@@ -0,0 +1,30 @@
+/*
+  Hatari - avi_record.h
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+*/
+
+#ifndef HATARI_AVI_RECORD_H
+#define HATARI_AVI_RECORD_H
+
+#define	AVI_RECORD_VIDEO_CODEC_BMP	1
+#define	AVI_RECORD_VIDEO_CODEC_PNG	2
+
+#define	AVI_RECORD_AUDIO_CODEC_PCM	1
+
+#define	AVI_RECORD_FPS			60
+
+extern bool	bRecordingAvi;
+
+void		Avi_CaptureFrame ( const void *pPixels , int Width , int Height , int Pitch , Uint32 Format );
+void		Avi_CaptureAudio ( const Uint8 *pSamples , int Len );
+bool		Avi_AreWeRecording ( void );
+const char*	Avi_Report ( double realTime , double hostTime );
+bool		Avi_StartRecording ( const char *FileName , int Width , int Height , int Fps , int VideoCodec );
+bool		Avi_StopRecording ( void );
+
+void		Avi_Init ( void );
+void		Avi_UnInit ( void );
+
+#endif /* HATARI_AVI_RECORD_H */
@@ -0,0 +1,25 @@
+/*
+  Previous - bench.h
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+*/
+
+#ifndef PREV_BENCH_H
+#define PREV_BENCH_H
+
+bool        Bench_Active(void);
+const char *Bench_SetOutput(const char *path);
+const char *Bench_SetStop(const char *marker);
+const char *Bench_SetTimeout(const char *seconds);
+void        Bench_Reset(void);
+void        Bench_VBL(void);
+void        Bench_Finish(const char *reason);
+
+#if ENABLE_TESTING
+bool        Bench_Test(const char *name);
+void        Bench_ListTests(FILE *fp);
+char       *Bench_MatchTest(const char *text, int state);
+#endif
+
+#endif /* PREV_BENCH_H */
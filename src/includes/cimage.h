@@ -0,0 +1,29 @@
+/*
+  Previous - cimage.h
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+*/
+
+#ifndef PREV_CIMAGE_H
+#define PREV_CIMAGE_H
+
+#include <stdio.h>
+
+#define CIMAGE_CHUNK_SHIFT  16      /* default chunk size is 64 kB */
+#define CIMAGE_CACHE_CHUNKS 64      /* decompressed chunks cached per image */
+
+typedef struct cimage_s cimage_t;
+
+bool      CImage_Probe(FILE *fp, Uint64 *size);
+cimage_t *CImage_Attach(FILE *fp, bool writable);
+cimage_t *CImage_Find(FILE *fp);
+void      CImage_Detach(FILE *fp);
+bool      CImage_Read(cimage_t *img, Uint8 *data, Uint32 size, Uint64 offset);
+bool      CImage_Write(cimage_t *img, Uint8 *data, Uint32 size, Uint64 offset);
+bool      CImage_Flush(cimage_t *img);
+
+bool      CImage_Compress(const char *src, const char *dst, int chunkshift);
+bool      CImage_Decompress(const char *src, const char *dst);
+
+#endif /* PREV_CIMAGE_H */
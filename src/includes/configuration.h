@@ -123,6 +123,8 @@ typedef struct
 {
   int nMemoryBankSize[4];
   MEMORY_SPEED nMemorySpeed;
+  bool bHugePages;     /* Back guest memory with transparent huge pages */
+  bool bMergePages;    /* Allow host to merge identical guest memory pages */
 } CNF_MEMORY;
 
 
@@ -209,11 +211,37 @@ typedef struct {
 
 
 /* Ethernet configuration */
+typedef enum
+{
+  ENET_SLIRP,
+  ENET_SWITCH
+} ENETINTERFACE;
+
 typedef struct {
     bool bEthernetConnected;
     bool bTwistedPair;
+    ENETINTERFACE nHostInterface;
+    char szSwitchPath[FILENAME_MAX];    /* hub socket for ENET_SWITCH */
 } CNF_ENET;
 
+
+/* Serial port configuration */
+typedef enum
+{
+  SERIAL_NONE,
+  SERIAL_PTY,
+  SERIAL_SOCKET
+} SERIALBACKEND;
+
+typedef struct {
+    SERIALBACKEND nBackend;
+    char szPath[FILENAME_MAX];  /* pty symlink or listening socket */
+} SERIALPORT;
+
+typedef struct {
+    SERIALPORT port[2];         /* SCC channel A and B */
+} CNF_SERIAL;
+
 typedef enum
 {
   MONITOR_TYPE_DUAL,
@@ -228,6 +256,8 @@ typedef struct
   bool bFullScreen;
   bool bShowStatusbar;
   bool bShowDriveLed;
+  bool bAviRecord;
+  char szAviRecordFile[FILENAME_MAX];
 } CNF_SCREEN;
 
 
@@ -243,6 +273,7 @@ typedef enum
 typedef struct
 {
   bool bPrinterConnected;
+  bool bFastPrint;
   PAPER_SIZE nPaperSize;
   char szPrintToFileName[FILENAME_MAX];
 } CNF_PRINTER;
@@ -299,13 +330,16 @@ typedef struct
   bool bRealTimeClock;
   FPUTYPE n_FPUType;
   bool bCompatibleFPU;            /* More compatible FPU */
+  bool bFPUHostMath;              /* Host math for FPU transcendentals */
   bool bMMU;                      /* TRUE if MMU is enabled */
 } CNF_SYSTEM;
 
 typedef struct
 {
     bool bEnabled;
+    int  nNumBoards;
     bool bI860Thread;
+    bool bI860HostFPU;
 	bool bMainDisplay;
     int  nMemoryBankSize[4];
     char szRomFileName[FILENAME_MAX];
@@ -330,6 +364,7 @@ typedef struct
   CNF_MO        MO;
   CNF_FLOPPY    Floppy;
   CNF_ENET      Ethernet;
+  CNF_SERIAL    Serial;
   CNF_ROM       Rom;
   CNF_PRINTER   Printer;
   CNF_SYSTEM    System;
@@ -347,6 +382,7 @@ int Configuration_CheckMemory(int *banksize);
 int  Configuration_CheckDimensionMemory(int *banksize);
 void Configuration_CheckDimensionSettings(void);
 void Configuration_CheckEthernetSettings();
+void Configuration_CheckSerialSettings(void);
 void Configuration_Load(const char *psFileName);
 void Configuration_Save(void);
 void Configuration_MemorySnapShot_Capture(bool bSave);
@@ -31,6 +31,7 @@ typedef enum
   INTERRUPT_EVENT_LOOP,
   INTERRUPT_ND_VBL,
   INTERRUPT_ND_VIDEO_VBL,
+  INTERRUPT_SCC_IO,
   MAX_INTERRUPTS
 } interrupt_id;
 
@@ -66,5 +67,7 @@ void CycInt_AddRelativeInterruptUsCycles(int64_t us, int64_t usreal, interrupt_i
 void CycInt_RemovePendingInterrupt(interrupt_id Handler);
 bool CycInt_InterruptActive(interrupt_id Handler);
 bool CycInt_SetNewInterruptUs(void);
+const char *CycInt_Name(interrupt_id Handler);
+uint64_t CycInt_Count(interrupt_id Handler);
 
 #endif /* ifndef HATARI_CYCINT_H */
@@ -16,6 +16,7 @@ enum {
 /* DMA Registers */
 void DMA_CSR_Read(void);
 void DMA_CSR_Write(void);
+Uint32 DMA_CSR_ReadLong(Uint32 addr);
 
 void DMA_Saved_Next_Read(void);
 void DMA_Saved_Next_Write(void);
@@ -28,12 +29,20 @@ void DMA_Saved_Stop_Write(void);
 
 void DMA_Next_Read(void);
 void DMA_Next_Write(void);
+Uint32 DMA_Next_ReadLong(Uint32 addr);
+void DMA_Next_WriteLong(Uint32 addr, Uint32 val);
 void DMA_Limit_Read(void);
 void DMA_Limit_Write(void);
+Uint32 DMA_Limit_ReadLong(Uint32 addr);
+void DMA_Limit_WriteLong(Uint32 addr, Uint32 val);
 void DMA_Start_Read(void);
 void DMA_Start_Write(void);
+Uint32 DMA_Start_ReadLong(Uint32 addr);
+void DMA_Start_WriteLong(Uint32 addr, Uint32 val);
 void DMA_Stop_Read(void);
 void DMA_Stop_Write(void);
+Uint32 DMA_Stop_ReadLong(Uint32 addr);
+void DMA_Stop_WriteLong(Uint32 addr, Uint32 val);
 
 void DMA_Init_Read(void);
 void DMA_Init_Write(void);
@@ -55,16 +64,17 @@ void dma_mo_read_memory(void);
 void dma_enet_write_memory(bool eop);
 bool dma_enet_read_memory(void);
 
-void dma_dsp_write_memory(Uint8 val);
-Uint8 dma_dsp_read_memory(void);
-bool dma_dsp_ready(void);
+int dma_dsp_write_memory(const Uint8 *buf, int len);
+int dma_dsp_read_memory(Uint8 *buf, int len);
+int dma_dsp_available(void);
 
 void dma_m2m(void);
 void dma_m2m_write_memory(void);
 
 void dma_scc_read_memory(void);
+void dma_scc_write_memory(void);
 
-Uint8* dma_sndout_read_memory(int* len);
+int    dma_sndout_read_memory(Uint8* buf, int size);
 void   dma_sndout_intr(void);
 int    dma_sndin_write_memory(void);
 
@@ -1,4 +1,5 @@
 void enet_slirp_queue_poll(void);
 void enet_slirp_input(Uint8 *pkt, int pkt_len);
 void enet_slirp_stop(void);
-void enet_slirp_start(void);
\ No newline at end of file
+void enet_slirp_start(void);
+void enet_slirp_bench(void);    /* ENABLE_TESTING builds only */
@@ -0,0 +1,4 @@
+void enet_switch_queue_poll(void);
+void enet_switch_input(Uint8 *pkt, int pkt_len);
+void enet_switch_stop(void);
+void enet_switch_start(void);
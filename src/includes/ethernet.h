@@ -39,6 +39,14 @@ struct {
     int limit;
 } enet_rx_buffer;
 
+/* Host network backends */
+typedef struct {
+    void (*start)(void);
+    void (*stop)(void);
+    void (*input)(Uint8 *pkt, int len); /* send frame from guest to network */
+    void (*queue_poll)(void);           /* pass next frame from network to enet_receive */
+} enet_backend_t;
+
 void ENET_IO_Handler(void);
 void Ethernet_Reset(bool hard);
 void enet_receive(Uint8 *pkt, int len);
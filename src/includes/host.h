@@ -60,6 +60,10 @@ extern "C" {
     int         host_trylock(lock_t* lock);
     thread_t*   host_thread_create(thread_func_t, void* data);
     int         host_thread_wait(thread_t* thread);
+    
+    void*       host_mem_alloc(size_t size);
+    void        host_mem_free(void* mem, size_t size);
+    void        host_mem_clear(void* mem, size_t size);
 
 #ifdef __cplusplus
 }
@@ -85,6 +85,7 @@ static inline void IoMem_WriteByte(Uint32 Address, Uint8 Var)
 
 void IoMem_Init(void);
 void IoMem_UnInit(void);
+void IoMem_Bench(void);     /* ENABLE_TESTING builds only */
 
 uae_u32 IoMem_bget(uaecptr addr);
 uae_u32 IoMem_wget(uaecptr addr);
@@ -17,7 +17,19 @@ typedef struct
     void (*WriteFunc)(void);  /* Write function */
 } INTERCEPT_ACCESS_FUNC;
 
+/* Native long word handlers for registers that are polled by the OS.
+ * They are called once for an aligned long word access instead of the
+ * byte handlers above, and take or return the value directly. */
+typedef struct
+{
+    const Uint32 Address;                       /* Long word aligned hardware address */
+    Uint32 (*ReadFunc)(Uint32 addr);            /* Read function, returns register value */
+    void (*WriteFunc)(Uint32 addr, Uint32 val); /* Write function */
+} INTERCEPT_LONG_ACCESS_FUNC;
+
 extern const INTERCEPT_ACCESS_FUNC IoMemTable_NEXT[];
 extern const INTERCEPT_ACCESS_FUNC IoMemTable_Turbo[];
+extern const INTERCEPT_LONG_ACCESS_FUNC IoMemTableLong_NEXT[];
+extern const INTERCEPT_LONG_ACCESS_FUNC IoMemTableLong_Turbo[];
 
 #endif
@@ -0,0 +1,41 @@
+/*
+  Previous - replay.h
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+*/
+
+#ifndef PREV_REPLAY_H
+#define PREV_REPLAY_H
+
+#include <time.h>
+
+typedef enum {
+	REPLAY_OFF,
+	REPLAY_RECORD,
+	REPLAY_PLAY
+} replay_mode_t;
+
+/* Nondeterministic inputs, see replay.c */
+typedef enum {
+	REPLAY_RESET,       /* emulator reset, payload is the host unix time */
+	REPLAY_SDL_EVENT,   /* keyboard or mouse event */
+	REPLAY_ENET,        /* Ethernet frame from the host backend */
+	REPLAY_SCC_A,       /* serial data from the host backend */
+	REPLAY_SCC_B,
+	REPLAY_SND_FULL,    /* host sound output queue was full */
+	REPLAY_END,         /* end of recording */
+	REPLAY_MOUSE_GRAB   /* mouse motion happened with the mouse grabbed */
+} replay_type_t;
+
+extern replay_mode_t replay_mode;
+
+const char *Replay_SetRecordFile(const char *path);
+const char *Replay_SetPlayFile(const char *path);
+void        Replay_UnInit(void);
+time_t      Replay_Reset(time_t now);
+void        Replay_Record(replay_type_t type, const void *data, int len);
+int         Replay_Fetch(replay_type_t type, void *data, int len);
+bool        Replay_Bool(replay_type_t type, bool value);
+
+#endif /* PREV_REPLAY_H */
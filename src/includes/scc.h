@@ -232,7 +232,10 @@ void SCC_DataB_Read(void);
 void SCC_DataB_Write(void);
 
 void SCC_Reset(Uint8 mode);
+void SCC_UnInit(void);
+void SCC_IO_Handler(void);
 
-
-/* SCC DMA buffer */
-Uint8 scc_buf[1];
+/* DMA interface */
+bool SCC_DMA_TxReady(void);
+void SCC_DMA_Transmit(Uint8 val);
+int  SCC_DMA_Receive(void);
@@ -0,0 +1,17 @@
+/*
+  Previous - scc_host.h
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+*/
+
+#ifndef PREV_SCC_HOST_H
+#define PREV_SCC_HOST_H
+
+bool scc_host_active(int ch);
+int  scc_host_read(int ch, Uint8 *buf, int len);
+int  scc_host_write(int ch, const Uint8 *buf, int len);
+void scc_host_stop(int ch);
+void scc_host_start(int ch);
+
+#endif /* PREV_SCC_HOST_H */
@@ -26,9 +26,10 @@ void Screen_Pause(bool pause);
 void Screen_EnterFullScreen(void);
 void Screen_ReturnFromFullScreen(void);
 void Screen_ModeChanged(void);
+void Screen_GetFrameSize(int *width, int *height);
 bool Update_StatusBar(void);
 void SDL_UpdateRects(SDL_Surface *screen, int numrects, SDL_Rect *rects);
 void SDL_UpdateRect(SDL_Surface *screen, Sint32 x, Sint32 y, Sint32 w, Sint32 h);
-void blitDimension(SDL_Texture* tex);
+void blitDimension(const Uint8* vram, SDL_Texture* tex);
 
 #endif  /* ifndef HATARI_SCREEN_H */
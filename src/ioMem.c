@@ -15,6 +15,9 @@ const char IoMem_fileid[] = "Hatari ioMem.c : " __DATE__ " " __TIME__;
 #include "m68000.h"
 #include "sysdeps.h"
 #include "shortcut.h"
+#if ENABLE_TESTING
+#include "host.h"
+#endif
 
 #define IO_SEG_MASK 0x0001FFFF
 #define IO_MASK 0x0001FFFF
@@ -22,6 +25,8 @@ const char IoMem_fileid[] = "Hatari ioMem.c : " __DATE__ " " __TIME__;
 
 static void (*pInterceptReadTable[IO_SIZE])(void);     /* Table with read access handlers */
 static void (*pInterceptWriteTable[IO_SIZE])(void);    /* Table with write access handlers */
+static Uint32 (*pLongReadTable[IO_SIZE/4])(Uint32);    /* Native long word read handlers or NULL */
+static void (*pLongWriteTable[IO_SIZE/4])(Uint32,Uint32); /* Native long word write handlers or NULL */
 
 int nIoMemAccessSize;                                 /* Set to 1, 2 or 4 according to byte, word or long word access */
 Uint32 IoAccessBaseAddress;                           /* Stores the base address of the IO mem access */
@@ -53,6 +58,64 @@ static void IoMem_SetBusErrorRegion(Uint32 startaddr, Uint32 endaddr)
 }
 
 
+#if ENABLE_TESTING
+/*-----------------------------------------------------------------------*/
+/**
+ * Time a register polling loop, like the ROM and the kernel use to wait
+ * for interrupts and DMA completion, through the native long word handlers
+ * and through the byte handlers, and check that both return the same values.
+ * Run with the debugger "bench iomem" command.
+ */
+void IoMem_Bench(void)
+{
+	static const Uint32 regs[] = { 0x02007000, 0x02007800, 0x02000010, 0x02004010 };
+	const int N = 1000000;
+	double mreads[2];
+	Uint32 val[2] = { 0, 0 };
+	int err = 0;
+	int i, r, native;
+
+	for (native = 1; native >= 0; native--)
+	{
+		Uint32 (*saved[4])(Uint32);
+		Uint64 t;
+
+		for (r = 0; r < 4; r++)
+		{
+			saved[r] = pLongReadTable[(regs[r] & IO_SEG_MASK)>>2];
+			if (!native)
+				pLongReadTable[(regs[r] & IO_SEG_MASK)>>2] = NULL;
+		}
+		t = host_time_us();
+		for (i = 0; i < N; i++)
+			val[native] ^= IoMem_lget(regs[i&3]);
+		t = host_time_us() - t;
+		mreads[native] = N / (double)(t ? t : 1);
+		for (r = 0; r < 4; r++)
+			pLongReadTable[(regs[r] & IO_SEG_MASK)>>2] = saved[r];
+	}
+	for (r = 0; r < 4; r++)
+	{
+		Uint32 (*fn)(Uint32) = pLongReadTable[(regs[r] & IO_SEG_MASK)>>2];
+		Uint32 v;
+
+		if (!fn)
+			continue;
+		v = IoMem_lget(regs[r]);
+		pLongReadTable[(regs[r] & IO_SEG_MASK)>>2] = NULL;
+		if (IoMem_lget(regs[r]) != v)
+			err++;
+		pLongReadTable[(regs[r] & IO_SEG_MASK)>>2] = fn;
+	}
+	if (val[0] != val[1])
+		err++;
+
+	fprintf(stderr, "IoMem: %d mismatches, polling %.1f Mreads/s byte handlers, %.1f Mreads/s native\n",
+	        err, mreads[0], mreads[1]);
+}
+#endif
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Create 'intercept' tables for hardware address access. Each 'intercept
@@ -62,14 +125,17 @@ void IoMem_Init(void)
 	Uint32 addr;
 	int i;
 	const INTERCEPT_ACCESS_FUNC *pInterceptAccessFuncs = NULL;
+	const INTERCEPT_LONG_ACCESS_FUNC *pLongAccessFuncs = NULL;
 
 	/* Set default IO access handler (-> bus error) */
 	IoMem_SetBusErrorRegion(0x02000000, 0x0201FFFF);
 
 	if (ConfigureParams.System.bTurbo) {
 		pInterceptAccessFuncs = IoMemTable_Turbo;
+		pLongAccessFuncs = IoMemTableLong_Turbo;
 	} else {
 		pInterceptAccessFuncs = IoMemTable_NEXT;
+		pLongAccessFuncs = IoMemTableLong_NEXT;
 	}
 
 	/* Now set the correct handlers */
@@ -94,7 +160,15 @@ void IoMem_Init(void)
 		}
 	}
 
-
+	/* Native long word handlers for aligned accesses to polled registers */
+	memset(pLongReadTable, 0, sizeof(pLongReadTable));
+	memset(pLongWriteTable, 0, sizeof(pLongWriteTable));
+	for (i=0; pLongAccessFuncs[i].Address != 0; i++)
+	{
+		addr = pLongAccessFuncs[i].Address & IO_SEG_MASK;
+		pLongReadTable[addr>>2] = pLongAccessFuncs[i].ReadFunc;
+		pLongWriteTable[addr>>2] = pLongAccessFuncs[i].WriteFunc;
+	}
 }
 
 
@@ -213,6 +287,13 @@ uae_u32 IoMem_lget(uaecptr addr)
 	idx = addr & IO_SEG_MASK;
 
 	IoAccessCurrentAddress = addr;
+	if (!(idx & 3) && pLongReadTable[idx>>2])
+	{
+		val = pLongReadTable[idx>>2](addr);   /* Call native handler */
+		LOG_TRACE(TRACE_IOMEM_RD, "IO read.l $%06x = $%08x\n", addr, val);
+		return val;
+	}
+
 	pInterceptReadTable[idx]();                   /* Call 1st handler */
 
 	if (pInterceptReadTable[idx+1] != pInterceptReadTable[idx])
@@ -348,6 +429,12 @@ void IoMem_lput(uaecptr addr, uae_u32 val)
 	idx = addr & IO_SEG_MASK;
 
 	IoAccessCurrentAddress = addr;
+	if (!(idx & 3) && pLongWriteTable[idx>>2])
+	{
+		pLongWriteTable[idx>>2](addr, val);   /* Call native handler */
+		return;
+	}
+
 	pInterceptWriteTable[idx]();                  /* Call handler */
 
 	if (pInterceptWriteTable[idx+1] != pInterceptWriteTable[idx])
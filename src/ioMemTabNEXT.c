@@ -318,3 +318,83 @@ const INTERCEPT_ACCESS_FUNC IoMemTable_NEXT[] =
 
 	{ 0, 0, NULL, NULL }
 };
+
+
+/*-----------------------------------------------------------------------*/
+/*
+ List of native long word handlers. These registers are polled in tight
+ loops, so aligned long word accesses bypass the byte handlers above.
+ Byte, word and unaligned accesses still use the table above.
+ */
+const INTERCEPT_LONG_ACCESS_FUNC IoMemTableLong_NEXT[] =
+{
+	/* DMA Controller CSRs */
+	{ 0x02000010, DMA_CSR_ReadLong, NULL },
+	{ 0x02000040, DMA_CSR_ReadLong, NULL },
+	{ 0x02000050, DMA_CSR_ReadLong, NULL },
+	{ 0x02000080, DMA_CSR_ReadLong, NULL },
+	{ 0x02000090, DMA_CSR_ReadLong, NULL },
+	{ 0x020000c0, DMA_CSR_ReadLong, NULL },
+	{ 0x020000d0, DMA_CSR_ReadLong, NULL },
+	{ 0x02000110, DMA_CSR_ReadLong, NULL },
+	{ 0x02000150, DMA_CSR_ReadLong, NULL },
+	{ 0x02000180, DMA_CSR_ReadLong, NULL },
+	{ 0x020001c0, DMA_CSR_ReadLong, NULL },
+	{ 0x020001d0, DMA_CSR_ReadLong, NULL },
+	
+	/* DMA Controller channel registers */
+	{ 0x02004010, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004014, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004018, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200401c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x02004040, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004044, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004048, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200404c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x02004050, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004054, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004058, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200405c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x02004080, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004084, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004088, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200408c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x02004090, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004094, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004098, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200409c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x020040c0, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x020040c4, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x020040c8, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x020040cc, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x020040d0, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x020040d4, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x020040d8, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x020040dc, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x02004110, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004114, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004118, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200411c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x02004150, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004154, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004158, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200415c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x02004180, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004184, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004188, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200418c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x020041c0, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x020041c4, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x020041c8, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x020041cc, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x020041d0, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x020041d4, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x020041d8, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x020041dc, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	
+	/* Interrupt Status and Mask Registers */
+	{ 0x02007000, IntRegStatReadLong, IntRegStatWriteLong },
+	{ 0x02007800, IntRegMaskReadLong, IntRegMaskWriteLong },
+
+	{ 0, NULL, NULL }
+};
@@ -231,3 +231,49 @@ const INTERCEPT_ACCESS_FUNC IoMemTable_Turbo[] =
 	
 	{ 0, 0, NULL, NULL }
 };
+
+
+/*-----------------------------------------------------------------------*/
+/*
+ List of native long word handlers. These registers are polled in tight
+ loops, so aligned long word accesses bypass the byte handlers above.
+ Byte, word and unaligned accesses still use the table above.
+ */
+const INTERCEPT_LONG_ACCESS_FUNC IoMemTableLong_Turbo[] =
+{
+	/* DMA Controller channel registers */
+	{ 0x02004010, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004014, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004018, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200401c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x02004040, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004044, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004048, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200404c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x02004080, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004084, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004088, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200408c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x02004090, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004094, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004098, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200409c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x020040d0, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x020040d4, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x020040d8, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x020040dc, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x02004110, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004114, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004118, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200411c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	{ 0x02004150, DMA_Next_ReadLong, DMA_Next_WriteLong },
+	{ 0x02004154, DMA_Limit_ReadLong, DMA_Limit_WriteLong },
+	{ 0x02004158, DMA_Start_ReadLong, DMA_Start_WriteLong },
+	{ 0x0200415c, DMA_Stop_ReadLong, DMA_Stop_WriteLong },
+	
+	/* Interrupt Status and Mask Registers */
+	{ 0x02007000, IntRegStatReadLong, IntRegStatWriteLong },
+	{ 0x02007800, IntRegMaskReadLong, IntRegMaskWriteLong },
+
+	{ 0, NULL, NULL }
+};
@@ -37,6 +37,8 @@ struct {
     Uint32 km_data;
 } kms;
 
+static void kms_mouse_reset(void);
+
 void KMS_Reset() {
     kms.status.snd_dma  = 0;
     kms.status.km       = 0;
@@ -44,6 +46,7 @@ void KMS_Reset() {
     kms.status.cmd      = 0;
     kms.data            = 0;
     kms.km_data         = 0;
+    kms_mouse_reset();
 }
 
 /* KMS control and status register (0x0200E000) 
@@ -401,20 +404,31 @@ void KMS_Data_Read(void) {
 
 bool m_button_right = false;
 bool m_button_left  = false;
-bool m_move_left    = false;
-bool m_move_up      = false;
-int  m_move_x       = 0;
-int  m_move_y       = 0;
-int  m_move_dx      = 0;
-int  m_move_dy      = 0;
-void kms_mouse_move_step(void);
+int  m_move_x       = 0;    /* motion not yet sent, positive is left */
+int  m_move_y       = 0;    /* positive is up */
+bool m_move_sent    = false;/* motion sent, but not yet read by the guest */
+
+static void kms_mouse_reset(void) {
+    m_move_x    = 0;
+    m_move_y    = 0;
+    m_move_sent = false;
+}
 
+#define MOUSE_STEP_FREQ 1000
 
 void KMS_KM_Data_Read(void) {
     IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, kms.km_data);
     
     kms.status.km &= ~(KBD_RECEIVED|KBD_INT);
     set_interrupt(INT_KEYMOUSE, RELEASE_INT);
+    
+    /* Send the rest of the motion once the guest has read the last step */
+    if (m_move_sent) {
+        m_move_sent = false;
+        if ((m_move_x || m_move_y) && !CycInt_InterruptActive(INTERRUPT_MOUSE)) {
+            CycInt_AddRelativeInterruptUs((1000*1000)/MOUSE_STEP_FREQ, 0, INTERRUPT_MOUSE);
+        }
+    }
 }
 
 static void kms_interrupt(void) {
@@ -499,49 +513,48 @@ void kms_mouse_button(bool left, bool down) {
     }
 }
 
-#define MOUSE_STEP_FREQ 1000
+/* Host motion is accumulated and sent as one step with the largest delta
+ * a mouse packet can hold. Further steps are only sent after the guest has
+ * read the previous one. */
+#define MOUSE_MAX_DELTA 63
 
 void kms_mouse_move(int x, bool left, int y, bool up) {
     if (x<0 || y<0) abort();
     
-    m_move_left = left;
-    m_move_up   = up;
-
-    int xsteps = x / 8; if(xsteps == 0) xsteps = 1;
-    int ysteps = y / 8; if(ysteps == 0) ysteps = 1;
-    
-    m_move_x  = x;
-    m_move_dx = x / xsteps;
+    m_move_x += left ? x : -x;
+    m_move_y += up ? y : -y;
     
-    m_move_y  = y;
-    m_move_dy = y / ysteps;
-    
-    CycInt_AddRelativeInterruptCycles(10, INTERRUPT_MOUSE);
+    if (!m_move_sent && !CycInt_InterruptActive(INTERRUPT_MOUSE)) {
+        CycInt_AddRelativeInterruptCycles(10, INTERRUPT_MOUSE);
+    }
 }
 
-void kms_mouse_move_step(void) {
+static void kms_mouse_move_step(void) {
     
-    int x = m_move_x > m_move_dx ? m_move_dx : m_move_x;
-    int y = m_move_y > m_move_dy ? m_move_dy : m_move_y;
+    int x = m_move_x;
+    int y = m_move_y;
+    
+    if (x > MOUSE_MAX_DELTA)  x = MOUSE_MAX_DELTA;
+    if (x < -MOUSE_MAX_DELTA) x = -MOUSE_MAX_DELTA;
+    if (y > MOUSE_MAX_DELTA)  y = MOUSE_MAX_DELTA;
+    if (y < -MOUSE_MAX_DELTA) y = -MOUSE_MAX_DELTA;
 
     m_move_x -= x;
     m_move_y -= y;
     
-    if (!m_move_left && x>0)  /* right */
-        x=(0x40-x)|0x40;
-    if (!m_move_up && y>0)    /* down */
-        y=(0x40-y)|0x40;
-    
     if (kms_device_enabled(km_address|KM_ADDR_MOUSE)) {
         kms.km_data = (km_address|KM_ADDR_MOUSE)<<24; /* mouse */
         
-        kms.km_data |= (x<<1)&MOUSE_X;
+        kms.km_data |= (x<<1)&MOUSE_X; /* 7 bit two's complement */
         kms.km_data |= (y<<9)&MOUSE_Y;
         
         kms.km_data |= m_button_left?0:MOUSE_LEFT_UP;
         kms.km_data |= m_button_right?0:MOUSE_RIGHT_UP;
         
         kms_interrupt();
+        m_move_sent = true;
+    } else {
+        kms_mouse_reset();
     }
 }
 
@@ -556,8 +569,7 @@ void kms_response(void) {
 void Mouse_Handler(void) {
     CycInt_AcknowledgeInterrupt();
     
-    if (m_move_x > 0 || m_move_y > 0) {
+    if (m_move_x || m_move_y) {
         kms_mouse_move_step();
-        CycInt_AddRelativeInterruptUs((1000*1000)/MOUSE_STEP_FREQ, 0, INTERRUPT_MOUSE);
     }
 }
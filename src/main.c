@@ -22,7 +22,10 @@ const char Main_fileid[] = "Hatari main.c : " __DATE__ " " __TIME__;
 #include "log.h"
 #include "m68000.h"
 #include "paths.h"
+#include "replay.h"
+#include "bench.h"
 #include "reset.h"
+#include "scc.h"
 #include "screen.h"
 #include "sdlgui.h"
 #include "shortcut.h"
@@ -32,6 +35,8 @@ const char Main_fileid[] = "Hatari main.c : " __DATE__ " " __TIME__;
 #include "str.h"
 #include "video.h"
 #include "audio.h"
+#include "avi_record.h"
+#include "printer.h"
 #include "debugui.h"
 #include "file.h"
 #include "dsp.h"
@@ -102,6 +107,8 @@ const char* Main_SpeedMsg() {
 static const report_t reports[] = {
     {"ND",    nd_reports},
     {"Host",  host_report},
+    {"Audio", Audio_Output_Report},
+    {"AVI",   Avi_Report},
 };
 #endif
 
@@ -221,31 +228,103 @@ void Main_WarpMouse(int x, int y) {
 
 /* ----------------------------------------------------------------------- */
 /**
- * Handle mouse motion event.
+ * Merge all queued mouse motion events into the given one.
  */
 SDL_Event mymouse[100];
-static void Main_HandleMouseMotion(SDL_Event *pEvent) {
-	int dx, dy;
+static void Main_CoalesceMouseMotion(SDL_Event *pEvent) {
 	int i,nb;
 
-	dx = pEvent->motion.xrel;
-	dy = pEvent->motion.yrel;
-
 	/* get all mouse event to clean the queue and sum them */
 	nb=SDL_PeepEvents(&mymouse[0], 100, SDL_GETEVENT, SDL_MOUSEMOTION, SDL_MOUSEMOTION);
 
 	for (i=0;i<nb;i++) {
-        dx += mymouse[i].motion.xrel;
-        dy += mymouse[i].motion.yrel;
+        pEvent->motion.xrel += mymouse[i].motion.xrel;
+        pEvent->motion.yrel += mymouse[i].motion.yrel;
 	}
+}
 
-	if (bGrabMouse) {
+/* ----------------------------------------------------------------------- */
+/**
+ * Handle mouse motion event.
+ */
+static void Main_HandleMouseMotion(SDL_Event *pEvent) {
+	int dx, dy;
+
+	dx = pEvent->motion.xrel;
+	dy = pEvent->motion.yrel;
+
+	/* Speed depends on the grab state, which is not part of the event */
+	if (Replay_Bool(REPLAY_MOUSE_GRAB, bGrabMouse)) {
     	Keymap_MouseMove(dx,dy,ConfigureParams.Mouse.fLinSpeedLocked,ConfigureParams.Mouse.fExpSpeedLocked);
 	} else {
     	Keymap_MouseMove(dx,dy,ConfigureParams.Mouse.fLinSpeedNormal,ConfigureParams.Mouse.fLinSpeedNormal);
 	}
 }
 
+/* ----------------------------------------------------------------------- */
+/**
+ * Handle keyboard and mouse events. These are the only SDL events that
+ * reach the emulated machine, so they are recorded and replayed.
+ */
+static void Main_HandleInput(SDL_Event *pEvent) {
+    switch (pEvent->type) {
+        case SDL_MOUSEMOTION:               /* Read/Update internal mouse position */
+            Main_HandleMouseMotion(pEvent);
+            break;
+            
+        case SDL_MOUSEBUTTONDOWN:
+            if (pEvent->button.button == SDL_BUTTON_LEFT) {
+                /* Don't take the host mouse for replayed clicks */
+                if (ConfigureParams.Mouse.bEnableAutoGrab && !bGrabMouse && replay_mode != REPLAY_PLAY) {
+                    bGrabMouse = true;        /* Toggle flag */
+                    
+                    /* If we are in windowed mode, toggle the mouse cursor mode now: */
+                    if (!bInFullScreen)
+                    {
+                        SDL_SetRelativeMouseMode(SDL_TRUE);
+                        SDL_SetWindowGrab(sdlWindow, SDL_TRUE);
+                        Main_SetTitle(MOUSE_LOCK_MSG);
+                    }
+                }
+                
+                Keymap_MouseDown(true);
+            }
+            else if (pEvent->button.button == SDL_BUTTON_RIGHT)
+            {
+                Keymap_MouseDown(false);
+            }
+            break;
+            
+        case SDL_MOUSEBUTTONUP:
+            if (pEvent->button.button == SDL_BUTTON_LEFT) {
+                Keymap_MouseUp(true);
+            }
+            else if (pEvent->button.button == SDL_BUTTON_RIGHT)
+            {
+                Keymap_MouseUp(false);
+            }
+            break;
+            
+        case SDL_MOUSEWHEEL:
+            Keymap_MouseWheel(&pEvent->wheel);
+            break;
+            
+        case SDL_KEYDOWN:
+            if (pEvent->key.repeat)
+                break;
+            
+            Keymap_KeyDown(&pEvent->key.keysym);
+            break;
+            
+        case SDL_KEYUP:
+            Keymap_KeyUp(&pEvent->key.keysym);
+            break;
+            
+        default:
+            break;
+    }
+}
+
 static int statusBarUpdate;
 
 /* ----------------------------------------------------------------------- */
@@ -259,6 +338,16 @@ void Main_EventHandler(void) {
     int events;
     int remotepause;
     
+    if (replay_mode == REPLAY_PLAY) {
+        while (Replay_Fetch(REPLAY_SDL_EVENT, &event, sizeof(event)) >= 0) {
+            Main_HandleInput(&event);
+        }
+        if (Replay_Fetch(REPLAY_END, NULL, 0) >= 0) {
+            bQuitProgram = true;
+            M68000_SetSpecial(SPCFLAG_BRK);
+        }
+    }
+    
     if(++statusBarUpdate > 400) {
         double vt;
         double rt;
@@ -297,7 +386,7 @@ void Main_EventHandler(void) {
         
         if ( bEmulationActive || remotepause ) {
             double time_offset = host_real_time_offset() * 1000;
-            if(time_offset > 10)
+            if(time_offset > 10 && !Bench_Active())   /* benchmarks run unthrottled */
                 events = SDL_WaitEventTimeout(&event, time_offset);
             else
                 events = SDL_PollEvent(&event);
@@ -328,58 +417,20 @@ void Main_EventHandler(void) {
                 break;
                 
             case SDL_MOUSEMOTION:               /* Read/Update internal mouse position */
-                Main_HandleMouseMotion(&event);
-                bContinueProcessing = false;
-                break;
-                
+                Main_CoalesceMouseMotion(&event);
+                /* fall through */
             case SDL_MOUSEBUTTONDOWN:
-                if (event.button.button == SDL_BUTTON_LEFT) {
-                    if (ConfigureParams.Mouse.bEnableAutoGrab && !bGrabMouse) {
-                        bGrabMouse = true;        /* Toggle flag */
-                        
-                        /* If we are in windowed mode, toggle the mouse cursor mode now: */
-                        if (!bInFullScreen)
-                        {
-                            SDL_SetRelativeMouseMode(SDL_TRUE);
-                            SDL_SetWindowGrab(sdlWindow, SDL_TRUE);
-                            Main_SetTitle(MOUSE_LOCK_MSG);
-                        }
-                    }
-                    
-                    Keymap_MouseDown(true);
-                }
-                else if (event.button.button == SDL_BUTTON_RIGHT)
-                {
-                    Keymap_MouseDown(false);
-                }
-                break;
-                
             case SDL_MOUSEBUTTONUP:
-                if (event.button.button == SDL_BUTTON_LEFT) {
-                    Keymap_MouseUp(true);
-                }
-                else if (event.button.button == SDL_BUTTON_RIGHT)
-                {
-                    Keymap_MouseUp(false);
-                }
-                break;
-                
             case SDL_MOUSEWHEEL:
-                Keymap_MouseWheel(&event.wheel);
-                break;
-                
             case SDL_KEYDOWN:
-                if (event.key.repeat)
-                    break;
-                
-                Keymap_KeyDown(&event.key.keysym);
-                break;
-                
             case SDL_KEYUP:
-                Keymap_KeyUp(&event.key.keysym);
+                /* Input comes from the recording during replay */
+                if (replay_mode == REPLAY_PLAY)
+                    break;
+                Replay_Record(REPLAY_SDL_EVENT, &event, sizeof(event));
+                Main_HandleInput(&event);
                 break;
                 
-                
             default:
                 /* don't let unknown events delay event processing */
                 bContinueProcessing = true;
@@ -451,6 +502,7 @@ static void Main_Init(void) {
     Reset_Cold();
     
 	IoMem_Init();
+	Avi_Init();
 	
     /* Start EventHandler */
     CycInt_AddRelativeInterruptUs(500*1000, 0, INTERRUPT_EVENT_LOOP);
@@ -467,6 +519,10 @@ static void Main_Init(void) {
 static void Main_UnInit(void) {
 	Screen_ReturnFromFullScreen();
 	IoMem_UnInit();
+	SCC_UnInit();
+	Replay_UnInit();
+	Avi_UnInit();
+	Printer_UnInit();
 	SDLGui_UnInit();
 	Screen_UnInit();
 	Exit680x0();
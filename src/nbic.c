@@ -549,37 +549,45 @@ void nextbus_board_bput(Uint32 addr, Uint32 val) {
 
 /* Init function for NextBus */
 void nextbus_init(void) {
-    if (ConfigureParams.Dimension.bEnabled && (ConfigureParams.System.nMachineType == NEXT_CUBE030 || ConfigureParams.System.nMachineType == NEXT_CUBE040)) {
-        Log_Printf(LOG_WARN, "[NextBus/ND] board at slot %i",ND_SLOT);
-        
-        nextbus_board[ND_SLOT].lget = nd_board_lget;
-        nextbus_board[ND_SLOT].wget = nd_board_wget;
-        nextbus_board[ND_SLOT].bget = nd_board_bget;
-        nextbus_board[ND_SLOT].lput = nd_board_lput;
-        nextbus_board[ND_SLOT].wput = nd_board_wput;
-        nextbus_board[ND_SLOT].bput = nd_board_bput;
-        nextbus_slot[ND_SLOT].lget = nd_slot_lget;
-        nextbus_slot[ND_SLOT].wget = nd_slot_wget;
-        nextbus_slot[ND_SLOT].bget = nd_slot_bget;
-        nextbus_slot[ND_SLOT].lput = nd_slot_lput;
-        nextbus_slot[ND_SLOT].wput = nd_slot_wput;
-        nextbus_slot[ND_SLOT].bput = nd_slot_bput;
-        
+    int i, slot;
+    bool enabled = ConfigureParams.Dimension.bEnabled && (ConfigureParams.System.nMachineType == NEXT_CUBE030 || ConfigureParams.System.nMachineType == NEXT_CUBE040);
+    
+    for (i = 0; i < ND_MAX_BOARDS; i++) {
+        slot = ND_SLOT(i);
+        if (enabled && i < ConfigureParams.Dimension.nNumBoards) {
+            Log_Printf(LOG_WARN, "[NextBus/ND] board at slot %i",slot);
+            
+            nextbus_board[slot].lget = nd_board_lget;
+            nextbus_board[slot].wget = nd_board_wget;
+            nextbus_board[slot].bget = nd_board_bget;
+            nextbus_board[slot].lput = nd_board_lput;
+            nextbus_board[slot].wput = nd_board_wput;
+            nextbus_board[slot].bput = nd_board_bput;
+            nextbus_slot[slot].lget = nd_slot_lget;
+            nextbus_slot[slot].wget = nd_slot_wget;
+            nextbus_slot[slot].bget = nd_slot_bget;
+            nextbus_slot[slot].lput = nd_slot_lput;
+            nextbus_slot[slot].wput = nd_slot_wput;
+            nextbus_slot[slot].bput = nd_slot_bput;
+        } else {
+            nextbus_board[slot].lget = nb_timeout_lget;
+            nextbus_board[slot].wget = nb_timeout_wget;
+            nextbus_board[slot].bget = nb_timeout_bget;
+            nextbus_board[slot].lput = nb_timeout_lput;
+            nextbus_board[slot].wput = nb_timeout_wput;
+            nextbus_board[slot].bput = nb_timeout_bput;
+            nextbus_slot[slot].lget = nb_timeout_lget;
+            nextbus_slot[slot].wget = nb_timeout_wget;
+            nextbus_slot[slot].bget = nb_timeout_bget;
+            nextbus_slot[slot].lput = nb_timeout_lput;
+            nextbus_slot[slot].wput = nb_timeout_wput;
+            nextbus_slot[slot].bput = nb_timeout_bput;
+        }
+    }
+    
+    if (enabled) {
         dimension_init();
-	} else {
-		nextbus_board[ND_SLOT].lget = nb_timeout_lget;
-		nextbus_board[ND_SLOT].wget = nb_timeout_wget;
-		nextbus_board[ND_SLOT].bget = nb_timeout_bget;
-		nextbus_board[ND_SLOT].lput = nb_timeout_lput;
-		nextbus_board[ND_SLOT].wput = nb_timeout_wput;
-		nextbus_board[ND_SLOT].bput = nb_timeout_bput;
-		nextbus_slot[ND_SLOT].lget = nb_timeout_lget;
-		nextbus_slot[ND_SLOT].wget = nb_timeout_wget;
-		nextbus_slot[ND_SLOT].bget = nb_timeout_bget;
-		nextbus_slot[ND_SLOT].lput = nb_timeout_lput;
-		nextbus_slot[ND_SLOT].wput = nb_timeout_wput;
-		nextbus_slot[ND_SLOT].bput = nb_timeout_bput;
-		
-		dimension_uninit();
-	}
+    } else {
+        dimension_uninit();
+    }
 }
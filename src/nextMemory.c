@@ -15,9 +15,10 @@ const char STMemory_fileid[] = "Previous nextMemory.c : " __DATE__ " " __TIME__;
 #include "memory.h"
 
 /*
- * Main RAM buffer (128 MB for turbo systems)
+ * Main RAM buffer (up to 128 MB for turbo systems), allocated by memory_init
  */
-Uint8 NEXTRam[128*1024*1024];
+Uint8 *NEXTRam = NULL;
+Uint32 NEXTRamSize = 0;
 
 Uint32 NEXTRamEnd;
 
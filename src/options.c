@@ -30,6 +30,8 @@ const char Options_fileid[] = "Hatari options.c : " __DATE__ " " __TIME__;
 #include "video.h"
 #include "log.h"
 #include "paths.h"
+#include "replay.h"
+#include "bench.h"
 
 #include "hatari-glue.h"
 
@@ -61,6 +63,7 @@ enum {
 	OPT_CPU_ADDR24,
 	OPT_FPU_TYPE,
 	OPT_FPU_COMPATIBLE,
+	OPT_FPU_HOST_MATH,
 	OPT_MMU,
 
 	OPT_MACHINE,		/* system options */
@@ -77,6 +80,11 @@ enum {
 	OPT_SAVECONFIG,
 	OPT_PARACHUTE,
 	OPT_CONTROLSOCKET,
+	OPT_RECORD,
+	OPT_REPLAY,
+	OPT_BENCH,
+	OPT_BENCH_UNTIL,
+	OPT_BENCH_TIMEOUT,
 	OPT_LOGFILE,
 	OPT_LOGLEVEL,
 	OPT_ALERTLEVEL,
@@ -152,6 +160,8 @@ static const opt_t HatariOptions[] = {
 	  "<x>", "FPU type (x=none/68881/68882/internal)" },
 	{ OPT_FPU_COMPATIBLE, NULL, "--fpu-compatible",
 	  "<bool>", "Use more compatible, but slower FPU emulation" },
+	{ OPT_FPU_HOST_MATH, NULL, "--fpu-host-math",
+	  "<bool>", "Use host math for FPU transcendental functions" },
 	{ OPT_MMU, NULL, "--mmu",
 	  "<bool>", "Use MMU emulation" },
 
@@ -186,6 +196,16 @@ static const opt_t HatariOptions[] = {
 	{ OPT_CONTROLSOCKET, NULL, "--control-socket",
 	  "<file>", "Hatari reads options from given socket at run-time" },
 #endif
+	{ OPT_RECORD, NULL, "--record",
+	  "<file>", "Record all host input to <file> for deterministic replay" },
+	{ OPT_REPLAY, NULL, "--replay",
+	  "<file>", "Replay host input recorded with --record" },
+	{ OPT_BENCH, NULL, "--bench",
+	  "<file>", "Run unthrottled and write a JSON benchmark report to <file>" },
+	{ OPT_BENCH_UNTIL, NULL, "--bench-until",
+	  "<marker>", "End benchmark at breakpoint condition or fb=<checksum>" },
+	{ OPT_BENCH_TIMEOUT, NULL, "--bench-timeout",
+	  "<x>", "End benchmark after <x> emulated seconds (default=600)" },
 	{ OPT_LOGFILE, NULL, "--log-file",
 	  "<file>", "Save log output to <file> (default=stderr)" },
 	{ OPT_LOGLEVEL, NULL, "--log-level",
@@ -879,6 +899,10 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 
 		case OPT_FPU_COMPATIBLE:
 			ok = Opt_Bool(argv[++i], OPT_FPU_COMPATIBLE, &ConfigureParams.System.bCompatibleFPU);
+			break;
+
+		case OPT_FPU_HOST_MATH:
+			ok = Opt_Bool(argv[++i], OPT_FPU_HOST_MATH, &ConfigureParams.System.bFPUHostMath);
 			break;			
 
 		case OPT_MMU:
@@ -977,6 +1001,51 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 			}
 			break;
 
+		case OPT_RECORD:
+			i += 1;
+			errstr = Replay_SetRecordFile(argv[i]);
+			if (errstr)
+			{
+				return Opt_ShowError(OPT_RECORD, argv[i], errstr);
+			}
+			break;
+
+		case OPT_REPLAY:
+			i += 1;
+			errstr = Replay_SetPlayFile(argv[i]);
+			if (errstr)
+			{
+				return Opt_ShowError(OPT_REPLAY, argv[i], errstr);
+			}
+			break;
+
+		case OPT_BENCH:
+			i += 1;
+			errstr = Bench_SetOutput(argv[i]);
+			if (errstr)
+			{
+				return Opt_ShowError(OPT_BENCH, argv[i], errstr);
+			}
+			break;
+
+		case OPT_BENCH_UNTIL:
+			i += 1;
+			errstr = Bench_SetStop(argv[i]);
+			if (errstr)
+			{
+				return Opt_ShowError(OPT_BENCH_UNTIL, argv[i], errstr);
+			}
+			break;
+
+		case OPT_BENCH_TIMEOUT:
+			i += 1;
+			errstr = Bench_SetTimeout(argv[i]);
+			if (errstr)
+			{
+				return Opt_ShowError(OPT_BENCH_TIMEOUT, argv[i], errstr);
+			}
+			break;
+
 		case OPT_LOGFILE:
 			i += 1;
 			ok = Opt_StrCpy(OPT_LOGFILE, false, ConfigureParams.Log.sLogFileName,
@@ -58,6 +58,7 @@ void lp_printer_reset(void);
 void lp_png_setup(Uint32 data);
 void lp_png_print(void);
 void lp_png_finish(void);
+void lp_png_wait(void);
 
 bool lp_data_transfer = false;
 
@@ -609,12 +610,22 @@ void lp_gpo_access(Uint8 data) {
     lp_old_data = data;
 }
 
-/* Printer DMA and printing function */
+/* Printer DMA and printing function.
+ * In fast printing mode the whole DMA buffer is drained in large bursts
+ * instead of 4 kB every 10 ms. */
+#define LP_DMA_BURST        4096
+#define LP_DMA_INTERVAL     10000
+#define LP_FAST_INTERVAL    1000
+
 void Printer_IO_Handler(void) {
     CycInt_AcknowledgeInterrupt();
     
     if (lp_data_transfer) {
-        lp_buffer.limit = 4096;
+        if (ConfigureParams.Printer.bFastPrint) {
+            lp_buffer.limit = sizeof(lp_buffer.data);
+        } else {
+            lp_buffer.limit = LP_DMA_BURST;
+        }
         dma_printer_read_memory();
         
         if (lp_buffer.size==0) {
@@ -628,7 +639,11 @@ void Printer_IO_Handler(void) {
         
         lp_buffer.size = 0;
         
-        CycInt_AddRelativeInterruptUs(10000, 1000, INTERRUPT_LP_IO);
+        if (ConfigureParams.Printer.bFastPrint) {
+            CycInt_AddRelativeInterruptUs(LP_FAST_INTERVAL, 100, INTERRUPT_LP_IO);
+        } else {
+            CycInt_AddRelativeInterruptUs(LP_DMA_INTERVAL, 1000, INTERRUPT_LP_IO);
+        }
     }
 }
 
@@ -646,6 +661,11 @@ void Printer_Reset(void) {
     set_interrupt(INT_PRINTER, RELEASE_INT);
 }
 
+/* Printer uninit function, waits for the last page to be saved */
+void Printer_UnInit(void) {
+    lp_png_wait();
+}
+
 
 /* Helper function for building path and filename of output file */
 static const char *lp_get_filename(void) {
@@ -685,85 +705,164 @@ static const char *lp_get_filename(void) {
 /* PNG printing functions */
 #if USE_PNG_PRINTING
 const int MAX_PAGE_LEN = 400 * 14; // 14 inches is the length of US legal paper, longest paper that fits into the NeXT printer cartridge
-png_structp png_ptr          = NULL;
-png_infop   png_info_ptr     = NULL;
-png_byte**  png_row_pointers = NULL;
-int         png_width;
-int         png_height;
-int         png_count;
+
+/* A page being printed. Rows are stored contiguously, so printer data
+ * can be copied in one go. In fast printing mode finished pages are
+ * handed to a thread for compression and the page is freed there. */
+typedef struct {
+    png_structp png_ptr;
+    png_infop   png_info_ptr;
+    png_byte**  png_row_pointers;
+    png_byte*   png_data;
+    int         png_width;      /* bytes per row */
+    int         png_count;      /* bytes printed */
+    char        png_path[FILENAME_MAX];
+} lp_page_t;
+
+lp_page_t*  lp_page          = NULL;
+SDL_Thread* lp_png_thread    = NULL;
 int         png_page_count   = 0;
-const char* png_path;
+
+static void lp_png_free(lp_page_t* page) {
+    png_destroy_write_struct(&page->png_ptr, &page->png_info_ptr);
+    free(page->png_row_pointers);
+    free(page->png_data);
+    free(page);
+}
+
+/* Write page to PNG file and free it, returns false on error */
+static bool lp_png_write(lp_page_t* page) {
+    FILE* png_fp;
+    
+    png_set_IHDR(page->png_ptr,
+                 page->png_info_ptr,
+                 page->png_width * 8,
+                 page->png_count / page->png_width,
+                 1,
+                 PNG_COLOR_TYPE_GRAY,
+                 PNG_INTERLACE_NONE,
+                 PNG_COMPRESSION_TYPE_DEFAULT,
+                 PNG_FILTER_TYPE_DEFAULT);
+    
+    png_fp = File_Open(page->png_path, "wb");
+    
+    if (png_fp) {
+        png_init_io(page->png_ptr, png_fp);
+        png_set_rows(page->png_ptr, page->png_info_ptr, page->png_row_pointers);
+        png_write_png(page->png_ptr, page->png_info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
+        File_Close(png_fp);
+    }
+    lp_png_free(page);
+    return png_fp != NULL;
+}
+
+static int lp_png_writer(void* data) {
+    lp_page_t* page = data;
+    char path[FILENAME_MAX];
+    
+    strcpy(path, page->png_path);
+    if (!lp_png_write(page)) {
+        Log_Printf(LOG_WARN, "[LP] Could not create output file %s", path);
+    }
+    return 0;
+}
+
+/* Copy inverted printer data, a machine word at a time */
+static void lp_invert_copy(Uint8* dst, const Uint8* src, int size) {
+    Uint64 val;
+    
+    for (; size >= 8; size -= 8, src += 8, dst += 8) {
+        memcpy(&val, src, 8);
+        val = ~val;
+        memcpy(dst, &val, 8);
+    }
+    while (size-- > 0) {
+        *dst++ = ~*src++;
+    }
+}
+#endif
+
+void lp_png_wait(void) {
+#if USE_PNG_PRINTING
+    if (lp_png_thread) {
+        SDL_WaitThread(lp_png_thread, NULL);
+        lp_png_thread = NULL;
+    }
 #endif
+}
 
 void lp_png_setup(Uint32 data) {
 #if USE_PNG_PRINTING
-    int i;
-    png_width = ((data >> 16) & 0x7F) * 32;
+    int i, width = ((data >> 16) & 0x7F) * 4;
     
-    if (png_ptr) {
-        for (i = 0; i < MAX_PAGE_LEN; i++) {
-            png_free(png_ptr, png_row_pointers[i]);
-        }
-        png_free(png_ptr, png_row_pointers);
-        png_destroy_write_struct(&png_ptr, &png_info_ptr);
+    if (lp_page) {
+        lp_png_free(lp_page);
+        lp_page = NULL;
+    }
+    if (width == 0) {
+        Log_Printf(LOG_WARN, "[LP] Invalid page width");
+        return;
     }
     
-    png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-    if (png_ptr == NULL) {
+    lp_page = calloc(1, sizeof(lp_page_t));
+    if (lp_page == NULL) {
         return;
     }
-    png_info_ptr = png_create_info_struct(png_ptr);
-    if (png_info_ptr == NULL) {
-        png_destroy_write_struct(&png_ptr, &png_info_ptr);
-        png_ptr = NULL;
+    lp_page->png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    if (lp_page->png_ptr == NULL) {
+        free(lp_page);
+        lp_page = NULL;
+        return;
+    }
+    lp_page->png_info_ptr = png_create_info_struct(lp_page->png_ptr);
+    lp_page->png_row_pointers = malloc(MAX_PAGE_LEN * sizeof(png_byte*));
+    lp_page->png_data = malloc(MAX_PAGE_LEN * width);
+    if (lp_page->png_info_ptr == NULL || lp_page->png_row_pointers == NULL || lp_page->png_data == NULL) {
+        lp_png_free(lp_page);
+        lp_page = NULL;
         return;
     }
-    
-    png_row_pointers = png_malloc(png_ptr, MAX_PAGE_LEN * sizeof (png_byte *));
     for (i = 0; i < MAX_PAGE_LEN; i++) {
-        png_row_pointers[i] = png_malloc(png_ptr, sizeof (uint8_t) * (png_width / 8));
+        lp_page->png_row_pointers[i] = lp_page->png_data + i * width;
     }
-    png_count  = 0;
-    png_height = 0;
+    lp_page->png_width = width;
+    lp_page->png_count = 0;
 #endif
 }
 
 void lp_png_print(void) {
 #if USE_PNG_PRINTING
-    int i;
+    int size = lp_buffer.size;
     
-    for (i = 0; i < lp_buffer.size; i++) {
-        png_row_pointers[png_count/png_width][(png_count%png_width)/8] = ~lp_buffer.data[i];
-        png_count += 8;
+    if (lp_page == NULL) {
+        return;
     }
+    if (size > MAX_PAGE_LEN * lp_page->png_width - lp_page->png_count) {
+        size = MAX_PAGE_LEN * lp_page->png_width - lp_page->png_count;
+    }
+    lp_invert_copy(lp_page->png_data + lp_page->png_count, lp_buffer.data, size);
+    lp_page->png_count += size;
 #endif
 }
 
 void lp_png_finish(void) {
 #if USE_PNG_PRINTING
-    png_set_IHDR(png_ptr,
-                 png_info_ptr,
-                 png_width,
-                 png_count / png_width,
-                 1,
-                 PNG_COLOR_TYPE_GRAY,
-                 PNG_INTERLACE_NONE,
-                 PNG_COMPRESSION_TYPE_DEFAULT,
-                 PNG_FILTER_TYPE_DEFAULT);
-    
-    png_path = lp_get_filename();
-    
-    FILE* png_fp = File_Open(png_path, "wb");
+    if (lp_page == NULL) {
+        return;
+    }
+    strcpy(lp_page->png_path, lp_get_filename());
     
-    if (png_fp) {
-        png_init_io(png_ptr, png_fp);
-        png_set_rows(png_ptr, png_info_ptr, png_row_pointers);
-        png_write_png(png_ptr, png_info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
-    } else {
+    if (ConfigureParams.Printer.bFastPrint) {
+        /* Compress on a separate thread, one page at a time */
+        lp_png_wait();
+        lp_png_thread = SDL_CreateThread(lp_png_writer, "[Previous] printer PNG encoder", lp_page);
+        if (lp_png_thread == NULL) {
+            lp_png_writer(lp_page);
+        }
+    } else if (!lp_png_write(lp_page)) {
         Statusbar_AddMessage("Laser Printer Error: Could not create output file!", 10000);
     }
-    
-    File_Close(png_fp);
+    lp_page = NULL;
     png_page_count++;
 #endif
 }
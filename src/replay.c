@@ -0,0 +1,291 @@
+/*
+  Previous - replay.c
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+
+  Deterministic record and replay of an emulator session. In cycle-time
+  mode the emulation only depends on its inputs, so every input that comes
+  from the host (keyboard and mouse events and the mouse grab state, packets
+  and serial data from the host backends, the host clock at reset and the
+  state of the sound output queue) is logged with the CPU cycle at which it was consumed. On replay
+  these inputs are handed back at the same cycles instead of being taken
+  from the host, so two runs execute the same instruction stream.
+
+  File format: a 16 byte header (magic, CPU clock, machine type) followed
+  by records of <cycle delta> <type> <length> <payload>, with cycle delta
+  and length encoded as LEB128 varints. The cycle counter restarts at every
+  reset, the REPLAY_RESET record restarts the delta base accordingly.
+*/
+
+#include "main.h"
+#include "configuration.h"
+#include "cycInt.h"
+#include "log.h"
+#include "replay.h"
+
+#define REPLAY_MAGIC    "PREVRPL1"
+#define REPLAY_MAXDATA  8192        /* largest payload (SCC buffer) */
+
+replay_mode_t replay_mode = REPLAY_OFF;
+
+static FILE   *replay_file;
+static Uint64  replay_base;         /* cycle of the previous record */
+
+/* Next record in the file during replay */
+static struct {
+	int    type;
+	Uint64 cycle;
+	int    len;
+	Uint8  data[REPLAY_MAXDATA];
+} replay_next;
+
+static bool replay_diverged;
+
+/* Settings from the file header, applied on every reset */
+static Uint32 replay_cpufreq;
+static Uint32 replay_machine;
+
+
+/* Inputs that can not be replayed are disabled in both modes */
+static void Replay_ForceSettings(void)
+{
+	if (replay_mode == REPLAY_PLAY) {
+		/* Replaying with different timing would diverge immediately */
+		ConfigureParams.System.nCpuFreq = replay_cpufreq;
+		ConfigureParams.System.nMachineType = replay_machine;
+	}
+	ConfigureParams.System.bRealtime = false;
+	ConfigureParams.System.bFPUHostMath = false; /* host libm may differ */
+	ConfigureParams.Dimension.bI860Thread = false;
+	ConfigureParams.Sound.bEnableMicrophone = false;
+}
+
+static void Replay_PutVarint(Uint64 val)
+{
+	do {
+		fputc((val & 0x7F) | (val > 0x7F ? 0x80 : 0), replay_file);
+		val >>= 7;
+	} while (val);
+}
+
+static bool Replay_GetVarint(Uint64 *val)
+{
+	int c, shift = 0;
+
+	*val = 0;
+	do {
+		if ((c = fgetc(replay_file)) == EOF || shift > 63)
+			return false;
+		*val |= (Uint64)(c & 0x7F) << shift;
+		shift += 7;
+	} while (c & 0x80);
+	return true;
+}
+
+static void Replay_PutLong(Uint32 val)
+{
+	int i;
+	for (i = 0; i < 4; i++)
+		fputc(val >> (i * 8), replay_file);
+}
+
+static Uint32 Replay_GetLong(void)
+{
+	Uint32 val = 0;
+	int i;
+	for (i = 0; i < 4; i++)
+		val |= (Uint32)(fgetc(replay_file) & 0xFF) << (i * 8);
+	return val;
+}
+
+/* Read the next record, stop replaying at the end of the file */
+static void Replay_ReadNext(void)
+{
+	Uint64 delta, len;
+	int type;
+
+	if (!Replay_GetVarint(&delta) || (type = fgetc(replay_file)) == EOF ||
+	    !Replay_GetVarint(&len) || len > REPLAY_MAXDATA ||
+	    fread(replay_next.data, 1, len, replay_file) != len) {
+		Log_Printf(LOG_WARN, "[Replay] Unexpected end of recording, continuing with live input");
+		Replay_UnInit();
+		return;
+	}
+	replay_next.type  = type;
+	replay_next.cycle = replay_base + delta;
+	replay_next.len   = len;
+	replay_base       = replay_next.cycle;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Start recording to the given file. Returns an error string or NULL.
+ */
+const char *Replay_SetRecordFile(const char *path)
+{
+	Replay_UnInit();
+
+	replay_file = fopen(path, "wb");
+	if (!replay_file)
+		return "Cannot create recording file";
+
+	replay_base = 0;
+	replay_mode = REPLAY_RECORD;
+	Replay_ForceSettings();
+	return NULL;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Start replaying the given file. Returns an error string or NULL.
+ */
+const char *Replay_SetPlayFile(const char *path)
+{
+	char magic[8];
+
+	Replay_UnInit();
+
+	replay_file = fopen(path, "rb");
+	if (!replay_file)
+		return "Cannot open recording file";
+
+	if (fread(magic, 1, 8, replay_file) != 8 || memcmp(magic, REPLAY_MAGIC, 8)) {
+		fclose(replay_file);
+		replay_file = NULL;
+		return "Not a recording file";
+	}
+	replay_cpufreq = Replay_GetLong();
+	replay_machine = Replay_GetLong();
+
+	replay_base = 0;
+	replay_diverged = false;
+	replay_mode = REPLAY_PLAY;
+	Replay_ForceSettings();
+	Replay_ReadNext();
+	return NULL;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Finish recording or replaying.
+ */
+void Replay_UnInit(void)
+{
+	if (replay_mode == REPLAY_RECORD && ftell(replay_file) > 0) {
+		Replay_Record(REPLAY_END, NULL, 0);
+	}
+	if (replay_file) {
+		fclose(replay_file);
+		replay_file = NULL;
+	}
+	replay_mode = REPLAY_OFF;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Called on every emulator reset before the cycle counter is cleared.
+ * Returns the host unix time the emulated clock should start from.
+ */
+time_t Replay_Reset(time_t now)
+{
+	Sint64 recorded;
+
+	switch (replay_mode) {
+		case REPLAY_RECORD:
+			if (ftell(replay_file) == 0) {
+				/* Settings are final once the machine starts */
+				fwrite(REPLAY_MAGIC, 1, 8, replay_file);
+				Replay_PutLong(ConfigureParams.System.nCpuFreq);
+				Replay_PutLong(ConfigureParams.System.nMachineType);
+			}
+			recorded = now;
+			Replay_Record(REPLAY_RESET, &recorded, sizeof(recorded));
+			replay_base = 0;
+			break;
+		case REPLAY_PLAY:
+			if (replay_next.type != REPLAY_RESET) {
+				Log_Printf(LOG_WARN, "[Replay] Reset does not match recording");
+				replay_diverged = true;
+				break;
+			}
+			memcpy(&recorded, replay_next.data, sizeof(recorded));
+			now = recorded;
+			replay_base = 0;
+			Replay_ReadNext();
+			break;
+		default:
+			return now;
+	}
+	Replay_ForceSettings();
+	return now;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Log an input consumed at the current cycle.
+ */
+void Replay_Record(replay_type_t type, const void *data, int len)
+{
+	Uint64 cycle = nCyclesMainCounter;
+
+	if (replay_mode != REPLAY_RECORD)
+		return;
+
+	Replay_PutVarint(cycle - replay_base);
+	fputc(type, replay_file);
+	Replay_PutVarint(len);
+	if (len > 0)
+		fwrite(data, 1, len, replay_file);
+	replay_base = cycle;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return the input of the given type recorded for the current cycle.
+ * Copies at most len bytes and returns the number of bytes copied, or -1
+ * if there is no such input now.
+ */
+int Replay_Fetch(replay_type_t type, void *data, int len)
+{
+	int n;
+
+	if (replay_mode != REPLAY_PLAY || replay_next.type != (int)type ||
+	    replay_next.cycle > (Uint64)nCyclesMainCounter)
+		return -1;
+
+	if (replay_next.cycle < (Uint64)nCyclesMainCounter && !replay_diverged) {
+		Log_Printf(LOG_WARN, "[Replay] Input recorded for cycle %llu consumed at cycle %llu, replay diverged",
+		           (unsigned long long)replay_next.cycle, (unsigned long long)nCyclesMainCounter);
+		replay_diverged = true;
+	}
+	n = data ? (replay_next.len < len ? replay_next.len : len) : 0;
+	if (n > 0)
+		memcpy(data, replay_next.data, n);
+	if (type == REPLAY_END) {
+		Log_Printf(LOG_WARN, "[Replay] End of recording at cycle %llu", (unsigned long long)replay_next.cycle);
+		Replay_UnInit();
+	} else {
+		Replay_ReadNext();
+	}
+	return n;
+}
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Record or replay a host condition. Only true is stored.
+ */
+bool Replay_Bool(replay_type_t type, bool value)
+{
+	switch (replay_mode) {
+		case REPLAY_RECORD:
+			if (value)
+				Replay_Record(type, NULL, 0);
+			return value;
+		case REPLAY_PLAY:
+			return Replay_Fetch(type, NULL, 0) >= 0;
+		default:
+			return value;
+	}
+}
@@ -29,6 +29,7 @@ const char Reset_fileid[] = "Hatari reset.c : " __DATE__ " " __TIME__;
 #include "printer.h"
 #include "dsp.h"
 #include "kms.h"
+#include "bench.h"
 
 /*-----------------------------------------------------------------------*/
 /**
@@ -63,6 +64,7 @@ static const char* Reset_NeXT(bool bCold)
 	DSP_Reset();                  /* Reset DSP */
 	M68000_Reset(bCold);          /* Reset CPU */
 	DebugCpu_SetDebugging();      /* Re-set debugging flag if needed */
+	Bench_Reset();                /* Restart benchmark measurement */
     
 	return NULL;
 }
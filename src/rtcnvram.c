@@ -878,7 +878,7 @@ void nvram_init(void) {
 	if (ConfigureParams.Dimension.bEnabled) {
 		rtc.ram[17] |= USE_CONSOLE_SLOT;
 		if (ConfigureParams.Dimension.bMainDisplay) {
-			rtc.ram[17] |= (ND_SLOT>>1)<<3;
+			rtc.ram[17] |= (ND_SLOT(0)>>1)<<3;
 		}
     }
 
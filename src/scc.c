@@ -5,7 +5,11 @@
  
  Serial Communication Controller (AMD AM8530H) Emulation.
  
- Incomplete. Hacked to pass power-on test --> see SCC_Reset()
+ Asynchronous mode only. Each channel has a receive FIFO and a transmit
+ buffer which are exchanged with a host backend (see scc_host.c) from a
+ periodic I/O event. Without a backend, or with local loopback enabled,
+ transmitted characters are looped back to the receiver; the ROM power-on
+ test depends on this.
  
  */
 
@@ -16,12 +20,18 @@
 #include "scc.h"
 #include "sysReg.h"
 #include "dma.h"
+#include "cycInt.h"
+#include "scc_host.h"
+#include "replay.h"
 
 #define IO_SEG_MASK	0x1FFFF
 
 #define LOG_SCC_LEVEL		LOG_NONE
 #define LOG_SCC_REG_LEVEL	LOG_NONE
 
+#define SCC_BUFSIZE     4096    /* receive and transmit buffers */
+#define SCC_IO_DELAY    1000    /* microseconds between host polls */
+
 
 /* Registers */
 
@@ -77,23 +87,156 @@ void SCC_DataA_Write(void) {
 struct {
 	Uint8 rreg[16];
 	Uint8 wreg[16];
+	
+	/* Receive FIFO, filled from the host or by loopback */
+	Uint8 rx_buf[SCC_BUFSIZE];
+	int   rx_head;
+	int   rx_count;
+	Uint8 rx_last;
+	
+	/* Transmit buffer, drained to the host */
+	Uint8 tx_buf[SCC_BUFSIZE];
+	int   tx_head;
+	int   tx_count;
+	bool  tx_busy;   /* character written since last I/O event */
+	bool  tx_ip;     /* transmit buffer empty interrupt pending */
 } scc[2];
 
 Uint8 scc_register_pointer = 0;
+Uint8 scc_dma_channel = 0;
 
 /* Write function prototypes */
 void scc_write_init_command(Uint8 ch, Uint8 val);
 void scc_write_mode(Uint8 ch, Uint8 val);
+static void scc_io_schedule(void);
 void scc_write_master_intr_reset(Uint8 val);
 
+static void scc_channel_reset(Uint8 ch, bool hard);
+
+
+/* Channel state */
+
+static bool scc_loopback(Uint8 ch) {
+	return (scc[ch].wreg[14]&WR14_LOOPBACK) || !scc_host_active(ch);
+}
+
+static Uint8 scc_rr0(Uint8 ch) {
+	Uint8 val = scc[ch].rreg[0]&~(RR0_RXAVAIL|RR0_TXEMPTY);
+	if (scc[ch].rx_count>0)
+		val |= RR0_RXAVAIL;
+	if (scc[ch].tx_count<SCC_BUFSIZE)
+		val |= RR0_TXEMPTY;
+	return val;
+}
+
+static Uint8 scc_rr1(Uint8 ch) {
+	Uint8 val = scc[ch].rreg[1]&~RR1_ALLSENT;
+	if (scc[ch].tx_count==0)
+		val |= RR1_ALLSENT;
+	return val;
+}
+
+/* Interrupt pending bits of one channel in channel B position of RR3 */
+static Uint8 scc_pending(Uint8 ch) {
+	Uint8 val = 0;
+	
+	if (scc[ch].rx_count>0 && (scc[ch].wreg[1]&WR1_SPECIE)!=0 && (scc[ch].wreg[1]&WR1_SPECIE)!=WR1_SPECIE)
+		val |= RR3_B_RXIP;
+	if (scc[ch].tx_ip && (scc[ch].wreg[1]&WR1_TXIE))
+		val |= RR3_B_TXIP;
+	return val;
+}
+
+static Uint8 scc_rr3(void) {
+	return (scc_pending(0)<<3)|scc_pending(1);
+}
+
+/* Channel B returns the vector modified by the highest pending interrupt */
+static Uint8 scc_rr2(Uint8 ch) {
+	Uint8 vec = scc[0].wreg[2];
+	Uint8 ip = scc_rr3();
+	Uint8 code;
+	
+	if (ch==0)
+		return vec;
+	
+	if (ip&RR3_A_RXIP)      code = 6;
+	else if (ip&RR3_A_TXIP) code = 4;
+	else if (ip&RR3_B_RXIP) code = 2;
+	else if (ip&RR3_B_TXIP) code = 0;
+	else                    code = 3;
+	
+	if (scc[0].wreg[9]&WR9_STATHIGH) {
+		code = ((code&1)<<2)|(code&2)|((code&4)>>2);
+		return (vec&~0x70)|(code<<4);
+	}
+	return (vec&~0x0E)|(code<<1);
+}
+
+static void scc_update_interrupt(void) {
+	if ((scc[0].wreg[9]&WR9_MIE) && scc_rr3()) {
+		set_interrupt(INT_SCC, SET_INT);
+	} else {
+		set_interrupt(INT_SCC, RELEASE_INT);
+	}
+}
+
+static void scc_receive(Uint8 ch, Uint8 val) {
+	if (scc[ch].rx_count<SCC_BUFSIZE) {
+		scc[ch].rx_buf[(scc[ch].rx_head+scc[ch].rx_count)%SCC_BUFSIZE] = val;
+		scc[ch].rx_count++;
+	} else {
+		scc[ch].rreg[1] |= RR1_RXOVER;
+	}
+}
+
+/* Loopback overwrites the receive data register like the real chip does on
+ * overrun, so that the last character of a DMA transfer can be read back. */
+static void scc_loopback_receive(Uint8 ch, Uint8 val) {
+	if (scc[ch].rx_count>0) {
+		scc[ch].rreg[1] |= RR1_RXOVER;
+		scc[ch].rx_count = 0;
+	}
+	scc_receive(ch, val);
+}
+
+static void scc_transmit(Uint8 ch, Uint8 val) {
+	if (scc_loopback(ch)) {
+		scc_loopback_receive(ch, val);
+	} else if (scc[ch].tx_count<SCC_BUFSIZE) {
+		scc[ch].tx_buf[(scc[ch].tx_head+scc[ch].tx_count)%SCC_BUFSIZE] = val;
+		scc[ch].tx_count++;
+	} else {
+		Log_Printf(LOG_WARN, "[SCC] Channel %c: Transmit buffer overflow", ch?'B':'A');
+	}
+	scc[ch].tx_busy = true;
+	scc[ch].tx_ip = false;
+	scc_io_schedule();
+}
+
+static int scc_fetch(Uint8 ch) {
+	if (scc[ch].rx_count==0)
+		return -1;
+	scc[ch].rx_last = scc[ch].rx_buf[scc[ch].rx_head];
+	scc[ch].rx_head = (scc[ch].rx_head+1)%SCC_BUFSIZE;
+	scc[ch].rx_count--;
+	return scc[ch].rx_last;
+}
+
 
 Uint8 scc_control_read(Uint8 ch) {
 	Uint8 val = 0;
 	
 	switch (scc_register_pointer) {
 		case 0:
+			val = scc_rr0(ch);
+			break;
 		case 1:
+			val = scc_rr1(ch);
+			break;
 		case 3:
+			val = ch?0:scc_rr3();
+			break;
 		case 10:
 			val = scc[ch].rreg[scc_register_pointer];
 			break;
@@ -105,11 +248,11 @@ Uint8 scc_control_read(Uint8 ch) {
 			break;
 			
 		case 2:
-			val = scc[0].wreg[2]; // FIXME: different for channel B
+			val = scc_rr2(ch);
 			break;
 			
 		case 8:
-			val = 0; // FIXME: Data Read
+			val = scc_data_read(ch);
 			break;
 			
 		default:
@@ -141,24 +284,31 @@ void scc_control_write(Uint8 ch, Uint8 val) {
 		
 		switch (scc_register_pointer) {
 			case 1:
+				scc[ch].wreg[1] = val;
 				scc_write_mode(ch, val);
 				break;
+			case 2:
+				scc[0].wreg[2] = scc[1].wreg[2] = val;
+				break;
+			case 8:
+				scc_data_write(ch, val);
+				break;
 			case 9:
+				scc[0].wreg[9] = scc[1].wreg[9] = val&~WR9_RESETHARD;
 				scc_write_master_intr_reset(val);
 				break;
-			case 2:
 			case 3:
 			case 4:
 			case 5:
 			case 6:
 			case 7:
-			case 8:
 			case 10:
 			case 11:
 			case 12:
 			case 13:
 			case 14:
 			case 15:
+				scc[ch].wreg[scc_register_pointer] = val;
 				break;
 			
 			default:
@@ -167,13 +317,19 @@ void scc_control_write(Uint8 ch, Uint8 val) {
 		}
 		
 		scc_register_pointer = 0;
+		/* Receiver, loopback or DMA mode may have been enabled */
+		scc_io_schedule();
 	}
+	scc_update_interrupt();
 }
 
 Uint8 scc_data_read(Uint8 ch) {
-	Uint8 val = 0;
+	Uint8 val;
 	
-	val = scc_buf[0];
+	/* Reading an empty FIFO returns the last character again */
+	scc_fetch(ch);
+	val = scc[ch].rx_last;
+	scc_update_interrupt();
 	
 	Log_Printf(LOG_SCC_LEVEL,"[SCC] Channel %c: Data read %02X\n",
 			   ch?'B':'A',val);
@@ -183,15 +339,130 @@ Uint8 scc_data_read(Uint8 ch) {
 
 void scc_data_write(Uint8 ch, Uint8 val) {
 	
-	scc_buf[0] = val;
-	
-	scc[ch].rreg[R_STATUS] = RR0_TXEMPTY|RR0_RXAVAIL;
+	scc_transmit(ch, val);
+	scc_update_interrupt();
 
 	Log_Printf(LOG_SCC_LEVEL,"[SCC] Channel %c: Data write %02X\n",
 			   ch?'B':'A',val);
 }
 
 
+/* DMA interface, whole buffers are moved per request (see dma.c) */
+
+bool SCC_DMA_TxReady(void) {
+	return (scc[scc_dma_channel].wreg[1]&(WR1_REQENABLE|WR1_REQFUNC|WR1_REQRX))==(WR1_REQENABLE|WR1_REQFUNC) &&
+	       scc[scc_dma_channel].tx_count<SCC_BUFSIZE;
+}
+
+void SCC_DMA_Transmit(Uint8 val) {
+	scc_transmit(scc_dma_channel, val);
+}
+
+int SCC_DMA_Receive(void) {
+	if ((scc[scc_dma_channel].wreg[1]&(WR1_REQENABLE|WR1_REQFUNC|WR1_REQRX))!=(WR1_REQENABLE|WR1_REQFUNC|WR1_REQRX))
+		return -1;
+	return scc_fetch(scc_dma_channel);
+}
+
+static void scc_dma_service(void) {
+	Uint8 mode = scc[scc_dma_channel].wreg[1];
+	
+	if ((mode&(WR1_REQENABLE|WR1_REQFUNC))!=(WR1_REQENABLE|WR1_REQFUNC))
+		return;
+	
+	if (mode&WR1_REQRX) {
+		if (scc[scc_dma_channel].rx_count>0)
+			dma_scc_write_memory();
+	} else {
+		if (scc[scc_dma_channel].tx_count<SCC_BUFSIZE)
+			dma_scc_read_memory();
+	}
+	scc_update_interrupt();
+}
+
+
+/* Host I/O */
+
+/* Serial input is part of a recorded session, see replay.c */
+static int scc_host_input(Uint8 ch, Uint8 *buf, int len) {
+	int n;
+	
+	if (replay_mode == REPLAY_PLAY)
+		return Replay_Fetch(REPLAY_SCC_A+ch, buf, len);
+	
+	n = scc_host_read(ch, buf, len);
+	if (n > 0)
+		Replay_Record(REPLAY_SCC_A+ch, buf, n);
+	return n;
+}
+
+static void scc_host_service(Uint8 ch) {
+	int pos, len, n;
+	
+	if (!(scc[ch].wreg[14]&WR14_LOOPBACK)) {
+		/* Drain the transmit buffer, it may wrap around once */
+		while (scc_host_active(ch) && scc[ch].tx_count>0) {
+			len = scc[ch].tx_count;
+			if (scc[ch].tx_head+len>SCC_BUFSIZE)
+				len = SCC_BUFSIZE-scc[ch].tx_head;
+			n = scc_host_write(ch, scc[ch].tx_buf+scc[ch].tx_head, len);
+			if (n<=0)
+				break;
+			scc[ch].tx_head = (scc[ch].tx_head+n)%SCC_BUFSIZE;
+			scc[ch].tx_count -= n;
+		}
+		/* Fill the receive FIFO as far as there is room. A replay
+		 * does not depend on the backend being present here. */
+		while ((scc_host_active(ch) || replay_mode == REPLAY_PLAY) &&
+		       scc[ch].rx_count<SCC_BUFSIZE && (scc[ch].wreg[3]&WR3_RXENABLE)) {
+			pos = (scc[ch].rx_head+scc[ch].rx_count)%SCC_BUFSIZE;
+			len = SCC_BUFSIZE-scc[ch].rx_count;
+			if (pos+len>SCC_BUFSIZE)
+				len = SCC_BUFSIZE-pos;
+			n = scc_host_input(ch, scc[ch].rx_buf+pos, len);
+			if (n<=0)
+				break;
+			scc[ch].rx_count += n;
+		}
+	}
+	
+	/* The transmitter has moved the last character on */
+	if (scc[ch].tx_busy && scc[ch].tx_count<SCC_BUFSIZE) {
+		scc[ch].tx_busy = false;
+		scc[ch].tx_ip = true;
+	}
+}
+
+/* The I/O event only runs while a backend is open or there is
+ * transmit, receive or DMA work pending. */
+static bool scc_io_pending(Uint8 ch) {
+	if (scc_host_active(ch) || scc[ch].tx_busy)
+		return true;
+	if (replay_mode == REPLAY_PLAY && (scc[ch].wreg[3]&WR3_RXENABLE))
+		return true;
+	return ch==scc_dma_channel &&
+	       (scc[ch].wreg[1]&(WR1_REQENABLE|WR1_REQFUNC))==(WR1_REQENABLE|WR1_REQFUNC);
+}
+
+static void scc_io_schedule(void) {
+	if (CycInt_InterruptActive(INTERRUPT_SCC_IO))
+		return;
+	if (scc_io_pending(0) || scc_io_pending(1))
+		CycInt_AddRelativeInterruptUs(SCC_IO_DELAY, 0, INTERRUPT_SCC_IO);
+}
+
+void SCC_IO_Handler(void) {
+	CycInt_AcknowledgeInterrupt();
+	
+	scc_host_service(0);
+	scc_host_service(1);
+	scc_dma_service();
+	scc_update_interrupt();
+	
+	scc_io_schedule();
+}
+
+
 /* Reset functions */
 static void scc_channel_reset(Uint8 ch, bool hard) {
 	
@@ -212,6 +483,10 @@ static void scc_channel_reset(Uint8 ch, bool hard) {
 	scc[ch].rreg[1] = 0x06;
 	scc[ch].rreg[3] = 0x00;
 	scc[ch].rreg[10] = 0x00;
+	
+	scc[ch].rx_head = scc[ch].rx_count = 0;
+	scc[ch].tx_head = scc[ch].tx_count = 0;
+	scc[ch].tx_busy = scc[ch].tx_ip = false;
  
 	if (hard) {
 		scc[0].wreg[9] = (scc[0].wreg[9]&~0xFC)|0xC0;
@@ -228,32 +503,53 @@ void SCC_Reset(Uint8 ch) {
 	} else { // hard reset
 		scc_channel_reset(0, true);
 		scc_channel_reset(1, true);
+		scc_register_pointer = 0;
+		scc_host_start(0);
+		scc_host_start(1);
+		CycInt_RemovePendingInterrupt(INTERRUPT_SCC_IO);
+		scc_io_schedule();
 	}
+	scc_update_interrupt();
+}
+
+void SCC_UnInit(void) {
+	scc_host_stop(0);
+	scc_host_stop(1);
 }
 
 /* Register write functions */
 
 void scc_write_init_command(Uint8 ch, Uint8 val) {
-	
+	switch (val&0x38) {
+		case WR0_RESETTXPEND:
+			scc[ch].tx_ip = false;
+			break;
+		case WR0_RESET:
+			scc[ch].rreg[1] &= ~(RR1_PARITY|RR1_RXOVER|RR1_FRAME);
+			break;
+		default:
+			break;
+	}
 }
 
 void scc_write_mode(Uint8 ch, Uint8 val) {
-	if ((val&0xC0)==0xC0) {
-		dma_scc_read_memory();
-		scc[ch].rreg[R_STATUS] |= RR0_RXAVAIL;
+	if ((val&(WR1_REQENABLE|WR1_REQFUNC))==(WR1_REQENABLE|WR1_REQFUNC)) {
+		scc_dma_channel = ch;
+		scc_dma_service();
 	}
 }
 
 void scc_write_master_intr_reset(Uint8 val) {
 	switch ((val>>6)&3) {
 		case 1:
-			SCC_Reset(1);
+			scc_channel_reset(1, false);
 			break;
 		case 2:
-			SCC_Reset(0);
+			scc_channel_reset(0, false);
 			break;
 		case 3:
-			SCC_Reset(2);
+			scc_channel_reset(0, true);
+			scc_channel_reset(1, true);
 			break;
 			
 		default:
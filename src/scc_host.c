@@ -0,0 +1,267 @@
+/*  Previous - scc_host.c
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+
+  Host backends for the SCC serial channels. A channel can be connected
+  to a pseudo terminal (the slave name is logged and optionally linked to
+  the configured path, so tip, screen or a debugger can attach to it) or
+  to a UNIX stream socket that accepts one client at a time. All file
+  descriptors are non-blocking; scc.c calls in here from its I/O event
+  with whole buffers.
+
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     /* posix_openpt, ptsname */
+#endif
+
+#include "main.h"
+#include "configuration.h"
+#include "log.h"
+#include "scc_host.h"
+
+#if HAVE_UNIX_DOMAIN_SOCKETS || HAVE_POSIX_OPENPT
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#if HAVE_UNIX_DOMAIN_SOCKETS
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+#if HAVE_TERMIOS_H
+#include <termios.h>
+#endif
+
+static struct {
+    SERIALBACKEND backend;
+    int  fd;        /* pty master or listening socket */
+    int  client;    /* connected client for SERIAL_SOCKET */
+    char path[FILENAME_MAX];
+    bool linked;    /* path was created by us and is removed on stop */
+} host[2] = {
+    { SERIAL_NONE, -1, -1 },
+    { SERIAL_NONE, -1, -1 }
+};
+
+
+static void scc_host_nonblock(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+/* Only ever remove a path we could have created ourself */
+static void scc_host_unlink(const char *path, mode_t type) {
+    struct stat st;
+    if (!lstat(path, &st) && (st.st_mode & S_IFMT) == type) {
+        unlink(path);
+    }
+}
+
+#if HAVE_POSIX_OPENPT
+static bool scc_host_open_pty(int ch) {
+    const char *name;
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (fd < 0 || grantpt(fd) < 0 || unlockpt(fd) < 0 || !(name = ptsname(fd))) {
+        Log_Printf(LOG_WARN, "[SCC] Channel %c: Cannot open pseudo terminal: %s",
+                   ch?'B':'A', strerror(errno));
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+#if HAVE_TERMIOS_H && HAVE_CFMAKERAW
+    {
+        struct termios tio;
+        if (!tcgetattr(fd, &tio)) {
+            cfmakeraw(&tio);
+            tcsetattr(fd, TCSANOW, &tio);
+        }
+    }
+#endif
+    scc_host_nonblock(fd);
+    host[ch].fd = fd;
+
+    Log_Printf(LOG_WARN, "[SCC] Channel %c: Connected to %s", ch?'B':'A', name);
+    if (host[ch].path[0]) {
+        scc_host_unlink(host[ch].path, S_IFLNK);
+        if (symlink(name, host[ch].path) < 0) {
+            Log_Printf(LOG_WARN, "[SCC] Channel %c: Cannot link %s: %s",
+                       ch?'B':'A', host[ch].path, strerror(errno));
+        } else {
+            host[ch].linked = true;
+        }
+    }
+    return true;
+}
+#endif
+
+#if HAVE_UNIX_DOMAIN_SOCKETS
+static bool scc_host_open_socket(int ch) {
+    struct sockaddr_un addr;
+    int fd;
+
+    /* Empty paths would bind abstract sockets, long ones other paths */
+    if (!host[ch].path[0]) {
+        Log_Printf(LOG_WARN, "[SCC] Channel %c: No socket path set", ch?'B':'A');
+        return false;
+    }
+    if (strlen(host[ch].path) >= sizeof(addr.sun_path)) {
+        Log_Printf(LOG_WARN, "[SCC] Channel %c: Socket path %s is too long", ch?'B':'A', host[ch].path);
+        return false;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, host[ch].path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        Log_Printf(LOG_WARN, "[SCC] Channel %c: Cannot create socket: %s", ch?'B':'A', strerror(errno));
+        return false;
+    }
+    scc_host_unlink(host[ch].path, S_IFSOCK);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 1) < 0) {
+        Log_Printf(LOG_WARN, "[SCC] Channel %c: Cannot listen on %s: %s",
+                   ch?'B':'A', host[ch].path, strerror(errno));
+        close(fd);
+        return false;
+    }
+    scc_host_nonblock(fd);
+    host[ch].fd = fd;
+    host[ch].linked = true;
+
+    Log_Printf(LOG_WARN, "[SCC] Channel %c: Listening on %s", ch?'B':'A', host[ch].path);
+    return true;
+}
+
+/* Returns the descriptor to talk to, accepting a waiting client if needed */
+static int scc_host_client(int ch) {
+    if (host[ch].client < 0) {
+        host[ch].client = accept(host[ch].fd, NULL, NULL);
+        if (host[ch].client >= 0) {
+            scc_host_nonblock(host[ch].client);
+            Log_Printf(LOG_WARN, "[SCC] Channel %c: Client connected", ch?'B':'A');
+        }
+    }
+    return host[ch].client;
+}
+
+static void scc_host_drop_client(int ch) {
+    Log_Printf(LOG_WARN, "[SCC] Channel %c: Client disconnected", ch?'B':'A');
+    close(host[ch].client);
+    host[ch].client = -1;
+}
+#endif
+
+static int scc_host_fd(int ch) {
+    switch (host[ch].backend) {
+#if HAVE_UNIX_DOMAIN_SOCKETS
+        case SERIAL_SOCKET: return scc_host_client(ch);
+#endif
+        case SERIAL_PTY:    return host[ch].fd;
+        default:            return -1;
+    }
+}
+
+bool scc_host_active(int ch) {
+    return host[ch].fd >= 0;
+}
+
+int scc_host_read(int ch, Uint8 *buf, int len) {
+    int fd = scc_host_fd(ch);
+    int n;
+
+    if (fd < 0 || len <= 0)
+        return 0;
+
+    n = read(fd, buf, len);
+#if HAVE_UNIX_DOMAIN_SOCKETS
+    if (host[ch].backend == SERIAL_SOCKET && (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR))) {
+        scc_host_drop_client(ch);
+    }
+#endif
+    /* A pty master returns EIO while no slave is open */
+    return n > 0 ? n : 0;
+}
+
+int scc_host_write(int ch, const Uint8 *buf, int len) {
+    int fd = scc_host_fd(ch);
+    int n;
+
+    if (fd < 0 || len <= 0)
+        return 0;
+
+    n = write(fd, buf, len);
+#if HAVE_UNIX_DOMAIN_SOCKETS
+    if (host[ch].backend == SERIAL_SOCKET && n < 0 && errno != EAGAIN && errno != EINTR) {
+        scc_host_drop_client(ch);
+    }
+#endif
+    return n > 0 ? n : 0;
+}
+
+void scc_host_stop(int ch) {
+    if (host[ch].client >= 0) {
+        close(host[ch].client);
+        host[ch].client = -1;
+    }
+    if (host[ch].fd >= 0) {
+        Log_Printf(LOG_WARN, "[SCC] Channel %c: Disconnecting host backend", ch?'B':'A');
+        close(host[ch].fd);
+        host[ch].fd = -1;
+    }
+    if (host[ch].linked) {
+        scc_host_unlink(host[ch].path, host[ch].backend==SERIAL_PTY ? S_IFLNK : S_IFSOCK);
+        host[ch].linked = false;
+    }
+    host[ch].backend = SERIAL_NONE;
+}
+
+void scc_host_start(int ch) {
+    SERIALPORT *cfg = &ConfigureParams.Serial.port[ch];
+
+    /* Keep the connection across resets unless the configuration changed */
+    if (host[ch].fd >= 0 && host[ch].backend == cfg->nBackend && !strcmp(host[ch].path, cfg->szPath))
+        return;
+
+    scc_host_stop(ch);
+
+    host[ch].backend = cfg->nBackend;
+    strcpy(host[ch].path, cfg->szPath);
+
+    switch (host[ch].backend) {
+#if HAVE_POSIX_OPENPT
+        case SERIAL_PTY:
+            if (scc_host_open_pty(ch))
+                return;
+            break;
+#endif
+#if HAVE_UNIX_DOMAIN_SOCKETS
+        case SERIAL_SOCKET:
+            if (scc_host_open_socket(ch))
+                return;
+            break;
+#endif
+        case SERIAL_NONE:
+            return;
+        default:
+            Log_Printf(LOG_WARN, "[SCC] Channel %c: Serial backend is not supported on this host", ch?'B':'A');
+            break;
+    }
+    host[ch].backend = SERIAL_NONE;
+}
+
+#else /* !HAVE_UNIX_DOMAIN_SOCKETS && !HAVE_POSIX_OPENPT */
+
+bool scc_host_active(int ch) { return false; }
+int  scc_host_read(int ch, Uint8 *buf, int len) { return 0; }
+int  scc_host_write(int ch, const Uint8 *buf, int len) { return 0; }
+void scc_host_stop(int ch) {}
+void scc_host_start(int ch) {
+    if (ConfigureParams.Serial.port[ch].nBackend != SERIAL_NONE) {
+        Log_Printf(LOG_WARN, "[SCC] Channel %c: Serial backends are not supported on this host", ch?'B':'A');
+    }
+}
+
+#endif
@@ -10,9 +10,15 @@
  * FreeBSD.  They are fixed size, determined by the MTU,
  * so that one whole packet can fit.  Mbuf's cannot be
  * chained together.  If there's more data than the mbuf
- * could hold, an external malloced buffer is pointed to
+ * could hold, an external buffer is pointed to
  * by m_ext (and the data pointers) and M_EXT is set in
  * the flags
+ *
+ * Both mbufs and external buffers come from pools that grow
+ * in chunks and never give memory back, so a steady packet
+ * flow does not call malloc() or free() at all.  External
+ * buffers are clusters of MCLBYTES << n bytes, only requests
+ * larger than the biggest cluster are malloced.
  */
 
 #include <stdlib.h>
@@ -22,10 +28,16 @@ struct	mbuf *mbutl;
 char	*mclrefcnt;
 int mbuf_alloced = 0;
 struct mbuf m_freelist, m_usedlist;
-int mbuf_thresh = 30;
 int mbuf_max = 0;
 size_t msize;
 
+#define MBUF_CHUNK	32		/* mbufs allocated at once */
+#define MCL_CLASSES	6		/* clusters of 2 KB up to 64 KB */
+#define MCL_CHUNKBYTES	(MCLBYTES << (MCL_CLASSES - 1))	/* allocated at once */
+
+int mcl_alloced = 0;
+static char *mcl_freelist[MCL_CLASSES];
+
 void m_init()
 {
 	m_freelist.m_next = m_freelist.m_prev = &m_freelist;
@@ -41,39 +53,108 @@ void msize_init()
 	 */
 	msize = (if_mtu>if_mru?if_mtu:if_mru) + 
 			if_maxlinkhdr + sizeof(struct m_hdr ) + 6;
+	/* mbufs are packed into chunks, keep them aligned */
+	msize = (msize + 15) & ~(size_t)15;
+}
+
+/*
+ * Cluster class for size bytes, -1 if it is too big for a cluster
+ */
+static int m_clclass(u_int size)
+{
+	int c;
+
+	for (c = 0; c < MCL_CLASSES; c++)
+		if (size <= (MCLBYTES << c))
+			return c;
+	return -1;
+}
+
+/*
+ * Get a cluster of class c, the free list is linked
+ * through the first word of each free cluster
+ */
+static char *m_clget(int c)
+{
+	char *cl;
+	size_t size = MCLBYTES << c;
+	int i, n = MCL_CHUNKBYTES / size;
+
+	if (mcl_freelist[c] == NULL) {
+		cl = (char *)malloc(MCL_CHUNKBYTES);
+		if (cl == NULL)
+			return NULL;
+		for (i = 0; i < n; i++) {
+			*(char **)(cl + i * size) = mcl_freelist[c];
+			mcl_freelist[c] = cl + i * size;
+		}
+		mcl_alloced += n;
+	}
+
+	cl = mcl_freelist[c];
+	mcl_freelist[c] = *(char **)cl;
+	return cl;
+}
+
+/*
+ * Free an external buffer of size bytes
+ */
+static void m_clfree(char *cl, size_t size)
+{
+	int c = m_clclass(size);
+
+	if (c < 0) {
+		free(cl);
+		return;
+	}
+	*(char **)cl = mcl_freelist[c];
+	mcl_freelist[c] = cl;
+}
+
+/*
+ * Put MBUF_CHUNK new mbufs on the free list
+ */
+static int m_grow(void)
+{
+	char *chunk;
+	struct mbuf *m;
+	int i;
+
+	chunk = (char *)malloc(msize * MBUF_CHUNK);
+	if (chunk == NULL)
+		return -1;
+
+	for (i = 0; i < MBUF_CHUNK; i++) {
+		m = (struct mbuf *)(chunk + i * msize);
+		insque(m,&m_freelist);
+		m->m_flags = M_FREELIST;
+	}
+	mbuf_alloced += MBUF_CHUNK;
+	if (mbuf_alloced > mbuf_max)
+		mbuf_max = mbuf_alloced;
+	return 0;
 }
 
 /*
  * Get an mbuf from the free list, if there are none
- * malloc one
- * 
- * Because fragmentation can occur if we alloc new mbufs and
- * free old mbufs, we mark all mbufs above mbuf_thresh as M_DOFREE,
- * which tells m_free to actually free() it
+ * grow the pool
  */
 struct mbuf *m_get()
 {
 	register struct mbuf *m;
-	int flags = 0;
 	
 	DEBUG_CALL("m_get");
 	
-	if (m_freelist.m_next == &m_freelist) {
-		m = (struct mbuf *)malloc(msize);
-		if (m == NULL) goto end_error;
-		mbuf_alloced++;
-		if (mbuf_alloced > mbuf_thresh)
-			flags = M_DOFREE;
-		if (mbuf_alloced > mbuf_max)
-			mbuf_max = mbuf_alloced;
-	} else {
-		m = m_freelist.m_next;
-		remque(m);
-	}
+	m = NULL;
+	if (m_freelist.m_next == &m_freelist && m_grow() < 0)
+		goto end_error;
+
+	m = m_freelist.m_next;
+	remque(m);
 	
 	/* Insert it in the used list */
 	insque(m,&m_usedlist);
-	m->m_flags = (flags | M_USEDLIST);
+	m->m_flags = M_USEDLIST;
 	
 	/* Initialise it */
 	m->m_size = msize - sizeof(struct m_hdr);
@@ -97,17 +178,14 @@ void m_free(struct mbuf *m)
 	if (m->m_flags & M_USEDLIST)
 	   remque(m);
 	
-	/* If it's M_EXT, free() it */
+	/* If it's M_EXT, give the cluster back */
 	if (m->m_flags & M_EXT)
-	   free(m->m_ext);
+	   m_clfree(m->m_ext, m->m_size);
 
 	/*
-	 * Either free() it or put it on the free list
+	 * Put it on the free list
 	 */
-	if (m->m_flags & M_DOFREE) {
-		free(m);
-		mbuf_alloced--;
-	} else if ((m->m_flags & M_FREELIST) == 0) {
+	if ((m->m_flags & M_FREELIST) == 0) {
 		insque(m,&m_freelist);
 		m->m_flags = M_FREELIST; /* Clobber other flags */
 	}
@@ -137,34 +215,36 @@ void m_cat(register struct mbuf *m, register struct mbuf *n)
 /* make m size bytes large */
 void m_inc(struct mbuf *m, u_int size)
 {
-       int datasize;
-
-	/* some compiles throw up on gotos.  This one we can fake. */
-        if(m->m_size>size) return;
-
-        if (m->m_flags & M_EXT) {
-         datasize = m->m_data - m->m_ext;
-	  m->m_ext = (char *)realloc(m->m_ext,size);
-/*		if (m->m_ext == NULL)
- *			return (struct mbuf *)NULL;
- */		
-         m->m_data = m->m_ext + datasize;
-        } else {
-	  char *dat;
-	  datasize = m->m_data - m->m_dat;
-	  dat = (char *)malloc(size);
-/*		if (dat == NULL)
- *			return (struct mbuf *)NULL;
- */
-	  memcpy(dat, m->m_dat, m->m_size);
-	  
-	  m->m_ext = dat;
-	  m->m_data = m->m_ext + datasize;
-	  m->m_flags |= M_EXT;
-        }
- 
-        m->m_size = size;
+	char *dat;
+	int datasize, c;
+
+	if (m->m_size > size)
+		return;
+
+	/* Round up to a whole cluster, the rest is free room */
+	c = m_clclass(size);
+	if (c >= 0) {
+		size = MCLBYTES << c;
+		dat = m_clget(c);
+	} else {
+		dat = (char *)malloc(size);
+	}
+	if (dat == NULL)
+		return;
+
+	if (m->m_flags & M_EXT) {
+		datasize = m->m_data - m->m_ext;
+		memcpy(dat, m->m_ext, m->m_size);
+		m_clfree(m->m_ext, m->m_size);
+	} else {
+		datasize = m->m_data - m->m_dat;
+		memcpy(dat, m->m_dat, m->m_size);
+	}
 
+	m->m_ext = dat;
+	m->m_data = m->m_ext + datasize;
+	m->m_flags |= M_EXT;
+	m->m_size = size;
 }
 
 
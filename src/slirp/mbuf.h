@@ -37,6 +37,7 @@
 
 
 #define MINCSIZE 4096	/* Amount to increase mbuf if too small */
+#define MCLBYTES 2048	/* Smallest external cluster */
 
 /*
  * Macros for type conversion
@@ -110,11 +111,9 @@ struct mbuf {
 #define ifs_next m_nextpkt
 #define ifq_so m_so
 
-#define M_EXT			0x01	/* m_ext points to more (malloced) data */
+#define M_EXT			0x01	/* m_ext points to more (cluster) data */
 #define M_FREELIST		0x02	/* mbuf is on free list */
 #define M_USEDLIST		0x04	/* XXX mbuf is on used list (for dtom()) */
-#define M_DOFREE		0x08	/* when m_free is called on the mbuf, free()
-					 * it rather than putting it on the free list */
 
 /*
  * Mbuf statistics. XXX
@@ -129,6 +128,7 @@ extern struct	mbstat mbstat;
 extern int mbuf_alloced;
 extern struct mbuf m_freelist, m_usedlist;
 extern int mbuf_max;
+extern int mcl_alloced;
 
 void m_init(void);
 void msize_init(void);
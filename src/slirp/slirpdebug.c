@@ -276,6 +276,7 @@ mbufstats()
 	lprint("Mbuf stats:\r\n");
 
 	lprint("  %6d mbufs allocated (%d max)\r\n", mbuf_alloced, mbuf_max);
+	lprint("  %6d clusters allocated\r\n", mcl_alloced);
 	
 	i = 0;
 	for (m = m_freelist.m_next; m != &m_freelist; m = m->m_next)
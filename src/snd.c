@@ -7,6 +7,11 @@
 #include "dma.h"
 #include "snd.h"
 #include "kms.h"
+#include "replay.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #define LOG_SND_LEVEL   LOG_DEBUG
 #define LOG_VOL_LEVEL   LOG_DEBUG
@@ -16,12 +21,15 @@ static bool   sndout_inited;
 static bool   sound_output_active = false;
 static bool   sndin_inited;
 static bool   sound_input_active = false;
-static Uint8* snd_buffer = NULL;
+
+/* Sound output buffer, twice the maximum chunk size for in-place doubling */
+#define SND_BUFFER_SIZE 16384
+static Uint8  snd_buffer[SND_BUFFER_SIZE*2];
+
+static void snd_init_gain_table(void);
 
 static void sound_init(void) {
-    if(snd_buffer)
-        free(snd_buffer);
-    snd_buffer = NULL;
+    snd_init_gain_table();
     if (!sndout_inited && ConfigureParams.Sound.bEnableSound) {
         Log_Printf(LOG_WARN, "[Audio] Initializing audio device.");
         Audio_Output_Init();
@@ -30,9 +38,6 @@ static void sound_init(void) {
 }
 
 static void sound_uninit(void) {
-    if(snd_buffer)
-        free(snd_buffer);
-    snd_buffer = NULL;
     if(sndout_inited) {
         Log_Printf(LOG_WARN, "[Audio] Uninitializing audio device.");
         sndout_inited=false;
@@ -156,11 +161,7 @@ void snd_stop_input(void) {
 /* Sound IO loops */
 
 static void do_dma_sndout_intr(void) {
-    if(snd_buffer) {
-        dma_sndout_intr();
-        free(snd_buffer);
-        snd_buffer = NULL;
-    }
+    dma_sndout_intr();
 }
 
 /*
@@ -178,13 +179,13 @@ void SND_Out_Handler(void) {
         return;
     }
 
-    if (sndout_inited && Audio_Output_Queue_Size() > AUDIO_BUFFER_SAMPLES * 2) {
+    if (Replay_Bool(REPLAY_SND_FULL, sndout_inited && Audio_Output_Queue_Size() > AUDIO_BUFFER_SAMPLES * 2)) {
         CycInt_AddRelativeInterruptUs(SND_CHECK_DELAY * AUDIO_BUFFER_SAMPLES, 0, INTERRUPT_SND_OUT);
         return;
     }
     
     do_dma_sndout_intr();
-    snd_buffer = dma_sndout_read_memory(&len);
+    len = dma_sndout_read_memory(snd_buffer, SND_BUFFER_SIZE);
     
     if (len) {
         len = snd_send_samples(snd_buffer, len);
@@ -296,14 +297,12 @@ int snd_send_samples(Uint8* buffer, int len) {
         case SND_MODE_DBL_RP:
             snd_make_double_samples(buffer, len, true);
             snd_adjust_volume_and_lowpass(buffer, 2*len);
-            Audio_Output_Queue(buffer, len);
-            Audio_Output_Queue(buffer+len, len);
+            Audio_Output_Queue(buffer, 2*len);
             return 2*len;
         case SND_MODE_DBL_ZF:
             snd_make_double_samples(buffer, len, false);
             snd_adjust_volume_and_lowpass(buffer, 2*len);
-            Audio_Output_Queue(buffer, len);
-            Audio_Output_Queue(buffer+len, len);
+            Audio_Output_Queue(buffer, 2*len);
             return 2*len;
         default:
             Log_Printf(LOG_WARN, "[Sound] Error: Unknown sound output mode!");
@@ -331,35 +330,71 @@ static Sint16 snd_lowpass_filter(Sint16 insample, bool left) {
 }
 #endif
 
+/* Volume gain table in 2.14 fixed point, indexed by attenuation */
+static Sint16 snd_gain[SND_MAX_VOL+1];
+
+static void snd_init_gain_table(void) {
+    int i;
+    snd_gain[0] = 1<<14;
+    for (i=1; i<=SND_MAX_VOL; i++) {
+        snd_gain[i] = (1-log(i)/log(SND_MAX_VOL))*(1<<14);
+    }
+}
+
+/* This function scales big endian stereo samples in place */
+static void snd_adjust_volume(Uint8 *buf, int len, Sint16 lgain, Sint16 rgain) {
+    int i = 0;
+    Sint16 ldata, rdata;
+#ifdef __SSE2__
+    __m128i gain = _mm_set_epi16(rgain, lgain, rgain, lgain, rgain, lgain, rgain, lgain);
+    __m128i data, lo, hi;
+    
+    for (; i+16<=len; i+=16) {
+        data = _mm_loadu_si128((__m128i*)(buf+i));
+        data = _mm_or_si128(_mm_slli_epi16(data, 8), _mm_srli_epi16(data, 8));
+        lo   = _mm_mullo_epi16(data, gain);
+        hi   = _mm_mulhi_epi16(data, gain);
+        data = _mm_packs_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 14),
+                               _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 14));
+        data = _mm_or_si128(_mm_slli_epi16(data, 8), _mm_srli_epi16(data, 8));
+        _mm_storeu_si128((__m128i*)(buf+i), data);
+    }
+#endif
+    for (; i<len; i+=4) {
+        ldata = (Sint16)((buf[i]<<8)|buf[i+1]);
+        rdata = (Sint16)((buf[i+2]<<8)|buf[i+3]);
+        ldata = (ldata*lgain)>>14;
+        rdata = (rdata*rgain)>>14;
+        buf[i] = ldata>>8;
+        buf[i+1] = ldata;
+        buf[i+2] = rdata>>8;
+        buf[i+3] = rdata;
+    }
+}
+
 /* This function adjusts sound output volume */
 void snd_adjust_volume_and_lowpass(Uint8 *buf, int len) {
     int i;
     Sint16 ldata, rdata;
-    float ladjust, radjust;
+    Sint16 lgain, rgain;
     if (sndout_state.mute) {
-        for (i=0; i<len; i++) {
-            buf[i] = 0;
-        }
-    } else if (sndout_state.volume[0] || sndout_state.volume[1] || sndout_state.lowpass) {
-        ladjust = (sndout_state.volume[0]==0)?1:(1-log(sndout_state.volume[0])/log(SND_MAX_VOL));
-        radjust = (sndout_state.volume[1]==0)?1:(1-log(sndout_state.volume[1])/log(SND_MAX_VOL));
+        memset(buf, 0, len);
+    } else if (sndout_state.lowpass) {
+        lgain = snd_gain[sndout_state.volume[0]];
+        rgain = snd_gain[sndout_state.volume[1]];
         
         for (i=0; i<len; i+=4) {
             ldata = (Sint16)((buf[i]<<8)|buf[i+1]);
             rdata = (Sint16)((buf[i+2]<<8)|buf[i+3]);
-#if 1       /* Append lowpass filter */
-            if (sndout_state.lowpass) {
-                ldata = snd_lowpass_filter(ldata, true);
-                rdata = snd_lowpass_filter(rdata, false);
-            }
-#endif
-            ldata = ldata*ladjust;
-            rdata = rdata*radjust;
+            ldata = (snd_lowpass_filter(ldata, true)*lgain)>>14;
+            rdata = (snd_lowpass_filter(rdata, false)*rgain)>>14;
             buf[i] = ldata>>8;
             buf[i+1] = ldata;
             buf[i+2] = rdata>>8;
             buf[i+3] = rdata;
         }
+    } else if (sndout_state.volume[0] || sndout_state.volume[1]) {
+        snd_adjust_volume(buf, len, snd_gain[sndout_state.volume[0]], snd_gain[sndout_state.volume[1]]);
     }
 }
 
@@ -82,5 +82,16 @@ typedef int64_t sbits64;
  *----------------------------------------------------------------------------*/
 #define SOFTFLOAT_I860
 
+/*----------------------------------------------------------------------------
+ | NeXTdimension boards can run on threads of their own, so the i860 rounding
+ | mode and exception flags are thread local. Boards that share a thread set
+ | their rounding mode whenever they get to run.
+ *----------------------------------------------------------------------------*/
+#ifdef _MSC_VER
+#define SOFTFLOAT_I860_THREAD_LOCAL __declspec(thread)
+#else
+#define SOFTFLOAT_I860_THREAD_LOCAL __thread
+#endif
+
 
 #endif //MAMESF_H
\ No newline at end of file
@@ -39,7 +39,7 @@ these four paragraphs for those parts of this code that are retained.
 *----------------------------------------------------------------------------*/
 int8 float_exception_flags = 0;
 #ifdef SOFTFLOAT_I860
-int8 float_exception_flags2 = 0;
+SOFTFLOAT_I860_THREAD_LOCAL int8 float_exception_flags2 = 0;
 #endif
 #ifdef FLOATX80
 int8 floatx80_rounding_precision = 80;
@@ -47,7 +47,7 @@ int8 floatx80_rounding_precision = 80;
 
 int8 float_rounding_mode = float_round_nearest_even;
 #ifdef SOFTFLOAT_I860
-int8 float_rounding_mode2 = float_round_nearest_even;
+SOFTFLOAT_I860_THREAD_LOCAL int8 float_rounding_mode2 = float_round_nearest_even;
 #endif
 
 /*----------------------------------------------------------------------------
@@ -83,7 +83,7 @@ enum {
 *----------------------------------------------------------------------------*/
 extern int8 float_rounding_mode;
 #ifdef SOFTFLOAT_I860
-extern int8 float_rounding_mode2;
+extern SOFTFLOAT_I860_THREAD_LOCAL int8 float_rounding_mode2;
 #endif
 enum {
 	float_round_nearest_even = 0,
@@ -97,7 +97,7 @@ enum {
 *----------------------------------------------------------------------------*/
 extern int8 float_exception_flags;
 #ifdef SOFTFLOAT_I860
-extern int8 float_exception_flags2;
+extern SOFTFLOAT_I860_THREAD_LOCAL int8 float_exception_flags2;
 #endif
 enum {
 	float_flag_invalid = 0x01, float_flag_denormal = 0x02, float_flag_divbyzero = 0x04, float_flag_overflow = 0x08,
@@ -369,6 +369,34 @@ floatx80 floatx80_tan(floatx80 a);
 floatx80 floatx80_tanh(floatx80 a);
 floatx80 floatx80_tentox(floatx80 a);
 floatx80 floatx80_twotox(floatx80 a);
+
+// functions are in softfloat_host.c
+enum {
+    floatx80_func_acos,
+    floatx80_func_asin,
+    floatx80_func_atan,
+    floatx80_func_atanh,
+    floatx80_func_cos,
+    floatx80_func_cosh,
+    floatx80_func_etox,
+    floatx80_func_etoxm1,
+    floatx80_func_log10,
+    floatx80_func_log2,
+    floatx80_func_logn,
+    floatx80_func_lognp1,
+    floatx80_func_sin,
+    floatx80_func_sinh,
+    floatx80_func_tan,
+    floatx80_func_tanh,
+    floatx80_func_tentox,
+    floatx80_func_twotox,
+    floatx80_func_count
+};
+floatx80 floatx80_cached(int8 func, floatx80 a);
+flag floatx80_host_available(void);
+flag floatx80_host_func_supported(int8 func);
+void floatx80_host_enable(int8 func, flag enable);
+bits64 floatx80_host_check(int8 func, int32 count);
 #endif
 
 // functions originally internal to softfloat.c
@@ -0,0 +1,324 @@
+/*============================================================================
+
+ This C source file is an extension to the SoftFloat IEC/IEEE Floating-point
+ Arithmetic Package, Release 2a.
+
+ Written for Previous, NeXT Computer Emulator.
+
+=============================================================================*/
+
+#include <string.h>
+#include "softfloat.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <math.h>
+#define FLOATX80_HOST_MATH 1
+#else
+#define FLOATX80_HOST_MATH 0
+#endif
+
+
+/*----------------------------------------------------------------------------
+| Memoized transcendental functions. Guest programs often evaluate the same
+| function for the same argument over and over (plotting, table setup), so
+| the results of the FPSP functions are kept in a small direct mapped cache.
+| An entry is only valid for the rounding precision and mode it was computed
+| with and also stores the exception flags the computation raised and the
+| intermediate result saved for the exception handlers.
+*----------------------------------------------------------------------------*/
+
+#define FX80_CACHE_BITS 9
+#define FX80_CACHE_SIZE (1<<FX80_CACHE_BITS)
+
+typedef struct {
+    bits64 low;
+    bits16 high;
+    int8 func;          /* function + 1, 0 if empty */
+    int8 prec;
+    int8 mode;
+    int8 flags;
+    floatx80 result;
+    flag internal_sign;
+    int8 internal_precision;
+    int32 internal_exp;
+    bits64 internal_sig0;
+    bits64 internal_sig1;
+} floatx80_cache_entry;
+
+static floatx80_cache_entry floatx80_cache[FX80_CACHE_SIZE];
+
+static floatx80 (*const floatx80_soft_func[floatx80_func_count])(floatx80) = {
+    floatx80_acos,
+    floatx80_asin,
+    floatx80_atan,
+    floatx80_atanh,
+    floatx80_cos,
+    floatx80_cosh,
+    floatx80_etox,
+    floatx80_etoxm1,
+    floatx80_log10,
+    floatx80_log2,
+    floatx80_logn,
+    floatx80_lognp1,
+    floatx80_sin,
+    floatx80_sinh,
+    floatx80_tan,
+    floatx80_tanh,
+    floatx80_tentox,
+    floatx80_twotox
+};
+
+
+/*----------------------------------------------------------------------------
+| Host long double path. On x86-64 Linux long double is the x87 extended
+| format, which has the same layout as floatx80. The host libm results are
+| not bit identical to the FPSP algorithms, so each function is only used
+| after floatx80_host_check() has compared it against softfloat, and only
+| for finite normal arguments in a range where both agree, with extended
+| precision and rounding to nearest.
+*----------------------------------------------------------------------------*/
+
+static flag floatx80_host_enabled[floatx80_func_count];
+
+#if FLOATX80_HOST_MATH
+typedef union {
+    long double f;
+    struct {
+        bits64 low;
+        bits16 high;
+    } x;
+} floatx80_host;
+
+static long double (*const floatx80_host_func[floatx80_func_count])(long double) = {
+    [floatx80_func_cos]  = cosl,
+    [floatx80_func_etox] = expl,
+    [floatx80_func_logn] = logl,
+    [floatx80_func_sin]  = sinl,
+    [floatx80_func_tan]  = tanl
+};
+
+static flag floatx80_host_domain(int8 func, floatx80 a)
+{
+    int32 aExp = extractFloatx80Exp(a);
+
+    if (aExp == 0 || aExp == 0x7FFF || !(a.low & LIT64(0x8000000000000000))) {
+        return 0;
+    }
+    switch (func) {
+        case floatx80_func_cos:
+        case floatx80_func_sin:
+        case floatx80_func_tan:
+            return aExp > 0x3FFF-32 && aExp < 0x3FFF+6; // 2^-32 <= |X| < 64
+        case floatx80_func_etox:
+            return aExp < 0x3FFF+13; // |X| < 8192
+        case floatx80_func_logn:
+            return !extractFloatx80Sign(a) && (aExp != 0x3FFF || a.low != LIT64(0x8000000000000000)); // X > 0, X != 1
+        default:
+            return 0;
+    }
+}
+
+static flag floatx80_host_eval(int8 func, floatx80 a, floatx80 *z)
+{
+    floatx80_host h;
+
+    if (!floatx80_host_domain(func, a)) {
+        return 0;
+    }
+    memset(&h, 0, sizeof(h));
+    h.x.low = a.low;
+    h.x.high = a.high;
+    h.f = floatx80_host_func[func](h.f);
+
+    /* Results close to a zero of sin, cos or tan depend on how exactly the
+       argument is reduced, leave them to softfloat */
+    if ((func == floatx80_func_cos || func == floatx80_func_sin || func == floatx80_func_tan) &&
+        (h.x.high & 0x7FFF) < 0x3FFF-16 && (h.x.high & 0x7FFF) < extractFloatx80Exp(a)) {
+        return 0;
+    }
+    if ((h.x.high & 0x7FFF) == 0 || (h.x.high & 0x7FFF) == 0x7FFF) {
+        return 0;
+    }
+    z->low = h.x.low;
+    z->high = h.x.high;
+    float_raise(float_flag_inexact);
+    floatx80_internal_sign = extractFloatx80Sign(*z);
+    floatx80_internal_exp = extractFloatx80Exp(*z);
+    floatx80_internal_sig0 = z->low;
+    floatx80_internal_sig1 = 0;
+    floatx80_internal_precision = 80;
+    floatx80_internal_mode = float_rounding_mode;
+    return 1;
+}
+#endif
+
+flag floatx80_host_available(void)
+{
+    return FLOATX80_HOST_MATH;
+}
+
+flag floatx80_host_func_supported(int8 func)
+{
+#if FLOATX80_HOST_MATH
+    return floatx80_host_func[func] != NULL;
+#else
+    return 0;
+#endif
+}
+
+void floatx80_host_enable(int8 func, flag enable)
+{
+    enable = enable && floatx80_host_func_supported(func);
+    if (floatx80_host_enabled[func] != enable) {
+        floatx80_host_enabled[func] = enable;
+        memset(floatx80_cache, 0, sizeof(floatx80_cache));
+    }
+}
+
+
+/*----------------------------------------------------------------------------
+| Evaluates function func for argument a, using the cache and, if enabled,
+| the host path.
+*----------------------------------------------------------------------------*/
+
+floatx80 floatx80_cached(int8 func, floatx80 a)
+{
+    floatx80_cache_entry *e;
+    int8 user_flags;
+    bits64 hash;
+
+    hash = a.low ^ (a.low >> 29) ^ ((bits64) a.high << 7) ^ (bits64) func * 0x9E37;
+    e = &floatx80_cache[(hash ^ (hash >> FX80_CACHE_BITS) ^ (hash >> 2*FX80_CACHE_BITS)) & (FX80_CACHE_SIZE-1)];
+
+    if (e->func == func + 1 && e->low == a.low && e->high == a.high &&
+        e->prec == floatx80_rounding_precision && e->mode == float_rounding_mode) {
+        float_exception_flags |= e->flags;
+        floatx80_internal_sign = e->internal_sign;
+        floatx80_internal_exp = e->internal_exp;
+        floatx80_internal_sig0 = e->internal_sig0;
+        floatx80_internal_sig1 = e->internal_sig1;
+        floatx80_internal_precision = e->internal_precision;
+        floatx80_internal_mode = e->mode;
+        return e->result;
+    }
+
+    user_flags = float_exception_flags;
+    float_exception_flags = 0;
+
+#if FLOATX80_HOST_MATH
+    if (!floatx80_host_enabled[func] || floatx80_rounding_precision != 80 ||
+        float_rounding_mode != float_round_nearest_even ||
+        !floatx80_host_eval(func, a, &e->result))
+#endif
+    {
+        e->result = floatx80_soft_func[func](a);
+    }
+
+    e->func = func + 1;
+    e->low = a.low;
+    e->high = a.high;
+    e->prec = floatx80_rounding_precision;
+    e->mode = float_rounding_mode;
+    e->flags = float_exception_flags;
+    e->internal_sign = floatx80_internal_sign;
+    e->internal_exp = floatx80_internal_exp;
+    e->internal_sig0 = floatx80_internal_sig0;
+    e->internal_sig1 = floatx80_internal_sig1;
+    e->internal_precision = floatx80_internal_precision;
+
+    float_exception_flags |= user_flags;
+    return e->result;
+}
+
+
+/*----------------------------------------------------------------------------
+| Distance of a and b in units in the last place of the smaller one, or
+| all ones if they are far apart.
+*----------------------------------------------------------------------------*/
+
+static bits64 floatx80_ulp_distance(floatx80 a, floatx80 b)
+{
+    floatx80 t;
+    bits64 x, y;
+
+    if (a.high == b.high) {
+        return a.low > b.low ? a.low - b.low : b.low - a.low;
+    }
+    if ((a.high ^ b.high) & 0x8000) {
+        return LIT64(0xFFFFFFFFFFFFFFFF);
+    }
+    if ((a.high & 0x7FFF) < (b.high & 0x7FFF)) {
+        t = a; a = b; b = t;
+    }
+    if ((a.high & 0x7FFF) - (b.high & 0x7FFF) != 1) {
+        return LIT64(0xFFFFFFFFFFFFFFFF);
+    }
+    x = a.low - LIT64(0x8000000000000000);
+    y = 0 - b.low;
+    if (x > 1 || y > 2) {
+        return LIT64(0xFFFFFFFFFFFFFFFF);
+    }
+    return 2*x + y;
+}
+
+
+/*----------------------------------------------------------------------------
+| Compares the host path of func against softfloat for count arguments
+| spread over its host domain. Returns the largest difference in ulps, or
+| all ones if func has no host path.
+*----------------------------------------------------------------------------*/
+
+bits64 floatx80_host_check(int8 func, int32 count)
+{
+    bits64 maxdist = LIT64(0xFFFFFFFFFFFFFFFF);
+#if FLOATX80_HOST_MATH
+    int8 user_prec = floatx80_rounding_precision;
+    int8 user_mode = float_rounding_mode;
+    int8 user_flags = float_exception_flags;
+    bits64 seed = LIT64(0x2545F4914F6CDD1D) + func;
+    bits64 dist;
+    floatx80 a, soft, host;
+    int32 i, lo, hi;
+
+    if (!floatx80_host_func_supported(func)) {
+        return maxdist;
+    }
+    switch (func) {
+        case floatx80_func_etox: lo = 0x3FFF-32; hi = 0x3FFF+13; break;
+        case floatx80_func_logn: lo = 0x0001;    hi = 0x7FFE;    break;
+        default:                 lo = 0x3FFF-31; hi = 0x3FFF+6;  break;
+    }
+
+    floatx80_rounding_precision = 80;
+    float_rounding_mode = float_round_nearest_even;
+    maxdist = 0;
+
+    for (i = 0; i < count; i++) {
+        seed = seed * LIT64(6364136223846793005) + LIT64(1442695040888963407);
+        a.low = (seed >> 11) | LIT64(0x8000000000000000);
+        seed = seed * LIT64(6364136223846793005) + LIT64(1442695040888963407);
+        a.high = lo + (bits16) ((seed >> 33) % (hi - lo));
+        if (func != floatx80_func_logn && (seed & 0x100)) {
+            a.high |= 0x8000;
+        }
+        /* Bias logn towards the interesting range around one */
+        if (func == floatx80_func_logn && (seed & 0x200)) {
+            a.high = 0x3FFF - ((seed >> 12) & 1);
+        }
+
+        if (!floatx80_host_eval(func, a, &host)) {
+            continue;
+        }
+        soft = floatx80_soft_func[func](a);
+        dist = floatx80_ulp_distance(host, soft);
+        if (dist > maxdist) {
+            maxdist = dist;
+        }
+    }
+
+    floatx80_rounding_precision = user_prec;
+    float_rounding_mode = user_mode;
+    float_exception_flags = user_flags;
+#endif
+    return maxdist;
+}
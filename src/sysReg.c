@@ -355,12 +355,20 @@ void SCR2_Read3(void)
 
 /* Interrupt Status Register */
 
+Uint32 IntRegStatReadLong(Uint32 addr) {
+    return intStat;
+}
+
+void IntRegStatWriteLong(Uint32 addr, Uint32 val) {
+    intStat = val;
+}
+
 void IntRegStatRead(void) {
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, intStat);
+    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, IntRegStatReadLong(IoAccessCurrentAddress));
 }
 
 void IntRegStatWrite(void) {
-    intStat = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
+    IntRegStatWriteLong(IoAccessCurrentAddress, IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK));
 }
 
 void set_dsp_interrupt(Uint8 state) {
@@ -410,13 +418,21 @@ int get_interrupt_level(void) {
 
 /* Interrupt Mask Register */
 
+Uint32 IntRegMaskReadLong(Uint32 addr) {
+	return intMask;
+}
+
+void IntRegMaskWriteLong(Uint32 addr, Uint32 val) {
+	intMask = val;
+        Log_Printf(LOG_DEBUG,"Interrupt mask: %08x", intMask);
+}
+
 void IntRegMaskRead(void) {
-	IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK,intMask);
+	IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, IntRegMaskReadLong(IoAccessCurrentAddress));
 }
 
 void IntRegMaskWrite(void) {
-	intMask = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
-        Log_Printf(LOG_DEBUG,"Interrupt mask: %08x", intMask);
+	IntRegMaskWriteLong(IoAccessCurrentAddress, IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK));
 }
 
 
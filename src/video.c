@@ -22,6 +22,7 @@ const char Video_fileid[] = "Previous video.c : " __DATE__ " " __TIME__;
 #include "sysReg.h"
 #include "tmc.h"
 #include "nd_sdl.h"
+#include "bench.h"
 
 /*--------------------------------------------------------------*/
 /* Local functions prototypes                                   */
@@ -72,6 +73,7 @@ void Video_InterruptHandler_VBL ( void ) {
     if(statusBarToggle) Update_StatusBar();
     statusBarToggle = !statusBarToggle;
     Video_InterruptHandler();
+    Bench_VBL();
     CycInt_AddRelativeInterruptUs((1000*1000)/NEXT_VBL_FREQ, 0, INTERRUPT_VIDEO_VBL);
 }
 